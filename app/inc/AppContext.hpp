@@ -1,5 +1,6 @@
 #pragma once
 
+#include "PackedSensorRecord.hpp"
 #include "Types.hpp"
 
 #include <FreeRTOS.h>
@@ -7,7 +8,6 @@
 #include <queue.h>
 #include <semphr.h>
 
-#include <array>
 #include <cstdint>
 
 enum class WifiCommand : uint8_t
@@ -43,13 +43,14 @@ struct AppMessage
     ACTIVITY_LOG
   } type = Type::SENSOR_DATA;
 
-  SensorData sensorData;
-  bool       isWatering  = false;
-  bool       forceUpdate = false;
-
-  std::array<char, 64> activityText{};
+  bool               forceUpdate = false;
+  uint32_t           timestamp   = 0;
+  PackedSensorRecord sensor;
+  const char*        activity    = nullptr;
 };
 
+static_assert(sizeof(AppMessage) <= 32, "Queue messages must stay small");
+
 struct AppContext
 {
   QueueHandle_t     wifiCommandQueue = nullptr;
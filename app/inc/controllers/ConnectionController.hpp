@@ -2,6 +2,8 @@
 
 #include "SensorController.hpp"
 
+#include "HttpServer.hpp"
+#include "SensorStream.hpp"
 #include "Types.hpp"
 #include "WifiDriver.hpp"
 
@@ -10,7 +12,7 @@
 class ConnectionController final
 {
 public:
-  ConnectionController()  = default;
+  explicit ConnectionController(SensorController& sensorController);
   ~ConnectionController() = default;
 
   ConnectionController(const ConnectionController&)                    = delete;
@@ -21,8 +23,7 @@ class ConnectionController final
   auto init() -> bool;
 
   auto connectSta(const WifiCredentials& creds) -> bool;
-  auto startApAndServe(uint32_t timeoutMs, SensorController& sensorController,
-                       const volatile bool* cancelFlag = nullptr) -> bool;
+  auto startApAndServe(uint32_t timeoutMs, const volatile bool* cancelFlag = nullptr) -> bool;
 
   auto isConnected() const -> bool;
 
@@ -31,9 +32,15 @@ class ConnectionController final
 private:
   static auto flashStorageOffset() -> uint32_t;
 
+  auto startServer(HttpServer::Handler handler) -> bool;
+  void stopServer();
+
   bool initialized_  = false;
   bool connected_    = false;
   bool provisioning_ = false;
 
-  WifiDriver wifiDriver_;
+  SensorController& sensorController_;
+  WifiDriver        wifiDriver_;
+  HttpServer        httpServer_;
+  SensorStream      sensorStream_;
 };
@@ -48,7 +48,7 @@ class IrrigationController final
   SensorData        lastSensorData_;
 
   auto        canStartWatering() const -> bool;
-  auto        shouldStartWatering() const -> bool;
+  auto        shouldStartWatering(const SensorData& data) const -> bool;
   static void activateWaterPump(bool enable);
 
   void        handleHumidityBasedMode(const SensorData& data);
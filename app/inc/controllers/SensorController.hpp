@@ -1,21 +1,36 @@
 #pragma once
 
 #include "EnvironmentalSensor.hpp"
+#include "I2cBus.hpp"
 #include "LightSensor.hpp"
 #include "SoilMoistureSensor.hpp"
 #include "Types.hpp"
 #include "WaterLevelSensor.hpp"
 
 #include <FreeRTOS.h>
-#include <hardware/i2c.h>
+#include <event_groups.h>
 #include <semphr.h>
+#include <task.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
 class SensorController final
 {
 public:
+  struct Acquisition
+  {
+    uint32_t startedAtMs       = 0;
+    uint32_t readyAtMs         = 0;
+    bool     environment       = false;
+    bool     light             = false;
+    bool     soil              = false;
+    bool     waterInBackground = false;
+    bool     active            = false;
+  };
+
   SensorController()  = default;
   ~SensorController() = default;
 
@@ -26,21 +41,62 @@ class SensorController final
 
   auto init() -> bool;
 
-  auto readAllSensors() const -> SensorData;
+  auto readAllSensors(uint32_t maxAgeMs = 0) const -> SensorData;
+
+  auto startAcquisition() const -> Acquisition;
+  auto collectAcquisition(const Acquisition& acquisition) const -> SensorData;
 
-  auto readBME280() const -> EnvironmentData;
-  auto readLightLevel() const -> LightLevelData;
-  auto readSoilMoisture() const -> SoilMoistureData;
-  auto readWaterLevel() const -> WaterLevelData;
+  auto readBME280(uint32_t maxAgeMs = 0) const -> EnvironmentData;
+  auto readLightLevel(uint32_t maxAgeMs = 0) const -> LightLevelData;
+  auto readSoilMoisture(uint32_t maxAgeMs = 0) const -> SoilMoistureData;
+  auto readWaterLevel(uint32_t maxAgeMs = 0) const -> WaterLevelData;
 
   void calibrateSoilMoisture(uint16_t dryValue, uint16_t wetValue);
 
   auto isInitialized() const -> bool;
 
 private:
-  bool                      initialized_ = false;
-  mutable SemaphoreHandle_t sensorMutex_ = nullptr;
+  enum class CachedSensor : uint8_t
+  {
+    ENVIRONMENT,
+    LIGHT,
+    SOIL,
+    WATER,
+    COUNT,
+  };
+
+  static constexpr EventBits_t WATER_READY_BIT = 1U << 0U;
+
+  static void waterWorkerTask(void* params);
+
+  auto createWorkers() -> bool;
+  auto canReadInParallel() const -> bool;
+
+  auto measureBME280() const -> EnvironmentData;
+  auto measureLightLevel() const -> LightLevelData;
+  auto measureSoilMoisture() const -> SoilMoistureData;
+  auto measureWaterLevel() const -> WaterLevelData;
+
+  template <typename T, typename Measure>
+  auto readCached(T SensorData::* field, CachedSensor sensor, uint32_t maxAgeMs, Measure measure) const -> T;
+  auto isCacheFresh(CachedSensor sensor, uint32_t now, uint32_t maxAgeMs) const -> bool;
+  void storeCache(const SensorData& data) const;
+
+  bool                      initialized_       = false;
+  mutable SemaphoreHandle_t sharedBusMutex_    = nullptr;
+  mutable SemaphoreHandle_t waterBusMutex_     = nullptr;
+  mutable SemaphoreHandle_t soilAdcMutex_      = nullptr;
+  mutable SemaphoreHandle_t acquisitionMutex_  = nullptr;
+  mutable SemaphoreHandle_t cacheMutex_        = nullptr;
+  EventGroupHandle_t        acquisitionEvents_ = nullptr;
+  TaskHandle_t              waterWorker_       = nullptr;
+  mutable WaterLevelData    pendingWater_;
+  mutable SensorData        cache_;
+
+  mutable std::array<uint32_t, static_cast<size_t>(CachedSensor::COUNT)> cachedAt_ = {};
 
+  std::unique_ptr<I2cBus>              sharedBus_;
+  std::unique_ptr<I2cBus>              waterBus_;
   std::unique_ptr<EnvironmentalSensor> environmentalSensor_;
   std::unique_ptr<LightSensor>         lightSensor_;
   std::unique_ptr<WaterLevelSensor>    waterSensor_;
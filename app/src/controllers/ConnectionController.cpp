@@ -3,10 +3,16 @@
 
 #include "Common.hpp"
 #include "Config.hpp"
-#include "FlashManager.hpp"
+#include "ConfigService.hpp"
+#include "HistoryExporter.hpp"
+#include "JsonReader.hpp"
+#include "JsonWriter.hpp"
+#include "MetricsExporter.hpp"
+#include "SensorPayloadCache.hpp"
+#include "SensorStream.hpp"
 #include "Types.hpp"
 #include "WifiDriver.hpp"
-#include "web/provision_page.html"
+#include "web/provision_page.hpp"
 
 #include <FreeRTOS.h>
 #include <boards/pico2_w.h>
@@ -14,29 +20,29 @@
 #include <hardware/regs/addressmap.h>
 #include <hardware/sync.h>
 #include <hardware/watchdog.h>
-#include <lwip/def.h>
 #include <lwip/inet.h>
 #include <lwip/ip4_addr.h>
 #include <lwip/netif.h>
-#include <lwip/sockets.h>
 #include <pico/time.h>
 #include <projdefs.h>
-#include <sys/_timeval.h>
-#include <sys/select.h>
+#include <semphr.h>
 #include <task.h>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <cstring>
+#include <limits>
+#include <optional>
 #include <span>
-#include <string>
 #include <string_view>
-#include <type_traits>
+#include <system_error>
+#include <utility>
 
 namespace
 {
@@ -74,249 +80,284 @@ void percentDecode(const std::span<char> str)
   }
 }
 
-auto sendAll(const int32_t client, const std::span<const char> data) -> bool
+auto configToJson(const SystemConfig& cfg, const std::span<char> buffer) -> std::string_view
 {
-  size_t sent = 0;
-  while (sent < data.size())
-  {
-    const auto remaining = data.subspan(sent);
-    const auto chunkSize = std::min(remaining.size(), static_cast<size_t>(1'024));
-    const auto rc        = lwip_send(client, remaining.data(), static_cast<int32_t>(chunkSize), 0);
-    if (rc < 0)
-    {
-      printf("[WiFi] send failed (%d) after %zu/%zu bytes\n", rc, sent, data.size());
-      return false;
-    }
-    sent += static_cast<size_t>(rc);
-  }
-  return true;
+  JsonWriter json(buffer);
+  json.beginObject()
+    .field("wifi_ssid", cfg.wifi.ssid.data())
+    .field("wifi_pass", cfg.wifi.pass.data())
+    .field("ap_ssid", cfg.ap.ssid.data())
+    .field("ap_pass", cfg.ap.pass.data())
+    .field("mqtt_host", cfg.mqtt.brokerHost.data())
+    .field("mqtt_port", cfg.mqtt.brokerPort)
+    .field("mqtt_client_id", cfg.mqtt.clientId.data())
+    .field("mqtt_user", cfg.mqtt.username.data())
+    .field("mqtt_pass", cfg.mqtt.password.data())
+    .field("mqtt_prefix", cfg.mqtt.discoveryPrefix.data())
+    .field("mqtt_topic", cfg.mqtt.baseTopic.data())
+    .field("mqtt_interval", cfg.mqtt.publishIntervalMs / 1000)
+    .field("sensor_interval", cfg.sensorReadIntervalMs / 1000)
+    .field("irrigation_mode", static_cast<int>(cfg.irrigationMode))
+    .endObject();
+  return json.view();
 }
 
-void sendResponse(const int32_t client, const std::string_view body, const char* const contentType = "text/html")
+void refreshSensorPayload(SensorController& sm)
 {
-  printf("[WiFi] Sending response (%zu bytes)...\n", body.size());
-  std::array<char, 256> header{};
-  const auto            len =
-    std::snprintf(header.data(), header.size(),
-                  "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
-                  contentType, body.size());
-
-  const auto headerOk = sendAll(client, std::span<const char>(header.data(), static_cast<size_t>(len)));
-  const auto bodyOk   = body.empty() ? true : sendAll(client, std::span<const char>(body.data(), body.size()));
-
-  if (headerOk and bodyOk)
+  auto&      cache    = SensorPayloadCache::getInstance();
+  const auto watering = cache.isWatering();
+  const auto stale    = [&]
   {
-    printf("[WiFi] Response sent\n");
-  }
-  else
+    const auto current = cache.acquire();
+    return current->empty() or (current->watering != watering) or
+           ((Utils::getTimeSinceBoot() - current->timestamp) > Config::SENSOR_CACHE_MAX_AGE_MS);
+  }();
+
+  if (stale)
   {
-    printf("[WiFi] Response incomplete\n");
+    cache.update(sm.readAllSensors(Config::SENSOR_CACHE_MAX_AGE_MS), watering);
   }
 }
 
-auto configToJson(const SystemConfig& cfg) -> std::string
-{
-  std::array<char, 2048> buf{};
-  (void)std::snprintf(buf.data(), buf.size(),
-                      "{"
-                      "\"wifi_ssid\":\"%s\","
-                      "\"wifi_pass\":\"%s\","
-                      "\"ap_ssid\":\"%s\","
-                      "\"ap_pass\":\"%s\","
-                      "\"mqtt_host\":\"%s\","
-                      "\"mqtt_port\":%d,"
-                      "\"mqtt_client_id\":\"%s\","
-                      "\"mqtt_user\":\"%s\","
-                      "\"mqtt_pass\":\"%s\","
-                      "\"mqtt_prefix\":\"%s\","
-                      "\"mqtt_topic\":\"%s\","
-                      "\"mqtt_interval\":%u,"
-                      "\"sensor_interval\":%u,"
-                      "\"irrigation_mode\":%d"
-                      "}",
-                      cfg.wifi.ssid.data(), cfg.wifi.pass.data(), cfg.ap.ssid.data(), cfg.ap.pass.data(),
-                      cfg.mqtt.brokerHost.data(), cfg.mqtt.brokerPort, cfg.mqtt.clientId.data(),
-                      cfg.mqtt.username.data(), cfg.mqtt.password.data(), cfg.mqtt.discoveryPrefix.data(),
-                      cfg.mqtt.baseTopic.data(), cfg.mqtt.publishIntervalMs / 1000, cfg.sensorReadIntervalMs / 1000,
-                      static_cast<int>(cfg.irrigationMode));
-  return {buf.data()};
-}
+using ConfigFieldApply = bool (*)(SystemConfig&, const JsonMember&);
 
-auto sensorsToJson(SensorController& sm) -> std::string
+struct ConfigFieldBinding
 {
-  const auto data = sm.readAllSensors();
-
-  std::array<char, 512> buf{};
-  (void)std::snprintf(buf.data(), buf.size(),
-                      "{"
-                      "\"Temperature\":\"%.1f C\","
-                      "\"Humidity\":\"%.1f %% \","
-                      "\"Pressure\":\"%.1f hPa\","
-                      "\"Soil Moisture\":\"%.1f %%\","
-                      "\"Water Level\":\"%.1f %%\","
-                      "\"Light\":\"%.1f lux\""
-                      "}",
-                      static_cast<double>(data.environment.temperature), static_cast<double>(data.environment.humidity),
-                      static_cast<double>(data.environment.pressure), static_cast<double>(data.soil.percentage),
-                      static_cast<double>(data.water.percentage), static_cast<double>(data.light.lux));
-  return {buf.data()};
-}
+  std::string_view key;
+  ConfigFieldApply apply;
+};
 
-auto getJsonValue(const std::string_view json, const std::string_view key) -> std::string
+template <size_t N>
+auto applyString(std::array<char, N>& dest, const JsonMember& member) -> bool
 {
-  const auto keyStr = "\"" + std::string(key) + "\"";
-  const auto keyPos = json.find(keyStr);
-  if (keyPos == std::string::npos)
+  if (member.type != JsonType::STRING) [[unlikely]]
   {
-    return "";
+    return false;
   }
-  const auto colonPos = json.find(':', keyPos);
-  if (colonPos == std::string::npos)
+  if (member.text.empty())
   {
-    return "";
+    return true;
   }
-  const auto valueStart = json.find_first_not_of(" \t\n\r", colonPos + 1);
-  if (valueStart == std::string::npos)
+  if (member.text.size() >= N) [[unlikely]]
   {
-    return "";
+    return false;
   }
+  dest.fill('\0');
+  member.text.copy(dest.data(), member.text.size());
+  return true;
+}
 
-  if (json[valueStart] == '"')
+template <typename T>
+auto applyUnsigned(T& dest, const JsonMember& member, const uint32_t minValue, const uint32_t maxValue,
+                   const uint32_t scale = 1) -> bool
+{
+  if ((member.type == JsonType::STRING) and member.text.empty())
   {
-    const auto valueEnd = json.find('"', valueStart + 1);
-    return std::string(json.substr(valueStart + 1, valueEnd - valueStart - 1));
+    return true;
+  }
+  if ((member.type != JsonType::NUMBER) and (member.type != JsonType::STRING)) [[unlikely]]
+  {
+    return false;
   }
 
-  const auto valueEnd = json.find_first_of(",}", valueStart);
-  return std::string(json.substr(valueStart, valueEnd - valueStart));
+  uint32_t    value = 0;
+  const auto* last  = member.text.data() + member.text.size();
+  const auto [ptr, ec] = std::from_chars(member.text.data(), last, value);
+  if ((ec != std::errc{}) or (ptr != last) or (value < minValue) or (value > maxValue)) [[unlikely]]
+  {
+    return false;
+  }
+  dest = static_cast<T>(value * scale);
+  return true;
 }
 
-void updateConfigFromJson(SystemConfig& cfg, const std::string_view json)
+inline constexpr uint32_t MAX_INTERVAL_S = std::numeric_limits<uint32_t>::max() / 1'000;
+
+inline constexpr std::array<ConfigFieldBinding, 14> CONFIG_FIELDS = {
+  {
+   {"wifi_ssid", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.wifi.ssid, m); }},
+   {"wifi_pass", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.wifi.pass, m); }},
+   {"ap_ssid", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.ap.ssid, m); }},
+   {"ap_pass", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.ap.pass, m); }},
+   {"mqtt_host", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.mqtt.brokerHost, m); }},
+   {"mqtt_port",
+     [](SystemConfig& cfg, const JsonMember& m)
+     { return applyUnsigned(cfg.mqtt.brokerPort, m, 1, std::numeric_limits<uint16_t>::max()); }},
+   {"mqtt_client_id", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.mqtt.clientId, m); }},
+   {"mqtt_user", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.mqtt.username, m); }},
+   {"mqtt_pass", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.mqtt.password, m); }},
+   {"mqtt_prefix", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.mqtt.discoveryPrefix, m); }},
+   {"mqtt_topic", [](SystemConfig& cfg, const JsonMember& m) { return applyString(cfg.mqtt.baseTopic, m); }},
+   {"mqtt_interval",
+     [](SystemConfig& cfg, const JsonMember& m)
+     { return applyUnsigned(cfg.mqtt.publishIntervalMs, m, 1, MAX_INTERVAL_S, 1'000); }},
+   {"sensor_interval",
+     [](SystemConfig& cfg, const JsonMember& m)
+     { return applyUnsigned(cfg.sensorReadIntervalMs, m, 1, MAX_INTERVAL_S, 1'000); }},
+   {"irrigation_mode",
+     [](SystemConfig& cfg, const JsonMember& m)
+     { return applyUnsigned(cfg.irrigationMode, m, 0, static_cast<uint32_t>(IrrigationMode::EVAPOTRANSPIRATION)); }},
+   }
+};
+
+constexpr auto hasUniqueKeys() -> bool
 {
-  const auto copyStr = [&](auto& dest, const std::string_view key) -> auto
+  for (size_t i = 0; i < CONFIG_FIELDS.size(); ++i)
   {
-    const auto val = getJsonValue(json, key);
-    if (not val.empty())
+    for (size_t j = i + 1; j < CONFIG_FIELDS.size(); ++j)
     {
-      std::strncpy(dest.data(), val.c_str(), dest.size() - 1);
+      if (CONFIG_FIELDS.at(i).key == CONFIG_FIELDS.at(j).key)
+      {
+        return false;
+      }
     }
-  };
+  }
+  return true;
+}
+
+static_assert(hasUniqueKeys());
 
-  const auto copyInt = [&](auto& dest, const std::string_view key) -> auto
+auto parseConfigJson(const SystemConfig& current, const std::string_view json) -> std::optional<SystemConfig>
+{
+  auto             updated = current;
+  JsonObjectReader reader(json);
+  JsonMember       member;
+  while (reader.next(member))
   {
-    const auto val = getJsonValue(json, key);
-    if (not val.empty())
+    const auto field = std::ranges::find(CONFIG_FIELDS, member.key, &ConfigFieldBinding::key);
+    if (field == CONFIG_FIELDS.end())
     {
-      dest = static_cast<std::remove_reference_t<decltype(dest)>>(std::strtoul(val.c_str(), nullptr, 10));
+      continue;
     }
-  };
+    if (not field->apply(updated, member)) [[unlikely]]
+    {
+      printf("[WiFi] Invalid value for config field '%.*s'\n", static_cast<int>(member.key.size()),
+             member.key.data());
+      return std::nullopt;
+    }
+  }
 
-  copyStr(cfg.wifi.ssid, "wifi_ssid");
-  copyStr(cfg.wifi.pass, "wifi_pass");
-  cfg.wifi.valid = cfg.wifi.ssid[0] != '\0';
+  if (reader.error() != JsonError::NONE) [[unlikely]]
+  {
+    printf("[WiFi] Config JSON rejected: %s at offset %zu\n", JsonObjectReader::errorString(reader.error()),
+           reader.errorOffset());
+    return std::nullopt;
+  }
 
-  copyStr(cfg.ap.ssid, "ap_ssid");
-  copyStr(cfg.ap.pass, "ap_pass");
+  updated.wifi.valid = updated.wifi.ssid[0] != '\0';
+  return updated;
+}
 
-  copyStr(cfg.mqtt.brokerHost, "mqtt_host");
-  copyInt(cfg.mqtt.brokerPort, "mqtt_port");
-  copyStr(cfg.mqtt.clientId, "mqtt_client_id");
-  copyStr(cfg.mqtt.username, "mqtt_user");
-  copyStr(cfg.mqtt.password, "mqtt_pass");
-  copyStr(cfg.mqtt.discoveryPrefix, "mqtt_prefix");
-  copyStr(cfg.mqtt.baseTopic, "mqtt_topic");
-  copyInt(cfg.mqtt.publishIntervalMs, "mqtt_interval");
-  cfg.mqtt.publishIntervalMs *= 1000;
+struct ProvisioningSession
+{
+  SemaphoreHandle_t configMutex = nullptr;
+  std::atomic<bool> configSaved = false;
+};
 
-  copyInt(cfg.sensorReadIntervalMs, "sensor_interval");
-  cfg.sensorReadIntervalMs *= 1000;
+void streamSensors(HttpResponse& response, SensorController& sensorController, SensorStream& stream)
+{
+  if (not stream.hasCapacity()) [[unlikely]]
+  {
+    response.send("Too Many Viewers", "text/plain", "503 Service Unavailable");
+    return;
+  }
 
-  const auto modeStr = getJsonValue(json, "irrigation_mode");
-  if (not modeStr.empty())
+  refreshSensorPayload(sensorController);
+  response.addHeader("Cache-Control", "no-cache");
+  if (response.beginStream("text/event-stream"))
   {
-    cfg.irrigationMode = static_cast<IrrigationMode>(std::stoi(modeStr));
+    (void)stream.attach(response.detach());
   }
 }
 
-auto handleClientRequest(const int32_t client, SystemConfig& config, bool& rebootRequested,
-                         SensorController& sm) -> bool
+void handleConfigRequest(const HttpRequest& request, HttpResponse& response, ProvisioningSession& session)
 {
-  std::array<char, 2048> buf{};
-  const auto             len = lwip_recv(client, buf.data(), buf.size() - 1, 0);
-  if (len <= 0)
+  if (request.method == "GET")
   {
-    printf("[WiFi] recv failed or closed: %d\n", (int)len);
-    return false;
+    std::array<char, 1'024> json{};
+    const auto              body = configToJson(*ConfigService::getInstance().acquire(), json);
+    response.send(body, "application/json");
+    return;
   }
-  buf.at(static_cast<size_t>(len)) = '\0';
-  printf("[WiFi] Received %d bytes\n", (int)len);
 
-  const auto request      = std::string_view(buf.data(), static_cast<size_t>(len));
-  const auto firstLineEnd = request.find("\r\n");
-  if (firstLineEnd == std::string_view::npos)
+  if (request.method != "POST")
   {
-    return false;
+    return;
   }
 
-  const auto firstLine = request.substr(0, firstLineEnd);
-  const auto methodEnd = firstLine.find(' ');
-  const auto pathEnd =
-    (methodEnd != std::string_view::npos) ? firstLine.find(' ', methodEnd + 1) : std::string_view::npos;
-  if ((methodEnd == std::string_view::npos) or (pathEnd == std::string_view::npos))
+  auto& configService = ConfigService::getInstance();
+  xSemaphoreTake(session.configMutex, portMAX_DELAY);
+  const auto updated = parseConfigJson(configService.snapshot(), request.body);
+  const auto saved   = updated.has_value() and configService.update(*updated);
+  xSemaphoreGive(session.configMutex);
+
+  if (not updated.has_value()) [[unlikely]]
   {
-    return false;
+    response.send(R"({"status":"error","message":"invalid configuration"})", "application/json", "400 Bad Request");
+    return;
   }
+  if (not saved) [[unlikely]]
+  {
+    response.send(R"({"status":"error","message":"failed to save configuration"})", "application/json",
+                  "500 Internal Server Error");
+    return;
+  }
+  response.closeAfterResponse();
+  response.send(R"({"status":"ok"})", "application/json");
+  session.configSaved = true;
+}
 
-  const auto method = firstLine.substr(0, methodEnd);
-  const auto path   = firstLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
-
-  printf("[WiFi] Method: %.*s, Path: %.*s\n", (int)method.length(), method.data(), (int)path.length(), path.data());
+void handleRequest(const HttpRequest& request, HttpResponse& response, SensorController& sensorController,
+                   SensorStream& stream, ProvisioningSession* const session)
+{
+  printf("[WiFi] Method: %.*s, Path: %.*s\n", static_cast<int>(request.method.length()), request.method.data(),
+         static_cast<int>(request.path.length()), request.path.data());
 
-  if (method == "GET")
+  if (request.method == "GET")
   {
-    if (path == "/")
+    if (request.path == "/")
     {
-      sendResponse(client, PROVISION_PAGE_HTML);
+      response.addHeader("ETag", PROVISION_PAGE_ETAG);
+      response.addHeader("Cache-Control", "no-cache");
+      if (request.header("If-None-Match").find(PROVISION_PAGE_ETAG) != std::string_view::npos)
+      {
+        response.sendNotModified();
+        return;
+      }
+      response.addHeader("Content-Encoding", "gzip");
+      response.sendStatic(PROVISION_PAGE_GZIP, "text/html; charset=utf-8");
     }
-    else if (path == "/api/config")
+    else if (request.path == "/api/sensors")
     {
-      sendResponse(client, configToJson(config), "application/json");
+      refreshSensorPayload(sensorController);
+      std::array<char, sizeof(SensorPayload::json)> json{};
+      response.send(SensorPayloadCache::getInstance().copy(json), "application/json");
     }
-    else if (path == "/api/sensors")
+    else if (request.path == "/api/stream")
     {
-      sendResponse(client, sensorsToJson(sm), "application/json");
+      streamSensors(response, sensorController, stream);
     }
-    else
+    else if (request.path == "/metrics")
     {
-      sendResponse(client, "Not Found", "text/plain");
+      (void)MetricsExporter::serve(response);
     }
-  }
-  else if (method == "POST")
-  {
-    if (path == "/api/config")
+    else if (request.path == "/api/history")
     {
-      const auto bodyPos = request.find("\r\n\r\n");
-      if (bodyPos != std::string_view::npos)
-      {
-        const auto body = request.substr(bodyPos + 4);
-        updateConfigFromJson(config, body);
-        FlashManager::saveConfig(config);
-        sendResponse(client, R"({"status":"ok"})", "application/json");
-        rebootRequested = true;
-      }
+      (void)HistoryExporter::serve(request.query, response);
     }
   }
 
-  return true;
+  if ((request.path == "/api/config") and (session != nullptr))
+  {
+    handleConfigRequest(request, response, *session);
+  }
 }
 
-auto runProvisioningLoop(int server, SystemConfig& config, uint32_t timeoutMs, const volatile bool* cancelFlag,
-                         SensorController& sensorController) -> bool
+auto runProvisioningLoop(ProvisioningSession& session, const uint32_t timeoutMs,
+                         const volatile bool* const cancelFlag) -> bool
 {
-  const auto startMs         = Utils::getTimeSinceBoot();
-  bool       rebootRequested = false;
-
-  while (true)
+  const auto startMs = Utils::getTimeSinceBoot();
+  while (not session.configSaved)
   {
     const auto now = Utils::getTimeSinceBoot();
     if ((timeoutMs > 0U) and (now - startMs >= timeoutMs)) [[unlikely]]
@@ -329,57 +370,22 @@ auto runProvisioningLoop(int server, SystemConfig& config, uint32_t timeoutMs, c
       printf("[WiFi] AP provisioning cancelled\n");
       break;
     }
+    Utils::delayMs(100);
+  }
 
-    fd_set readSet;
-    FD_ZERO(&readSet);
-    FD_SET(server, &readSet);
-    timeval tv{};
-    tv.tv_sec  = 0;
-    tv.tv_usec = 100'000;
-
-    const auto sel = lwip_select(server + 1, &readSet, nullptr, nullptr, &tv);
-    if (sel <= 0)
-    {
-      vTaskDelay(pdMS_TO_TICKS(10));
-      continue;
-    }
-
-    if (not FD_ISSET(server, &readSet))
-    {
-      continue;
-    }
-
-    const auto client = lwip_accept(server, nullptr, nullptr);
-    if (client < 0)
-    {
-      printf("[WiFi] Accept failed: %d\n", client);
-      continue;
-    }
-    printf("[WiFi] Client connected (sock=%d)\n", client);
-
-    const auto timeout = timeval{
-      .tv_sec  = 3,
-      .tv_usec = 0,
-    };
-    lwip_setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-    lwip_setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-
-    handleClientRequest(client, config, rebootRequested, sensorController);
-
-    if (rebootRequested)
-    {
-      vTaskDelay(pdMS_TO_TICKS(500));
-      lwip_close(client);
-      break;
-    }
-    vTaskDelay(pdMS_TO_TICKS(100));
-    lwip_close(client);
+  if (session.configSaved)
+  {
+    Utils::delayMs(500);
   }
-  return rebootRequested;
+  return session.configSaved;
 }
 
 }  // namespace
 
+ConnectionController::ConnectionController(SensorController& sensorController) : sensorController_(sensorController)
+{
+}
+
 auto ConnectionController::init() -> bool
 {
   if (initialized_)
@@ -419,11 +425,15 @@ auto ConnectionController::connectSta(const WifiCredentials& creds) -> bool
   }
 
   connected_ = true;
+  if (not httpServer_.isRunning())
+  {
+    (void)startServer([this](const HttpRequest& request, HttpResponse& response)
+                      { handleRequest(request, response, sensorController_, sensorStream_, nullptr); });
+  }
   return true;
 }
 
-auto ConnectionController::startApAndServe(const uint32_t timeoutMs, SensorController& sensorController,
-                                           const volatile bool* const cancelFlag) -> bool
+auto ConnectionController::startApAndServe(const uint32_t timeoutMs, const volatile bool* const cancelFlag) -> bool
 {
   if (not init())
   {
@@ -434,27 +444,7 @@ auto ConnectionController::startApAndServe(const uint32_t timeoutMs, SensorContr
   provisioning_ = true;
   connected_    = false;
 
-  auto config = SystemConfig{};
-  if (not FlashManager::loadConfig(config))
-  {
-    config                      = {};
-    config.sensorReadIntervalMs = Config::DEFAULT_SENSOR_READ_INTERVAL_MS;
-    config.irrigationMode       = Config::DEFAULT_IRRIGATION_MODE;
-    std::strncpy(config.ap.ssid.data(), Config::AP::DEFAULT_SSID, config.ap.ssid.size() - 1);
-    std::strncpy(config.ap.pass.data(), Config::AP::DEFAULT_PASS, config.ap.pass.size() - 1);
-    std::strncpy(config.wifi.ssid.data(), Config::WiFi::DEFAULT_SSID, config.wifi.ssid.size() - 1);
-    std::strncpy(config.wifi.pass.data(), Config::WiFi::DEFAULT_PASS, config.wifi.pass.size() - 1);
-    config.mqtt.brokerPort        = Config::MQTT::DEFAULT_BROKER_PORT;
-    config.mqtt.publishIntervalMs = Config::MQTT::DEFAULT_PUBLISH_INTERVAL_MS;
-    std::strncpy(config.mqtt.brokerHost.data(), Config::MQTT::DEFAULT_BROKER_HOST, config.mqtt.brokerHost.size() - 1);
-    std::strncpy(config.mqtt.clientId.data(), Config::MQTT::DEFAULT_CLIENT_ID, config.mqtt.clientId.size() - 1);
-    std::strncpy(config.mqtt.username.data(), Config::MQTT::DEFAULT_USERNAME, config.mqtt.username.size() - 1);
-    std::strncpy(config.mqtt.password.data(), Config::MQTT::DEFAULT_PASSWORD, config.mqtt.password.size() - 1);
-    std::strncpy(config.mqtt.discoveryPrefix.data(), Config::MQTT::DEFAULT_DISCOVERY_PREFIX,
-                 config.mqtt.discoveryPrefix.size() - 1);
-    std::strncpy(config.mqtt.baseTopic.data(), Config::MQTT::DEFAULT_BASE_TOPIC, config.mqtt.baseTopic.size() - 1);
-  }
-
+  const auto  config = ConfigService::getInstance().snapshot();
   const auto* apSsid = (config.ap.ssid[0] != '\0') ? config.ap.ssid.data() : Config::AP::DEFAULT_SSID;
   const auto* apPass = (config.ap.pass[0] != '\0') ? config.ap.pass.data() : Config::AP::DEFAULT_PASS;
 
@@ -464,29 +454,56 @@ auto ConnectionController::startApAndServe(const uint32_t timeoutMs, SensorContr
     return false;
   }
 
-  const auto server = lwip_socket(AF_INET, SOCK_STREAM, 0);
-  if (server < 0)
+  ProvisioningSession session{
+    .configMutex = xSemaphoreCreateMutex(),
+  };
+  if (session.configMutex == nullptr) [[unlikely]]
   {
-    printf("[WiFi] Socket create failed\n");
+    printf("[WiFi] Failed to create provisioning mutex\n");
+    WifiDriver::stopAp();
     provisioning_ = false;
     return false;
   }
 
-  sockaddr_in addr{};
-  addr.sin_family      = AF_INET;
-  addr.sin_port        = htons(80);
-  addr.sin_addr.s_addr = PP_HTONL(INADDR_ANY);
-
-  lwip_bind(server, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
-  lwip_listen(server, 2);
+  if (not startServer([this, &session](const HttpRequest& request, HttpResponse& response)
+                      { handleRequest(request, response, sensorController_, sensorStream_, &session); })) [[unlikely]]
+  {
+    vSemaphoreDelete(session.configMutex);
+    WifiDriver::stopAp();
+    provisioning_ = false;
+    return false;
+  }
 
-  const auto rebootRequested = runProvisioningLoop(server, config, timeoutMs, cancelFlag, sensorController);
+  const auto configSaved = runProvisioningLoop(session, timeoutMs, cancelFlag);
 
-  lwip_close(server);
+  stopServer();
+  vSemaphoreDelete(session.configMutex);
   WifiDriver::stopAp();
   provisioning_ = false;
 
-  return rebootRequested;
+  return configSaved;
+}
+
+auto ConnectionController::startServer(HttpServer::Handler handler) -> bool
+{
+  stopServer();
+
+  if (not sensorStream_.start()) [[unlikely]]
+  {
+    printf("[WiFi] Live sensor stream unavailable\n");
+  }
+  if (not httpServer_.start(Config::Http::PORT, std::move(handler))) [[unlikely]]
+  {
+    sensorStream_.stop();
+    return false;
+  }
+  return true;
+}
+
+void ConnectionController::stopServer()
+{
+  httpServer_.stop();
+  sensorStream_.stop();
 }
 
 auto ConnectionController::isConnected() const -> bool
@@ -167,20 +167,20 @@ void IrrigationController::activateWaterPump(const bool enable)
   gpio_put(Config::PUMP_CONTROL_PIN, enable);
 }
 
-auto IrrigationController::shouldStartWatering() const -> bool
+auto IrrigationController::shouldStartWatering(const SensorData& data) const -> bool
 {
   if (not sensorController_.isInitialized())
   {
     return false;
   }
 
-  const auto soilData = sensorController_.readSoilMoisture();
+  const auto& soilData = data.soil;
   if (not soilData.valid) [[unlikely]]
   {
     return false;
   }
 
-  const auto waterLevel = sensorController_.readWaterLevel();
+  const auto& waterLevel = data.water;
   if (not waterLevel.isValid()) [[unlikely]]
   {
     return false;
@@ -218,7 +218,7 @@ void IrrigationController::handleHumidityBasedMode(const SensorData& sensorData)
     return;
   }
 
-  if (shouldStartWatering() and canStartWatering())
+  if (shouldStartWatering(sensorData) and canStartWatering())
   {
     startWatering();
   }
@@ -3,21 +3,26 @@
 #include "Common.hpp"
 #include "Config.hpp"
 #include "EnvironmentalSensor.hpp"
+#include "I2cBus.hpp"
 #include "LightSensor.hpp"
+#include "RuntimeMetrics.hpp"
 #include "SoilMoistureSensor.hpp"
+#include "TaskConfig.hpp"
 #include "Types.hpp"
 #include "WaterLevelSensor.hpp"
 
 #include <FreeRTOS.h>
+#include <event_groups.h>
 #include <hardware/adc.h>
 #include <hardware/gpio.h>
 #include <hardware/i2c.h>
 #include <hardware/structs/io_bank0.h>
-#include <pico/time.h>
 #include <portmacrocommon.h>
 #include <projdefs.h>
 #include <semphr.h>
+#include <task.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
@@ -25,6 +30,9 @@
 namespace
 {
 
+static_assert(Config::BME280_I2C_INSTANCE != Config::WATER_LEVEL_I2C_INSTANCE,
+              "Shared and water level sensors must use separate I2C controllers");
+
 auto resolveI2CInstance(const uint8_t instance) -> i2c_inst_t*
 {
   switch (instance)
@@ -38,6 +46,15 @@ auto resolveI2CInstance(const uint8_t instance) -> i2c_inst_t*
   }
 }
 
+void waitUntil(const uint32_t deadlineMs)
+{
+  const auto remainingMs = static_cast<int32_t>(deadlineMs - Utils::getTimeSinceBoot());
+  if (remainingMs > 0)
+  {
+    Utils::delayMs(static_cast<uint32_t>(remainingMs));
+  }
+}
+
 }  // namespace
 
 auto SensorController::init() -> bool
@@ -49,10 +66,15 @@ auto SensorController::init() -> bool
 
   printf("[SensorController] Initializing...\n");
 
-  sensorMutex_ = xSemaphoreCreateRecursiveMutex();
-  if (sensorMutex_ == nullptr) [[unlikely]]
+  sharedBusMutex_   = xSemaphoreCreateMutex();
+  waterBusMutex_    = xSemaphoreCreateMutex();
+  soilAdcMutex_     = xSemaphoreCreateMutex();
+  acquisitionMutex_ = xSemaphoreCreateMutex();
+  cacheMutex_       = xSemaphoreCreateMutex();
+  if ((sharedBusMutex_ == nullptr) or (waterBusMutex_ == nullptr) or (soilAdcMutex_ == nullptr) or
+      (acquisitionMutex_ == nullptr) or (cacheMutex_ == nullptr)) [[unlikely]]
   {
-    printf("[SensorController] ERROR: Failed to create sensor mutex\n");
+    printf("[SensorController] ERROR: Failed to create sensor mutexes\n");
     return false;
   }
 
@@ -67,29 +89,27 @@ auto SensorController::init() -> bool
     return false;
   }
 
-  i2c_init(sharedI2C, Config::BME280_I2C_BAUDRATE);
-  gpio_set_function(Config::BME280_SDA_PIN, GPIO_FUNC_I2C);
-  gpio_set_function(Config::BME280_SCL_PIN, GPIO_FUNC_I2C);
-  gpio_pull_up(Config::BME280_SDA_PIN);
-  gpio_pull_up(Config::BME280_SCL_PIN);
-
-  i2c_init(waterI2C, Config::WATER_LEVEL_I2C_BAUDRATE);
-  gpio_set_function(Config::WATER_LEVEL_SDA_PIN, GPIO_FUNC_I2C);
-  gpio_set_function(Config::WATER_LEVEL_SCL_PIN, GPIO_FUNC_I2C);
-  gpio_pull_up(Config::WATER_LEVEL_SDA_PIN);
-  gpio_pull_up(Config::WATER_LEVEL_SCL_PIN);
+  sharedBus_ = std::make_unique<I2cBus>(sharedI2C);
+  waterBus_  = std::make_unique<I2cBus>(waterI2C);
+  if (not sharedBus_->init(Config::BME280_I2C_BAUDRATE, Config::BME280_SDA_PIN, Config::BME280_SCL_PIN) or
+      not waterBus_->init(Config::WATER_LEVEL_I2C_BAUDRATE, Config::WATER_LEVEL_SDA_PIN, Config::WATER_LEVEL_SCL_PIN))
+    [[unlikely]]
+  {
+    printf("[SensorController] ERROR: Failed to initialize I2C buses\n");
+    return false;
+  }
 
   gpio_init(Config::WATER_LEVEL_POWER_PIN);
   gpio_set_dir(Config::WATER_LEVEL_POWER_PIN, GPIO_OUT);
   gpio_put(Config::WATER_LEVEL_POWER_PIN, true);
 
-  environmentalSensor_ = std::make_unique<EnvironmentalSensor>(sharedI2C, Config::BME280_I2C_ADDRESS);
+  environmentalSensor_ = std::make_unique<EnvironmentalSensor>(sharedBus_.get(), Config::BME280_I2C_ADDRESS);
   if (not environmentalSensor_->init()) [[unlikely]]
   {
     printf("[SensorController] WARNING: BME280 not detected\n");
     environmentalSensor_.reset();
   }
-  lightSensor_ = std::make_unique<LightSensor>(sharedI2C, Config::LIGHT_SENSOR_I2C_ADDRESS);
+  lightSensor_ = std::make_unique<LightSensor>(sharedBus_.get(), Config::LIGHT_SENSOR_I2C_ADDRESS);
   if (not lightSensor_->init()) [[unlikely]]
   {
     printf("[SensorController] WARNING: BH1750 not detected\n");
@@ -105,41 +125,267 @@ auto SensorController::init() -> bool
   }
 
   waterSensor_ =
-    std::make_unique<WaterLevelSensor>(waterI2C, Config::WATER_LEVEL_LOW_ADDR, Config::WATER_LEVEL_HIGH_ADDR);
+    std::make_unique<WaterLevelSensor>(waterBus_.get(), Config::WATER_LEVEL_LOW_ADDR, Config::WATER_LEVEL_HIGH_ADDR);
   if (not waterSensor_->init()) [[unlikely]]
   {
     printf("[SensorController] WARNING: Water level sensor not detected\n");
     waterSensor_.reset();
   }
 
+  if (not createWorkers()) [[unlikely]]
+  {
+    printf("[SensorController] WARNING: Water level worker unavailable, reading inline\n");
+  }
+
   initialized_ = true;
   printf("[SensorController] Initialization complete\n");
   return true;
 }
 
-auto SensorController::readAllSensors() const -> SensorData
+auto SensorController::createWorkers() -> bool
+{
+  acquisitionEvents_ = xEventGroupCreate();
+  if (acquisitionEvents_ == nullptr) [[unlikely]]
+  {
+    return false;
+  }
+
+  if (xTaskCreate(waterWorkerTask, "waterWorker", SENSOR_WORKER_STACK, this, SENSOR_WORKER_PRIORITY, &waterWorker_) !=
+      pdPASS) [[unlikely]]
+  {
+    waterWorker_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+auto SensorController::canReadInParallel() const -> bool
+{
+  return (acquisitionEvents_ != nullptr) and (waterWorker_ != nullptr) and
+         (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+}
+
+void SensorController::waterWorkerTask(void* const params)
+{
+  auto& self = *static_cast<SensorController*>(params);
+  while (true)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    const auto startMs = Utils::getTimeSinceBoot();
+    self.pendingWater_ = self.measureWaterLevel();
+    RuntimeMetrics::getInstance().recordLatency(LatencyMetric::WATER, Utils::getTimeSinceBoot() - startMs);
+    xEventGroupSetBits(self.acquisitionEvents_, WATER_READY_BIT);
+  }
+}
+
+auto SensorController::readAllSensors(const uint32_t maxAgeMs) const -> SensorData
+{
+  if ((maxAgeMs > 0) and (xSemaphoreTake(cacheMutex_, portMAX_DELAY) == pdPASS))
+  {
+    const auto now   = Utils::getTimeSinceBoot();
+    auto       fresh = true;
+    for (size_t i = 0; i < cachedAt_.size(); ++i)
+    {
+      fresh = fresh and isCacheFresh(static_cast<CachedSensor>(i), now, maxAgeMs);
+    }
+    const auto snapshot = cache_;
+    xSemaphoreGive(cacheMutex_);
+    if (fresh)
+    {
+      return snapshot;
+    }
+  }
+  return collectAcquisition(startAcquisition());
+}
+
+auto SensorController::readBME280(const uint32_t maxAgeMs) const -> EnvironmentData
+{
+  return readCached(&SensorData::environment, CachedSensor::ENVIRONMENT, maxAgeMs, [this] { return measureBME280(); });
+}
+
+auto SensorController::readLightLevel(const uint32_t maxAgeMs) const -> LightLevelData
+{
+  return readCached(&SensorData::light, CachedSensor::LIGHT, maxAgeMs, [this] { return measureLightLevel(); });
+}
+
+auto SensorController::readSoilMoisture(const uint32_t maxAgeMs) const -> SoilMoistureData
+{
+  return readCached(&SensorData::soil, CachedSensor::SOIL, maxAgeMs, [this] { return measureSoilMoisture(); });
+}
+
+auto SensorController::readWaterLevel(const uint32_t maxAgeMs) const -> WaterLevelData
+{
+  return readCached(&SensorData::water, CachedSensor::WATER, maxAgeMs, [this] { return measureWaterLevel(); });
+}
+
+template <typename T, typename Measure>
+auto SensorController::readCached(T SensorData::* const field, const CachedSensor sensor, const uint32_t maxAgeMs,
+                                  Measure measure) const -> T
 {
-  return {
-    .environment = readBME280(),
-    .light       = readLightLevel(),
-    .soil        = readSoilMoisture(),
-    .water       = readWaterLevel(),
-    .timestamp   = Utils::getTimeSinceBoot(),
-  };
+  static_assert(static_cast<size_t>(CachedSensor::WATER) == static_cast<size_t>(LatencyMetric::WATER));
+
+  const auto index = static_cast<size_t>(sensor);
+  if ((maxAgeMs > 0) and (xSemaphoreTake(cacheMutex_, portMAX_DELAY) == pdPASS))
+  {
+    const auto fresh  = isCacheFresh(sensor, Utils::getTimeSinceBoot(), maxAgeMs);
+    const auto cached = cache_.*field;
+    xSemaphoreGive(cacheMutex_);
+    if (fresh)
+    {
+      return cached;
+    }
+  }
+
+  const auto startMs = Utils::getTimeSinceBoot();
+  const auto result  = measure();
+  RuntimeMetrics::getInstance().recordLatency(static_cast<LatencyMetric>(index), Utils::getTimeSinceBoot() - startMs);
+  if (xSemaphoreTake(cacheMutex_, portMAX_DELAY) == pdPASS)
+  {
+    cache_.*field    = result;
+    cachedAt_[index] = Utils::getTimeSinceBoot();
+    xSemaphoreGive(cacheMutex_);
+  }
+  return result;
+}
+
+auto SensorController::isCacheFresh(const CachedSensor sensor, const uint32_t now, const uint32_t maxAgeMs) const
+  -> bool
+{
+  const auto cachedAt = cachedAt_[static_cast<size_t>(sensor)];
+  return (cachedAt != 0) and ((now - cachedAt) <= maxAgeMs);
+}
+
+void SensorController::storeCache(const SensorData& data) const
+{
+  if (xSemaphoreTake(cacheMutex_, portMAX_DELAY) != pdPASS) [[unlikely]]
+  {
+    return;
+  }
+  cache_ = data;
+  cachedAt_.fill(data.timestamp);
+  xSemaphoreGive(cacheMutex_);
+}
+
+auto SensorController::startAcquisition() const -> Acquisition
+{
+  Acquisition acquisition{};
+  if (xSemaphoreTake(acquisitionMutex_, portMAX_DELAY) != pdPASS) [[unlikely]]
+  {
+    return acquisition;
+  }
+  acquisition.active      = true;
+  acquisition.startedAtMs = Utils::getTimeSinceBoot();
+
+  uint32_t measureMs = 0;
+  if (xSemaphoreTake(soilAdcMutex_, portMAX_DELAY) == pdPASS)
+  {
+    acquisition.soil = soilSensor_ and soilSensor_->powerUp();
+    if (acquisition.soil)
+    {
+      measureMs = std::max(measureMs, Config::SOIL_MOISTURE_POWER_UP_MS);
+    }
+    else
+    {
+      xSemaphoreGive(soilAdcMutex_);
+    }
+  }
+
+  if (xSemaphoreTake(sharedBusMutex_, portMAX_DELAY) == pdPASS)
+  {
+    acquisition.environment = environmentalSensor_ and environmentalSensor_->startMeasurement();
+    if (acquisition.environment)
+    {
+      measureMs = std::max(measureMs, Config::BME280_MEASURE_MS);
+    }
+    acquisition.light = lightSensor_ and lightSensor_->startMeasurement();
+    if (acquisition.light)
+    {
+      measureMs = std::max(measureMs, Config::LIGHT_SENSOR_MEASURE_MS);
+    }
+    xSemaphoreGive(sharedBusMutex_);
+  }
+
+  if (canReadInParallel())
+  {
+    xEventGroupClearBits(acquisitionEvents_, WATER_READY_BIT);
+    xTaskNotifyGive(waterWorker_);
+    acquisition.waterInBackground = true;
+  }
+
+  acquisition.readyAtMs = Utils::getTimeSinceBoot() + measureMs;
+  return acquisition;
+}
+
+auto SensorController::collectAcquisition(const Acquisition& acquisition) const -> SensorData
+{
+  SensorData data{};
+  if (not acquisition.active) [[unlikely]]
+  {
+    return data;
+  }
+
+  waitUntil(acquisition.readyAtMs);
+
+  if (xSemaphoreTake(sharedBusMutex_, portMAX_DELAY) == pdPASS)
+  {
+    if (acquisition.environment)
+    {
+      const auto measurement = environmentalSensor_->collect();
+      if (measurement)
+      {
+        data.environment = measurement.value();
+      }
+    }
+    if (acquisition.light)
+    {
+      const auto measurement = lightSensor_->collect();
+      if (measurement)
+      {
+        data.light = measurement.value();
+      }
+    }
+    xSemaphoreGive(sharedBusMutex_);
+  }
+
+  if (acquisition.soil)
+  {
+    const auto measurement = soilSensor_->collect();
+    if (measurement)
+    {
+      data.soil = measurement.value();
+    }
+    xSemaphoreGive(soilAdcMutex_);
+  }
+
+  if (acquisition.waterInBackground)
+  {
+    xEventGroupWaitBits(acquisitionEvents_, WATER_READY_BIT, pdTRUE, pdTRUE, portMAX_DELAY);
+    data.water = pendingWater_;
+  }
+  else
+  {
+    data.water = measureWaterLevel();
+  }
+  data.timestamp = Utils::getTimeSinceBoot();
+  storeCache(data);
+  RuntimeMetrics::getInstance().recordLatency(LatencyMetric::ACQUISITION, data.timestamp - acquisition.startedAtMs);
+
+  xSemaphoreGive(acquisitionMutex_);
+  return data;
 }
 
-auto SensorController::readBME280() const -> EnvironmentData
+auto SensorController::measureBME280() const -> EnvironmentData
 {
   EnvironmentData result{};
 
-  if (xSemaphoreTakeRecursive(sensorMutex_, portMAX_DELAY) != pdPASS)
+  if (xSemaphoreTake(sharedBusMutex_, portMAX_DELAY) != pdPASS)
   {
     return result;
   }
 
   if (not environmentalSensor_)
   {
-    xSemaphoreGiveRecursive(sensorMutex_);
+    xSemaphoreGive(sharedBusMutex_);
     return result;
   }
 
@@ -149,22 +395,22 @@ auto SensorController::readBME280() const -> EnvironmentData
     result = measurement.value();
   }
 
-  xSemaphoreGiveRecursive(sensorMutex_);
+  xSemaphoreGive(sharedBusMutex_);
   return result;
 }
 
-auto SensorController::readLightLevel() const -> LightLevelData
+auto SensorController::measureLightLevel() const -> LightLevelData
 {
   LightLevelData result{};
 
-  if (xSemaphoreTakeRecursive(sensorMutex_, portMAX_DELAY) != pdPASS)
+  if (xSemaphoreTake(sharedBusMutex_, portMAX_DELAY) != pdPASS)
   {
     return result;
   }
 
   if (not lightSensor_)
   {
-    xSemaphoreGiveRecursive(sensorMutex_);
+    xSemaphoreGive(sharedBusMutex_);
     return result;
   }
   const auto measurement = lightSensor_->read();
@@ -173,22 +419,22 @@ auto SensorController::readLightLevel() const -> LightLevelData
     result = measurement.value();
   }
 
-  xSemaphoreGiveRecursive(sensorMutex_);
+  xSemaphoreGive(sharedBusMutex_);
   return result;
 }
 
-auto SensorController::readSoilMoisture() const -> SoilMoistureData
+auto SensorController::measureSoilMoisture() const -> SoilMoistureData
 {
   SoilMoistureData result{};
 
-  if (xSemaphoreTakeRecursive(sensorMutex_, portMAX_DELAY) != pdPASS)
+  if (xSemaphoreTake(soilAdcMutex_, portMAX_DELAY) != pdPASS)
   {
     return result;
   }
 
   if (not soilSensor_)
   {
-    xSemaphoreGiveRecursive(sensorMutex_);
+    xSemaphoreGive(soilAdcMutex_);
     return result;
   }
 
@@ -198,22 +444,22 @@ auto SensorController::readSoilMoisture() const -> SoilMoistureData
     result = measurement.value();
   }
 
-  xSemaphoreGiveRecursive(sensorMutex_);
+  xSemaphoreGive(soilAdcMutex_);
   return result;
 }
 
-auto SensorController::readWaterLevel() const -> WaterLevelData
+auto SensorController::measureWaterLevel() const -> WaterLevelData
 {
   WaterLevelData result{};
 
-  if (xSemaphoreTakeRecursive(sensorMutex_, portMAX_DELAY) != pdPASS)
+  if (xSemaphoreTake(waterBusMutex_, portMAX_DELAY) != pdPASS)
   {
     return result;
   }
 
   if (not waterSensor_)
   {
-    xSemaphoreGiveRecursive(sensorMutex_);
+    xSemaphoreGive(waterBusMutex_);
     return result;
   }
 
@@ -223,7 +469,7 @@ auto SensorController::readWaterLevel() const -> WaterLevelData
     result = measurement.value();
   }
 
-  xSemaphoreGiveRecursive(sensorMutex_);
+  xSemaphoreGive(waterBusMutex_);
   return result;
 }
 
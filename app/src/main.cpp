@@ -4,7 +4,8 @@
 #include "TaskEntry.hpp"
 
 #include "Config.hpp"
-#include "FlashManager.hpp"
+#include "ConfigService.hpp"
+#include "Crc32.hpp"
 #include "MQTTClient.hpp"
 #include "Types.hpp"
 
@@ -26,7 +27,7 @@ namespace
 SensorController     sensorController;
 IrrigationController irrigationController(sensorController);
 MQTTClient           mqttClient(sensorController, irrigationController);
-ConnectionController connectionController;
+ConnectionController connectionController(sensorController);
 
 void initSystem()
 {
@@ -36,6 +37,8 @@ void initSystem()
          static_cast<int32_t>(Config::System::VERSION.size()), Config::System::VERSION.data());
   printf("=================================================\n\n");
 
+  (void)Crc32::init();
+
   if (not sensorController.init()) [[unlikely]]
   {
     printf("ERROR: SensorController initialization failed!\n");
@@ -46,11 +49,12 @@ void initSystem()
     printf("ERROR: IrrigationController initialization failed!\n");
   }
 
-  SystemConfig config;
-  if (FlashManager::loadConfig(config)) [[likely]]
+  auto& configService = ConfigService::getInstance();
+  if (configService.load()) [[likely]]
   {
-    irrigationController.setMode(config.irrigationMode);
-    printf("Configuration loaded. Irrigation Mode: %d\n", static_cast<int32_t>(config.irrigationMode));
+    const auto config = configService.acquire();
+    irrigationController.setMode(config->irrigationMode);
+    printf("Configuration loaded. Irrigation Mode: %d\n", static_cast<int32_t>(config->irrigationMode));
   }
 
   printf("\n=================================================\n");
@@ -56,11 +56,12 @@ void networkTask(void* const params)
       {
         if (msg.type == AppMessage::Type::SENSOR_DATA)
         {
-          mqtt->publishSensorState(now, msg.sensorData, msg.isWatering, msg.forceUpdate);
+          mqtt->publishSensorState(now, msg.sensor.toSensorData(msg.timestamp), msg.sensor.watering(),
+                                   msg.forceUpdate);
         }
         else if (msg.type == AppMessage::Type::ACTIVITY_LOG)
         {
-          mqtt->publishActivity(msg.activityText.data());
+          mqtt->publishActivity(msg.activity);
         }
       }
     }
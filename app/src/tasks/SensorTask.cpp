@@ -5,8 +5,13 @@
 
 #include "Common.hpp"
 #include "Config.hpp"
-#include "FlashManager.hpp"
+#include "ConfigService.hpp"
+#include "Format.hpp"
+#include "HistoryStore.hpp"
 #include "MQTTClient.hpp"
+#include "PackedSensorRecord.hpp"
+#include "RollupStore.hpp"
+#include "SensorPayloadCache.hpp"
 #include "Types.hpp"
 
 #include <FreeRTOS.h>
@@ -17,7 +22,6 @@
 
 #include <cstdint>
 #include <cstdio>
-#include <cstring>
 
 namespace
 {
@@ -30,8 +34,10 @@ void logEnvironment(const SensorData& data)
     printf("Unavailable\n");
     return;
   }
-  printf("Temp=%.1f°C, Humidity=%.1f%%, Pressure=%.1fhPa\n", data.environment.temperature, data.environment.humidity,
-         data.environment.pressure);
+  const auto temperature = Format::toDecimal(data.environment.temperature, 1);
+  const auto humidity    = Format::toDecimal(data.environment.humidity, 1);
+  const auto pressure    = Format::toDecimal(data.environment.pressure, 1);
+  printf("Temp=%s°C, Humidity=%s%%, Pressure=%shPa\n", temperature.c_str(), humidity.c_str(), pressure.c_str());
 }
 
 void logLight(const SensorData& data)
@@ -43,7 +49,7 @@ void logLight(const SensorData& data)
     return;
   }
 
-  printf("%.1f lux", data.light.lux);
+  printf("%s lux", Format::toDecimal(data.light.lux, 1).c_str());
   if constexpr (Config::ENABLE_SERIAL_DEBUG)
   {
     printf(" (raw=%u)", data.light.rawValue);
@@ -70,10 +76,10 @@ void logSoil(const SensorData& data)
     soilStatus = "WET";
   }
 
-  printf("%.1f%%", data.soil.percentage);
+  printf("%s%%", Format::toDecimal(data.soil.percentage, 1).c_str());
   if constexpr (Config::ENABLE_SERIAL_DEBUG)
   {
-    printf(" (raw=%u)", data.soil.rawValue);
+    printf(" (raw=%u, noise=%s)", data.soil.rawValue, Format::toDecimal(data.soil.noise, 1).c_str());
   }
   printf(" - %s\n", soilStatus);
 }
@@ -93,7 +99,15 @@ void logWaterLevel(const SensorData& data)
     return;
   }
 
-  printf("%.0f%%\n", data.water.percentage);
+  printf("%s%%\n", Format::toDecimal(data.water.percentage, 0).c_str());
+}
+
+void logDelayStats()
+{
+  if constexpr (Config::ENABLE_SERIAL_DEBUG)
+  {
+    printf("  Delays: yielded=%ums, busy=%ums\n", Utils::getYieldedDelayMs(), Utils::getBusyDelayMs());
+  }
 }
 
 void updateErrorLedFromData(AppContext& ctx, const SensorData& data)
@@ -116,15 +130,23 @@ auto handleSensorRead(const uint32_t now, SensorController& sensorController,
   logSoil(data);
   logIrrigation(irrigationController);
   logWaterLevel(data);
+  logDelayStats();
   updateErrorLedFromData(ctx, data);
 
   irrigationController.update(data);
+  const auto watering = irrigationController.isWatering();
+  const auto record   = PackedSensorRecord::from(data, watering);
+  SensorPayloadCache::getInstance().update(data, watering);
+
+  auto& history = HistoryStore::getInstance();
+  (void)history.append(data, watering);
+  RollupStore::getInstance().add(history.toHistoryTime(data.timestamp), record);
 
   const auto msg = AppMessage{
     .type        = AppMessage::Type::SENSOR_DATA,
-    .sensorData  = data,
-    .isWatering  = irrigationController.isWatering(),
     .forceUpdate = force,
+    .timestamp   = data.timestamp,
+    .sensor      = record,
   };
 
   if (ctx.sensorDataQueue != nullptr)
@@ -182,9 +204,8 @@ void handleWateringStateChange(bool& wasWatering, const bool isWatering, const u
   if (wasWatering and not isWatering)
   {
     AppMessage msg;
-    msg.type = AppMessage::Type::ACTIVITY_LOG;
-    strncpy(msg.activityText.data(), "Irrigation finished", msg.activityText.size() - 1);
-    msg.activityText[msg.activityText.size() - 1] = '\0';
+    msg.type     = AppMessage::Type::ACTIVITY_LOG;
+    msg.activity = "Irrigation finished";
     if (ctx.sensorDataQueue)
     {
       xQueueSend(ctx.sensorDataQueue, &msg, 0);
@@ -196,9 +217,8 @@ void handleWateringStateChange(bool& wasWatering, const bool isWatering, const u
   else if (not wasWatering and isWatering)
   {
     AppMessage msg;
-    msg.type = AppMessage::Type::ACTIVITY_LOG;
-    strncpy(msg.activityText.data(), "Irrigation started", msg.activityText.size() - 1);
-    msg.activityText[msg.activityText.size() - 1] = '\0';
+    msg.type     = AppMessage::Type::ACTIVITY_LOG;
+    msg.activity = "Irrigation started";
     if (ctx.sensorDataQueue)
     {
       xQueueSend(ctx.sensorDataQueue, &msg, 0);
@@ -236,6 +256,27 @@ void determineSensorReadNeeds(const uint32_t now, const uint32_t lastSensorRead,
   }
 }
 
+auto sensorReadIntervalOf(const SystemConfig& config) -> uint32_t
+{
+  return (config.sensorReadIntervalMs == 0) ? Config::DEFAULT_SENSOR_READ_INTERVAL_MS : config.sensorReadIntervalMs;
+}
+
+void applyConfigChanges(const uint32_t changed, uint32_t& sensorReadInterval,
+                        IrrigationController& irrigationController)
+{
+  const auto config = ConfigService::getInstance().acquire();
+  if ((changed & ConfigField::SENSOR_INTERVAL) != 0)
+  {
+    sensorReadInterval = sensorReadIntervalOf(*config);
+    HistoryStore::getInstance().setSampleInterval(sensorReadInterval);
+    printf("[SensorTask] Sensor read interval set to %lu ms\n", static_cast<unsigned long>(sensorReadInterval));
+  }
+  if ((changed & ConfigField::IRRIGATION_MODE) != 0)
+  {
+    irrigationController.setMode(config->irrigationMode);
+  }
+}
+
 }  // namespace
 
 void sensorTask(void* const params)
@@ -246,18 +287,25 @@ void sensorTask(void* const params)
   auto& irrigationController = *taskCtx.irrigationController;
   auto& mqttClient           = *taskCtx.mqttClient;
 
-  SystemConfig config;
-  if (not FlashManager::loadConfig(config)) [[unlikely]]
+  if (not HistoryStore::getInstance().init()) [[unlikely]]
   {
-    config = {};
+    printf("[SensorTask] Sensor history unavailable\n");
+  }
+  if (not RollupStore::getInstance().init()) [[unlikely]]
+  {
+    printf("[SensorTask] Sensor rollups unavailable\n");
   }
 
-  auto sensorReadInterval = config.sensorReadIntervalMs;
-  if (sensorReadInterval == 0)
+  auto& configService = ConfigService::getInstance();
+  if (not configService.subscribe(xTaskGetCurrentTaskHandle(),
+                                  ConfigField::SENSOR_INTERVAL | ConfigField::IRRIGATION_MODE)) [[unlikely]]
   {
-    sensorReadInterval = Config::DEFAULT_SENSOR_READ_INTERVAL_MS;
+    printf("[SensorTask] Live configuration updates unavailable\n");
   }
 
+  auto sensorReadInterval = sensorReadIntervalOf(*configService.acquire());
+  HistoryStore::getInstance().setSampleInterval(sensorReadInterval);
+
   auto               lastSensorRead   = sensorReadInterval;
   constexpr uint32_t sensorTaskTickMs = 100;
 
@@ -271,6 +319,7 @@ void sensorTask(void* const params)
     const auto now        = Utils::getTimeSinceBoot();
     const auto isWatering = irrigationController.isWatering();
     appCtx.setActivityLedState(isWatering);
+    SensorPayloadCache::getInstance().setWatering(isWatering);
 
     handleWateringStateChange(wasWatering, isWatering, now, scheduledReadTime, pendingPostWateringRead, appCtx);
 
@@ -298,6 +347,12 @@ void sensorTask(void* const params)
       appCtx.setActivityLedState(irrigationController.isWatering());
     }
 
-    vTaskDelay(pdMS_TO_TICKS(sensorTaskTickMs));
+    (void)HistoryStore::getInstance().flushIfStale(now);
+
+    const auto changed = ConfigService::waitForChanges(pdMS_TO_TICKS(sensorTaskTickMs));
+    if (changed != 0)
+    {
+      applyConfigChanges(changed, sensorReadInterval, irrigationController);
+    }
   }
 }
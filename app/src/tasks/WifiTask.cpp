@@ -3,7 +3,8 @@
 
 #include "Common.hpp"
 #include "Config.hpp"
-#include "FlashManager.hpp"
+#include "ConfigService.hpp"
+#include "HistoryStore.hpp"
 #include "Types.hpp"
 
 #include <FreeRTOS.h>
@@ -31,7 +32,7 @@ void blinkErrorAsync(const uint8_t times, const TickType_t onTicks, const TickTy
   }
 }
 
-void processWifiCommand(const WifiCommand cmd, WifiTaskContext* const ctx, bool& connected)
+void processWifiCommand(const WifiCommand cmd, WifiTaskContext* const ctx, SystemConfig& config, bool& connected)
 {
   auto& appCtx = *ctx->appContext;
   switch (cmd)
@@ -52,34 +53,27 @@ void processWifiCommand(const WifiCommand cmd, WifiTaskContext* const ctx, bool&
 
       ctx->mqttClient->setWifiReady(false);
 
-      const auto reboot = ctx->provisioner->startApAndServe(
-        Config::AP::SESSION_TIMEOUT_MS, *ctx->mqttClient->getSensorController(), (bool*)&appCtx.apCancel);
+      const auto updated = ctx->provisioner->startApAndServe(Config::AP::SESSION_TIMEOUT_MS, (bool*)&appCtx.apCancel);
 
       appCtx.apActive = false;
 
-      if (reboot)
+      (void)ConfigService::waitForChanges(0);
+      config = ConfigService::getInstance().snapshot();
+      if (updated)
       {
-        printf("[WiFi] Configuration updated, rebooting...\n");
-        watchdog_reboot(0, 0, 0);
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        printf("[WiFi] Configuration updated, reconnecting\n");
+      }
+
+      if (config.wifi.valid)
+      {
+        connected = ctx->provisioner->connectSta(config.wifi);
+        ctx->mqttClient->setWifiReady(connected);
+        (void)ctx->mqttClient->init(config.mqtt);
       }
       else
       {
-        SystemConfig config;
-        if (FlashManager::loadConfig(config) and config.wifi.valid)
-        {
-          connected = ctx->provisioner->connectSta(config.wifi);
-          ctx->mqttClient->setWifiReady(connected);
-          if (config.mqtt.enabled)
-          {
-            (void)ctx->mqttClient->init(config.mqtt);
-          }
-        }
-        else
-        {
-          connected = connected and ctx->provisioner->isConnected();
-          ctx->mqttClient->setWifiReady(connected);
-        }
+        connected = connected and ctx->provisioner->isConnected();
+        ctx->mqttClient->setWifiReady(connected);
       }
 
       appCtx.setNetworkLedState(connected ? NetworkLedState::CONNECTED : NetworkLedState::OFF);
@@ -89,6 +83,7 @@ void processWifiCommand(const WifiCommand cmd, WifiTaskContext* const ctx, bool&
     {
       printf("[WiFi] Reboot requested, blinking error LED 3x\n");
       blinkErrorAsync(3, pdMS_TO_TICKS(200), pdMS_TO_TICKS(200));
+      (void)HistoryStore::getInstance().flush();
       watchdog_reboot(0, 0, 0);
       vTaskDelay(pdMS_TO_TICKS(100));
       break;
@@ -152,6 +147,22 @@ void handleConnectionRetry(WifiTaskContext* const ctx, const SystemConfig& confi
   }
 }
 
+void applyConfigChanges(WifiTaskContext* const ctx, const uint32_t changed, SystemConfig& config, bool& connected)
+{
+  config = ConfigService::getInstance().snapshot();
+  if ((changed & ConfigField::WIFI) != 0)
+  {
+    printf("[WiFi] Credentials changed, reconnecting\n");
+    ctx->appContext->setNetworkLedState(NetworkLedState::CONNECTING);
+    handleInitialConnection(ctx, config, connected);
+  }
+  else if ((changed & ConfigField::MQTT) != 0)
+  {
+    printf("[WiFi] MQTT settings changed, reinitializing client\n");
+    (void)ctx->mqttClient->init(config.mqtt);
+  }
+}
+
 }  // namespace
 
 void wifiProvisionTask(void* const params)
@@ -164,11 +175,8 @@ void wifiProvisionTask(void* const params)
 
   ctx->appContext->setNetworkLedState(NetworkLedState::CONNECTING);
 
-  SystemConfig config;
-  if (not FlashManager::loadConfig(config))
-  {
-    config = {};
-  }
+  auto config = ConfigService::getInstance().snapshot();
+  (void)ConfigService::getInstance().subscribe(xTaskGetCurrentTaskHandle(), ConfigField::WIFI | ConfigField::MQTT);
 
   bool connected = false;
   handleInitialConnection(ctx, config, connected);
@@ -183,7 +191,13 @@ void wifiProvisionTask(void* const params)
     auto* const queue = ctx->appContext->wifiCommandQueue;
     if ((queue != nullptr) and (xQueueReceive(queue, &cmd, pdMS_TO_TICKS(100)) == pdPASS))
     {
-      processWifiCommand(cmd, ctx, connected);
+      processWifiCommand(cmd, ctx, config, connected);
+    }
+
+    const auto changed = ConfigService::waitForChanges(0);
+    if (changed != 0)
+    {
+      applyConfigChanges(ctx, changed, config, connected);
     }
 
     if (not connected and not ctx->appContext->apActive and config.wifi.valid)
@@ -43,28 +43,77 @@ inline constexpr const char* DEFAULT_DISCOVERY_PREFIX    = "homeassistant";
 inline constexpr const char* DEFAULT_BASE_TOPIC          = "smartplant";
 inline constexpr uint32_t    DEFAULT_PUBLISH_INTERVAL_MS = 3'600'000;
 inline constexpr uint32_t    RECONNECT_INTERVAL_MS       = 5'000;
+inline constexpr bool        PUBLISH_PACKED_STATE        = false;
+inline constexpr size_t      OUTBOX_ENTRIES              = 48;
+inline constexpr size_t      OUTBOX_SPILL_RANGES         = 4;
+inline constexpr size_t      BACKLOG_BATCH               = 4;
+inline constexpr uint32_t    BACKLOG_PACE_MS             = 1'000;
+inline constexpr size_t      PUBLISH_QUEUE_SIZE          = 16;
+inline constexpr size_t      PUBLISH_IN_FLIGHT           = 12;
+inline constexpr size_t      QUEUE_TOPIC_SIZE            = 128;
+inline constexpr size_t      QUEUE_PAYLOAD_SIZE          = 512;
+inline constexpr bool        DEVICE_DISCOVERY            = true;
+inline constexpr size_t      DISCOVERY_PAYLOAD_SIZE      = 2'560;
 }  // namespace MQTT
 
+namespace Http
+{
+inline constexpr uint16_t PORT                    = 80;
+inline constexpr size_t   WORKER_COUNT            = 2;
+inline constexpr size_t   MAX_PENDING_CONNECTIONS = 4;
+inline constexpr size_t   REQUEST_BUFFER_SIZE     = 2'048;
+inline constexpr uint32_t MAX_KEEP_ALIVE_REQUESTS = 32;
+inline constexpr uint32_t KEEP_ALIVE_TIMEOUT_MS   = 5'000;
+inline constexpr uint32_t REQUEST_TIMEOUT_MS      = 3'000;
+inline constexpr uint32_t SEND_TIMEOUT_MS         = 3'000;
+inline constexpr uint32_t IDLE_POLL_MS            = 20;
+inline constexpr uint32_t ACCEPT_POLL_MS          = 250;
+inline constexpr size_t   MAX_STREAM_CLIENTS      = 3;
+inline constexpr uint32_t STREAM_KEEP_ALIVE_MS    = 15'000;
+inline constexpr uint32_t STREAM_SEND_TIMEOUT_MS  = 500;
+inline constexpr uint32_t STREAM_RETRY_MS         = 5'000;
+}  // namespace Http
+
+namespace History
+{
+inline constexpr uint32_t FLASH_SECTORS       = 256;
+inline constexpr size_t   BATCH_PAGES         = 4;
+inline constexpr uint32_t FLUSH_AGE_SAMPLES   = 512;
+inline constexpr uint32_t MAX_FLUSH_AGE_MS    = 3'600'000;
+inline constexpr size_t   FIVE_MINUTE_BUCKETS = 288;
+inline constexpr size_t   HOURLY_BUCKETS      = 336;
+inline constexpr size_t   DAILY_BUCKETS       = 366;
+}  // namespace History
+
+inline constexpr uint32_t I2C_TRANSACTION_TIMEOUT_MS = 25;
+inline constexpr uint32_t I2C_NOTIFY_INDEX           = 1;
+inline constexpr uint32_t CONFIG_NOTIFY_INDEX        = 2;
+
 inline constexpr uint8_t  BME280_I2C_INSTANCE = 0;
 inline constexpr uint8_t  BME280_SDA_PIN      = 4;
 inline constexpr uint8_t  BME280_SCL_PIN      = 5;
 inline constexpr uint32_t BME280_I2C_BAUDRATE = 400'000;
 inline constexpr uint8_t  BME280_I2C_ADDRESS  = 0x76;
+inline constexpr uint32_t BME280_MEASURE_MS   = 10;
 
 inline constexpr uint8_t  LIGHT_SENSOR_I2C_INSTANCE = BME280_I2C_INSTANCE;
 inline constexpr uint8_t  LIGHT_SENSOR_SDA_PIN      = BME280_SDA_PIN;
 inline constexpr uint8_t  LIGHT_SENSOR_SCL_PIN      = BME280_SCL_PIN;
 inline constexpr uint32_t LIGHT_SENSOR_I2C_BAUDRATE = BME280_I2C_BAUDRATE;
 inline constexpr uint8_t  LIGHT_SENSOR_I2C_ADDRESS  = 0x23;
-
-inline constexpr uint8_t  SOIL_MOISTURE_POWER_UP_PIN  = 22;
-inline constexpr uint32_t SOIL_MOISTURE_POWER_UP_MS   = 500;
-inline constexpr uint8_t  SOIL_MOISTURE_ADC_PIN       = 26;
-inline constexpr uint8_t  SOIL_MOISTURE_ADC_CHANNEL   = 0;
-inline constexpr uint16_t SOIL_DRY_VALUE              = 3'500;
-inline constexpr uint16_t SOIL_WET_VALUE              = 1'500;
-inline constexpr float    SOIL_MOISTURE_DRY_THRESHOLD = 30.0F;
-inline constexpr float    SOIL_MOISTURE_WET_THRESHOLD = 70.0F;
+inline constexpr uint32_t LIGHT_SENSOR_MEASURE_MS   = 180;
+
+inline constexpr uint8_t  SOIL_MOISTURE_POWER_UP_PIN   = 22;
+inline constexpr uint32_t SOIL_MOISTURE_POWER_UP_MS    = 200;
+inline constexpr uint8_t  SOIL_MOISTURE_ADC_PIN        = 26;
+inline constexpr uint8_t  SOIL_MOISTURE_ADC_CHANNEL    = 0;
+inline constexpr size_t   SOIL_MOISTURE_SAMPLE_COUNT   = 256;
+inline constexpr uint32_t SOIL_MOISTURE_SAMPLE_RATE_HZ = 100'000;
+inline constexpr float    SOIL_MOISTURE_MAX_NOISE      = 40.0F;
+inline constexpr uint16_t SOIL_DRY_VALUE               = 3'500;
+inline constexpr uint16_t SOIL_WET_VALUE               = 1'500;
+inline constexpr float    SOIL_MOISTURE_DRY_THRESHOLD  = 30.0F;
+inline constexpr float    SOIL_MOISTURE_WET_THRESHOLD  = 70.0F;
 
 inline constexpr uint8_t  WATER_LEVEL_I2C_INSTANCE      = 1;
 inline constexpr uint8_t  WATER_LEVEL_SDA_PIN           = 18;
@@ -107,6 +156,7 @@ inline constexpr size_t   MAX_LOG_ENTRIES     = 1'000;
 inline constexpr uint32_t SERIAL_BAUDRATE     = 115'200;
 
 inline constexpr uint32_t       DEFAULT_SENSOR_READ_INTERVAL_MS = 3'600'000;
+inline constexpr uint32_t       SENSOR_CACHE_MAX_AGE_MS         = 60'000;
 inline constexpr IrrigationMode DEFAULT_IRRIGATION_MODE         = IrrigationMode::EVAPOTRANSPIRATION;
 
 }  // namespace Config
@@ -1,6 +1,10 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
+#ifndef __ASSEMBLER__
+#include <hardware/timer.h>
+#endif
+
 #define configENABLE_FPU 1
 #define configENABLE_MPU 0
 #define configENABLE_TRUSTZONE 0
@@ -44,6 +48,13 @@
 #define configUSE_DAEMON_TASK_STARTUP_HOOK 0
 #define configUSE_PASSIVE_IDLE_HOOK 0
 
+#define configUSE_TRACE_FACILITY 1
+#define configGENERATE_RUN_TIME_STATS 1
+#define configUSE_STATS_FORMATTING_FUNCTIONS 0
+#define configRUN_TIME_COUNTER_TYPE uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() time_us_64()
+
 #define configUSE_TIMERS 1
 #define configTIMER_TASK_PRIORITY (configMAX_PRIORITIES - 1)
 #define configTIMER_QUEUE_LENGTH 10
@@ -3,9 +3,13 @@
 
 #define NO_SYS 0
 #define SYS_LIGHTWEIGHT_PROT 1
+#define LWIP_TCPIP_CORE_LOCKING 1
 #define LWIP_SOCKET 1
 #define LWIP_NETCONN 1
 #define LWIP_TIMEVAL_PRIVATE 0
+#define LWIP_SO_RCVTIMEO 1
+#define LWIP_SO_SNDTIMEO 1
+#define SO_REUSE 1
 
 #define LWIP_MQTT 1
 #define MQTT_OUTPUT_RINGBUF_SIZE 4096
@@ -37,8 +41,19 @@
 #define LWIP_NETIF_STATUS_CALLBACK 1
 #define LWIP_NETIF_LINK_CALLBACK 1
 
-#define LWIP_STATS 0
+#define LWIP_STATS 1
 #define LWIP_STATS_DISPLAY 0
+#define LWIP_STATS_LARGE 1
+#define LINK_STATS 0
+#define ETHARP_STATS 0
+#define IP_STATS 0
+#define ICMP_STATS 0
+#define IGMP_STATS 0
+#define UDP_STATS 0
+#define TCP_STATS 1
+#define MEM_STATS 1
+#define MEMP_STATS 1
+#define SYS_STATS 0
 
 #define LWIP_CHECKSUM_ON_COPY 1
 
@@ -57,6 +72,8 @@
 #define MEM_SIZE 8192
 #define MEMP_NUM_SYS_TIMEOUT 16
 #define MEMP_NUM_TCP_SEG 32
+#define MEMP_NUM_TCP_PCB 14
+#define MEMP_NUM_NETCONN 12
 #define MEMP_NUM_PBUF 24
 #define PBUF_POOL_SIZE 24
 
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "HttpServer.hpp"
+
+#include <string_view>
+
+namespace HistoryExporter
+{
+
+auto serve(std::string_view query, HttpResponse& response) -> bool;
+
+}  // namespace HistoryExporter
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Home Assistant MQTT discovery for the device. Topics are written relative to the "~" base topic, so everything
+// except the base topic is fixed at compile time.
+namespace HomeAssistantDiscovery
+{
+
+struct Component
+{
+  std::string_view platform;
+  std::string_view objectId;
+  std::string_view name;
+  std::string_view stateTopic    = {};
+  std::string_view commandTopic  = {};
+  std::string_view valueTemplate = {};
+  std::string_view unit          = {};
+  std::string_view deviceClass   = {};
+  std::string_view options       = {};
+  uint32_t         min           = 0;
+  uint32_t         max           = 0;
+  bool             bareNode      = false;
+};
+
+inline constexpr std::array<Component, 11> COMPONENTS = {
+  {
+   {.platform      = "sensor",
+    .objectId      = "temperature",
+    .name          = "Temperature",
+    .stateTopic    = "~/state",
+    .valueTemplate = "{{ value_json.temperature }}",
+    .unit          = "°C",
+    .deviceClass   = "temperature",
+    .bareNode      = true},
+   {.platform      = "sensor",
+    .objectId      = "humidity",
+    .name          = "Humidity",
+    .stateTopic    = "~/state",
+    .valueTemplate = "{{ value_json.humidity }}",
+    .unit          = "%",
+    .deviceClass   = "humidity",
+    .bareNode      = true},
+   {.platform      = "sensor",
+    .objectId      = "pressure",
+    .name          = "Air Pressure",
+    .stateTopic    = "~/state",
+    .valueTemplate = "{{ value_json.pressure }}",
+    .unit          = "hPa",
+    .deviceClass   = "pressure",
+    .bareNode      = true},
+   {.platform      = "sensor",
+    .objectId      = "soil",
+    .name          = "Soil Moisture",
+    .stateTopic    = "~/state",
+    .valueTemplate = "{{ value_json.soil_moisture }}",
+    .unit          = "%",
+    .deviceClass   = "moisture",
+    .bareNode      = true},
+   {.platform      = "sensor",
+    .objectId      = "light",
+    .name          = "Ambient Light",
+    .stateTopic    = "~/state",
+    .valueTemplate = "{{ value_json.light_lux }}",
+    .unit          = "lx",
+    .deviceClass   = "illuminance",
+    .bareNode      = true},
+   {.platform      = "sensor",
+    .objectId      = "water",
+    .name          = "Water Level",
+    .stateTopic    = "~/state",
+    .valueTemplate = "{{ value_json.water_level }}",
+    .unit          = "%",
+    .bareNode      = true},
+   {.platform     = "select",
+    .objectId     = "mode",
+    .name         = "Irrigation Mode",
+    .stateTopic   = "~/mode/state",
+    .commandTopic = "~/mode/set",
+    .options      = R"(["OFF","MANUAL","TIMER","HUMIDITY","EVAPOTRANSPIRATION"])"},
+   {.platform = "button", .objectId = "trigger", .name = "Trigger Irrigation", .commandTopic = "~/trigger/set"},
+   {.platform = "button", .objectId = "update", .name = "Update Sensors", .commandTopic = "~/update/trigger"},
+   {.platform     = "number",
+    .objectId     = "interval",
+    .name         = "Update Interval",
+    .stateTopic   = "~/interval/state",
+    .commandTopic = "~/interval/set",
+    .unit         = "s",
+    .min          = 60,
+    .max          = 86'400},
+   {.platform = "text", .objectId = "activity", .name = "Activity Log", .stateTopic = "~/activity/state"},
+   }
+};
+
+// One retained message listing every component, for Home Assistant 2024.11 and later.
+auto deviceTopic(std::string_view discoveryPrefix, std::span<char> out) -> std::string_view;
+auto deviceConfig(std::string_view baseTopic, std::span<char> out) -> std::string_view;
+
+// One retained message per component, for older Home Assistant releases.
+auto entityTopic(const Component& component, std::string_view discoveryPrefix, std::span<char> out)
+  -> std::string_view;
+auto entityConfig(const Component& component, std::string_view baseTopic, std::span<char> out) -> std::string_view;
+
+// Stored fingerprint of a device that has not published discovery yet; fingerprint() never returns it.
+inline constexpr uint32_t NEVER_PUBLISHED = 0;
+
+// CRC-32 over everything the active discovery mode publishes (topics, base topic, firmware version and components)
+// and the broker it is published to, since retained configs do not follow the device to another broker.
+auto fingerprint(std::string_view discoveryPrefix, std::string_view baseTopic, std::string_view brokerHost,
+                 uint16_t brokerPort) -> uint32_t;
+
+}  // namespace HomeAssistantDiscovery
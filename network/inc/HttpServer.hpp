@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <FreeRTOS.h>
+#include <lwip/api.h>
+#include <queue.h>
+#include <task.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+
+struct HttpRequest
+{
+  std::string_view method;
+  std::string_view path;
+  std::string_view query;
+  std::string_view version;
+  std::string_view headers;
+  std::string_view body;
+  bool             keepAlive = false;
+
+  auto header(std::string_view name) const -> std::string_view;
+};
+
+class HttpResponse final
+{
+public:
+  HttpResponse(netconn* connection, bool keepAlive, bool chunkedAllowed = true);
+  ~HttpResponse() = default;
+
+  HttpResponse(const HttpResponse&)                    = delete;
+  auto operator=(const HttpResponse&) -> HttpResponse& = delete;
+  HttpResponse(HttpResponse&&)                         = delete;
+  auto operator=(HttpResponse&&) -> HttpResponse&      = delete;
+
+  auto addHeader(std::string_view name, std::string_view value) -> bool;
+
+  auto send(std::string_view body, const char* contentType = "text/html", const char* status = "200 OK") -> bool;
+  auto sendStatic(std::span<const uint8_t> body, const char* contentType, const char* status = "200 OK") -> bool;
+  auto sendNotModified() -> bool;
+  auto beginStream(const char* contentType) -> bool;
+  auto beginChunked(const char* contentType, const char* status = "200 OK") -> bool;
+  auto writeChunk(std::string_view data) -> bool;
+  auto endChunked() -> bool;
+
+  void closeAfterResponse();
+  auto detach() -> netconn*;
+
+  auto keepAlive() const -> bool;
+  auto sent() const -> bool;
+  auto detached() const -> bool;
+
+private:
+  auto sendHead(const char* status, const char* contentType, std::optional<size_t> contentLength, bool hasBody)
+    -> bool;
+  auto sendBody(const void* data, size_t size, uint8_t flags) -> bool;
+
+  netconn*              connection_;
+  bool                  keepAlive_;
+  bool                  chunkedAllowed_;
+  bool                  sent_        = false;
+  bool                  detached_    = false;
+  bool                  chunked_     = false;
+  bool                  unframed_    = false;
+  size_t                extraLength_ = 0;
+  std::array<char, 160> extraHeaders_{};
+};
+
+class HttpServer final
+{
+public:
+  using Handler = std::function<void(const HttpRequest& request, HttpResponse& response)>;
+
+  HttpServer() = default;
+  ~HttpServer();
+
+  HttpServer(const HttpServer&)                    = delete;
+  auto operator=(const HttpServer&) -> HttpServer& = delete;
+  HttpServer(HttpServer&&)                         = delete;
+  auto operator=(HttpServer&&) -> HttpServer&      = delete;
+
+  auto start(uint16_t port, Handler handler) -> bool;
+  void stop();
+
+  auto isRunning() const -> bool;
+
+private:
+  struct Worker
+  {
+    HttpServer*                                         server = nullptr;
+    TaskHandle_t                                        task   = nullptr;
+    std::array<char, Config::Http::REQUEST_BUFFER_SIZE> buffer = {};
+  };
+
+  struct Connection
+  {
+    netconn* conn          = nullptr;
+    netbuf*  pending       = nullptr;
+    uint16_t pendingOffset = 0;
+    size_t   buffered      = 0;
+  };
+
+  enum class ReceiveResult : uint8_t
+  {
+    DATA,
+    TIMEOUT,
+    CLOSED,
+  };
+
+  static void acceptTask(void* params);
+  static void workerTask(void* params);
+
+  void acceptLoop();
+  void serveConnection(netconn* client, std::span<char> buffer);
+  auto readRequest(Connection& connection, std::span<char> buffer, HttpRequest& request) -> size_t;
+  static auto receive(Connection& connection, std::span<char> buffer) -> ReceiveResult;
+  auto shouldYieldConnection() const -> bool;
+
+  netconn*      listener_   = nullptr;
+  TaskHandle_t  acceptTask_ = nullptr;
+  QueueHandle_t pending_    = nullptr;
+  Handler       handler_;
+
+  std::atomic<bool>     running_     = false;
+  std::atomic<uint32_t> activeTasks_ = 0;
+
+  std::array<Worker, Config::Http::WORKER_COUNT> workers_;
+};
@@ -1,12 +1,17 @@
 #pragma once
 
+#include "MqttOutbox.hpp"
 #include "MqttTransport.hpp"
 
+#include "Config.hpp"
+#include "HomeAssistantDiscovery.hpp"
 #include "IrrigationController.hpp"
 #include "SensorController.hpp"
 #include "Types.hpp"
 
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 
@@ -44,15 +49,16 @@ class MQTTClient final
 private:
   void ensureMqtt(uint32_t nowMs);
   void publishDiscovery();
+  auto publishDeviceDiscovery(uint32_t token) -> bool;
+  auto publishEntityDiscovery(const HomeAssistantDiscovery::Component& component, uint32_t token) -> bool;
+  auto clearEntityDiscovery(uint32_t token) -> bool;
+  void handleDelivery(uint32_t token, bool delivered);
+  void confirmDiscovery();
   void publishAvailability(bool online);
-  void publishSensorDiscovery(std::string_view component, std::string_view objectId, std::string_view name,
-                              std::string_view valueTemplate, std::string_view unit, std::string_view deviceClass = {});
-  void publishSelectDiscovery();
-  void publishButtonDiscovery();
-  void publishNumberDiscovery();
-  void publishTextDiscovery();
   void publishIntervalState();
-  void publishUpdateTriggerDiscovery();
+
+  void queueSample(const SensorData& data, bool watering);
+  void drainBacklog(uint32_t nowMs);
 
   void connectMqtt();
   void subscribeToCommands();
@@ -78,14 +84,31 @@ class MQTTClient final
   uint32_t lastPublish_          = 0;
   uint32_t lastReconnectAttempt_ = 0;
 
-  std::array<char, 128> availabilityTopic_    = {};
-  std::array<char, 128> stateTopic_           = {};
-  std::array<char, 128> commandTopic_         = {};
-  std::array<char, 128> modeCommandTopic_     = {};
-  std::array<char, 128> modeStateTopic_       = {};
-  std::array<char, 128> triggerCommandTopic_  = {};
-  std::array<char, 128> updateCommandTopic_   = {};
-  std::array<char, 128> intervalCommandTopic_ = {};
-  std::array<char, 128> intervalStateTopic_   = {};
-  std::array<char, 128> activityStateTopic_   = {};
+  MqttOutbox                                           outbox_;
+  std::array<OutboxEntry, Config::MQTT::BACKLOG_BATCH> backlogBatch_    = {};
+  size_t                                               backlogInFlight_ = 0;
+  uint32_t                                             nextBacklogMs_   = 0;
+  std::atomic<uint32_t>                                backlogAcked_    = 0;
+  std::atomic<uint32_t>                                backlogFailed_   = 0;
+
+  std::array<char, 128> availabilityTopic_        = {};
+  std::array<char, 128> stateTopic_               = {};
+  std::array<char, 128> packedStateTopic_         = {};
+  std::array<char, 128> backlogTopic_             = {};
+  std::array<char, 128> commandTopic_             = {};
+  std::array<char, 128> modeCommandTopic_         = {};
+  std::array<char, 128> modeStateTopic_           = {};
+  std::array<char, 128> triggerCommandTopic_      = {};
+  std::array<char, 128> updateCommandTopic_       = {};
+  std::array<char, 128> intervalCommandTopic_     = {};
+  std::array<char, 128> intervalStateTopic_       = {};
+  std::array<char, 128> activityStateTopic_       = {};
+  std::array<char, 128> homeAssistantStatusTopic_ = {};
+
+  std::array<char, Config::MQTT::DISCOVERY_PAYLOAD_SIZE> discoveryPayload_     = {};
+  uint32_t                                               discoveryFingerprint_ = 0;
+  std::atomic<uint32_t>                                  pendingFingerprint_   = 0;
+  std::atomic<uint32_t>                                  confirmedFingerprint_ = 0;
+  std::atomic<uint32_t>                                  discoveryUnacked_     = 0;
+  std::atomic<bool>                                      refreshDiscovery_     = false;
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "HttpServer.hpp"
+
+namespace MetricsExporter
+{
+
+auto serve(HttpResponse& response) -> bool;
+
+}  // namespace MetricsExporter
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Config.hpp"
+#include "PackedSensorRecord.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+struct OutboxEntry
+{
+  uint32_t           time = 0;
+  PackedSensorRecord record;
+};
+
+// Samples that could not be published, oldest first. Recent ones stay in a RAM ring; once it overflows the evicted
+// ranges are re-read from the history flash ring instead of being written to flash a second time. Samples published
+// live split the ranges, so a later outage never replays them.
+class MqttOutbox final
+{
+public:
+  MqttOutbox() = default;
+
+  void push(uint32_t time, const PackedSensorRecord& record);
+  void markLive();
+  auto peek(std::span<OutboxEntry> out, uint32_t spacing) -> size_t;
+  void pop(uint32_t through);
+
+  auto empty() const -> bool;
+  auto spilled() const -> bool;
+
+private:
+  struct SpillRange
+  {
+    uint32_t from = 0;
+    uint32_t to   = 0;
+  };
+
+  void spill(uint32_t time, bool afterLive);
+  auto peekSpilled(std::span<OutboxEntry> out) -> size_t;
+  void dropSpill();
+
+  std::array<OutboxEntry, Config::MQTT::OUTBOX_ENTRIES> ring_      = {};
+  std::bitset<Config::MQTT::OUTBOX_ENTRIES>             afterLive_ = {};
+  size_t                                                head_      = 0;
+  size_t                                                size_      = 0;
+  bool                                                  live_      = false;
+
+  std::array<SpillRange, Config::MQTT::OUTBOX_SPILL_RANGES> spills_     = {};
+  size_t                                                    spillHead_  = 0;
+  size_t                                                    spillCount_ = 0;
+  uint32_t                                                  spacing_    = 1;
+};
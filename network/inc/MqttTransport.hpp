@@ -1,17 +1,33 @@
 #pragma once
 
+#include "Config.hpp"
+
+#include <FreeRTOS.h>
 #include <lwip/apps/mqtt.h>
+#include <semphr.h>
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
 #include <string_view>
 
+// Commands, acknowledgements, availability and discovery go first, then live telemetry, then backfill.
+enum class MqttPriority : uint8_t
+{
+  CONTROL,
+  TELEMETRY,
+  BACKLOG,
+};
+
 class MqttTransport final
 {
 public:
-  using ConnectCallback = std::function<void(bool success)>;
-  using MessageCallback = std::function<void(std::string_view topic, std::string_view payload)>;
+  using ConnectCallback  = std::function<void(bool success)>;
+  using MessageCallback  = std::function<void(std::string_view topic, std::string_view payload)>;
+  using DeliveryCallback = std::function<void(uint32_t token, bool delivered)>;
 
   MqttTransport() = default;
   ~MqttTransport();
@@ -25,16 +41,64 @@ class MqttTransport final
   void connect(ConnectCallback cb);
   void disconnect();
 
-  auto publish(const char* topic, const char* payload, bool retain = false) -> bool;
+  auto publish(const char* topic, const char* payload, bool retain = false,
+               MqttPriority priority = MqttPriority::CONTROL) -> bool;
+  // QoS 1 messages report their token to the delivery callback exactly once: on PUBACK, or as failed when they are
+  // rejected, evicted or dropped with the connection.
+  auto publish(const char* topic, std::string_view payload, bool retain = false,
+               MqttPriority priority = MqttPriority::CONTROL, uint8_t qos = 0, uint32_t token = 0) -> bool;
+  // Queues a payload too large for a queue slot without copying it; it must stay unchanged until sent or dropped.
+  auto publishBorrowed(const char* topic, std::string_view payload, bool retain = false,
+                       MqttPriority priority = MqttPriority::CONTROL, uint8_t qos = 0, uint32_t token = 0) -> bool;
   auto subscribe(const char* topic) -> bool;
+  void service();
 
   void setOnMessage(MessageCallback cb);
+  void setOnDelivery(DeliveryCallback cb);
   auto isConnected() const -> bool;
 
 private:
+  struct QueuedMessage
+  {
+    std::array<char, Config::MQTT::QUEUE_TOPIC_SIZE>   topic    = {};
+    std::array<char, Config::MQTT::QUEUE_PAYLOAD_SIZE> payload  = {};
+    const char*                                        borrowed = nullptr;
+    uint16_t                                           length   = 0;
+    uint32_t                                           sequence = 0;
+    uint32_t                                           token    = 0;
+    MqttPriority                                       priority = MqttPriority::CONTROL;
+    uint8_t                                            qos      = 0;
+    bool                                               retain   = false;
+    bool                                               used     = false;
+  };
+
+  // Per-request lwIP callback argument for a QoS 1 publish awaiting its PUBACK.
+  struct Completion
+  {
+    MqttTransport* owner = nullptr;
+    uint32_t       token = 0;
+    bool           used  = false;
+  };
+
+  struct FailedTokens
+  {
+    std::array<uint32_t, Config::MQTT::PUBLISH_QUEUE_SIZE + Config::MQTT::PUBLISH_IN_FLIGHT> tokens = {};
+    size_t                                                                                   count  = 0;
+  };
+
+  auto enqueue(const char* topic, std::string_view payload, bool retain, MqttPriority priority, uint8_t qos,
+               uint32_t token, bool borrow) -> bool;
+  auto nextQueued() -> QueuedMessage*;
+  void release(QueuedMessage& message);
+  void dropAll();
+  void updateQueueDepth();
+  void reportFailed(const FailedTokens& failed);
+
   static void mqttConnectionCb(mqtt_client_t* client, void* arg, mqtt_connection_status_t status);
   static void mqttIncomingPublishCb(void* arg, const char* topic, uint32_t tot_len);
   static void mqttIncomingDataCb(void* arg, const uint8_t* data, uint16_t len, uint8_t flags);
+  static void mqttSentCb(void* arg, err_t result);
+  static void mqttAckCb(void* arg, err_t result);
 
   mqtt_client_t* client_ = nullptr;
   std::string    host_;
@@ -43,10 +107,18 @@ class MqttTransport final
   std::string    user_;
   std::string    pass_;
 
-  bool            connected_ = false;
-  ConnectCallback connectCb_;
-  MessageCallback messageCb_;
+  bool             connected_ = false;
+  ConnectCallback  connectCb_;
+  MessageCallback  messageCb_;
+  DeliveryCallback deliveryCb_;
 
   std::string incomingTopic_;
   std::string incomingPayload_;
+
+  SemaphoreHandle_t                                           queueMutex_  = nullptr;
+  std::array<QueuedMessage, Config::MQTT::PUBLISH_QUEUE_SIZE> queue_       = {};
+  size_t                                                      queued_      = 0;
+  uint32_t                                                    sequence_    = 0;
+  std::atomic<uint32_t>                                       inFlight_    = 0;
+  std::array<Completion, Config::MQTT::PUBLISH_IN_FLIGHT>     completions_ = {};
 };
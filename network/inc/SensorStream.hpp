@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <FreeRTOS.h>
+#include <lwip/api.h>
+#include <semphr.h>
+#include <task.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class SensorStream final
+{
+public:
+  SensorStream() = default;
+  ~SensorStream();
+
+  SensorStream(const SensorStream&)                    = delete;
+  auto operator=(const SensorStream&) -> SensorStream& = delete;
+  SensorStream(SensorStream&&)                         = delete;
+  auto operator=(SensorStream&&) -> SensorStream&      = delete;
+
+  auto start() -> bool;
+  void stop();
+
+  auto attach(netconn* client) -> bool;
+  auto hasCapacity() -> bool;
+
+private:
+  static void streamTask(void* params);
+
+  void run();
+  void broadcast(const char* data, size_t size);
+
+  SemaphoreHandle_t mutex_ = nullptr;
+  TaskHandle_t      task_  = nullptr;
+
+  std::atomic<bool> running_    = false;
+  std::atomic<bool> taskActive_ = false;
+
+  std::array<netconn*, Config::Http::MAX_STREAM_CLIENTS> clients_ = {};
+};
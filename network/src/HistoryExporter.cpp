@@ -0,0 +1,453 @@
+#include "HistoryExporter.hpp"
+
+#include "Format.hpp"
+#include "HistoryStore.hpp"
+#include "HttpServer.hpp"
+#include "PackedSensorRecord.hpp"
+#include "RollupStore.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+namespace
+{
+
+inline constexpr uint32_t DEFAULT_RANGE_S = 86'400;
+inline constexpr size_t   MAX_ROW_BYTES   = 256;
+inline constexpr size_t   ROLLUP_VALUES   = 3;
+
+struct FieldFormat
+{
+  std::string_view name;
+  uint32_t         decimals;
+};
+
+// Decimals match the PackedSensorRecord scales, so CSV values are exact.
+inline constexpr std::array<FieldFormat, PackedSensorRecord::FIELD_COUNT> FIELDS = {
+  {
+   {"temperature", 2},
+   {"humidity", 2},
+   {"pressure", 1},
+   {"soil", 2},
+   {"water", 2},
+   {"lux", 0},
+   }
+};
+
+inline constexpr uint8_t                                ALL_FIELDS      = (1U << FIELDS.size()) - 1U;
+inline constexpr std::array<char, 4>                    BINARY_MAGIC    = {'S', 'P', 'H', '1'};
+inline constexpr std::array<const char*, ROLLUP_VALUES> ROLLUP_SUFFIXES = {"_min", "_mean", "_max"};
+inline constexpr const char*                            CSV_TYPE        = "text/csv; charset=utf-8";
+inline constexpr const char*                            BINARY_TYPE     = "application/octet-stream";
+
+enum class Encoding : uint8_t
+{
+  CSV,
+  BINARY,
+};
+
+struct HistoryQuery
+{
+  uint32_t from     = 0;
+  uint32_t to       = 0;
+  uint32_t step     = 0;
+  uint8_t  fields   = ALL_FIELDS;
+  Encoding encoding = Encoding::CSV;
+};
+
+struct Layout
+{
+  Encoding encoding   = Encoding::CSV;
+  uint32_t resolution = RollupStore::RAW;
+  uint8_t  fields     = ALL_FIELDS;
+  size_t   values     = 1;
+};
+
+auto parseNumber(const std::string_view text, uint32_t& value) -> bool
+{
+  const auto* last     = text.data() + text.size();
+  const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+  return (ec == std::errc{}) and (ptr == last);
+}
+
+// Absolute history seconds, or seconds before now when prefixed with '-'.
+auto parseTime(std::string_view text, const uint32_t now, uint32_t& time) -> bool
+{
+  const auto relative = text.starts_with('-');
+  if (relative)
+  {
+    text.remove_prefix(1);
+  }
+  uint32_t value = 0;
+  if (not parseNumber(text, value))
+  {
+    return false;
+  }
+  time = relative ? ((value < now) ? now - value : 0) : value;
+  return true;
+}
+
+auto parseFields(std::string_view text, uint8_t& fields) -> bool
+{
+  if (text == "all")
+  {
+    fields = ALL_FIELDS;
+    return true;
+  }
+
+  fields = 0;
+  while (not text.empty())
+  {
+    const auto separator = text.find(',');
+    const auto name      = text.substr(0, separator);
+    text                 = (separator == std::string_view::npos) ? std::string_view{} : text.substr(separator + 1);
+
+    const auto matches = [name](const FieldFormat& field) { return field.name == name; };
+    const auto field   = std::ranges::find_if(FIELDS, matches);
+    if (field == FIELDS.end())
+    {
+      return false;
+    }
+    fields |= static_cast<uint8_t>(1U << static_cast<uint32_t>(field - FIELDS.begin()));
+  }
+  return fields != 0;
+}
+
+auto parseEncoding(const std::string_view text, Encoding& encoding) -> bool
+{
+  if (text == "csv")
+  {
+    encoding = Encoding::CSV;
+    return true;
+  }
+  if (text == "bin")
+  {
+    encoding = Encoding::BINARY;
+    return true;
+  }
+  return false;
+}
+
+auto parseQuery(std::string_view query, const uint32_t now) -> std::optional<HistoryQuery>
+{
+  HistoryQuery result;
+  result.to    = now;
+  auto hasFrom = false;
+  while (not query.empty())
+  {
+    const auto separator = query.find('&');
+    const auto pair      = query.substr(0, separator);
+    query                = (separator == std::string_view::npos) ? std::string_view{} : query.substr(separator + 1);
+
+    const auto equals = pair.find('=');
+    const auto key    = pair.substr(0, equals);
+    const auto value  = (equals == std::string_view::npos) ? std::string_view{} : pair.substr(equals + 1);
+
+    auto valid = true;
+    if (key == "from")
+    {
+      valid   = parseTime(value, now, result.from);
+      hasFrom = true;
+    }
+    else if (key == "to")
+    {
+      valid = parseTime(value, now, result.to);
+    }
+    else if (key == "step")
+    {
+      valid = parseNumber(value, result.step);
+    }
+    else if (key == "field")
+    {
+      valid = parseFields(value, result.fields);
+    }
+    else if (key == "format")
+    {
+      valid = parseEncoding(value, result.encoding);
+    }
+    if (not valid) [[unlikely]]
+    {
+      return std::nullopt;
+    }
+  }
+
+  if (not hasFrom)
+  {
+    result.from = (result.to > DEFAULT_RANGE_S) ? result.to - DEFAULT_RANGE_S : 0;
+  }
+  if (result.from > result.to) [[unlikely]]
+  {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// Appends one CSV or binary row into a span reserved from the chunk buffer; output past the end is dropped.
+class RowBuilder final
+{
+public:
+  explicit RowBuilder(const std::span<char> out) : out_(out)
+  {
+  }
+
+  void text(const std::string_view value)
+  {
+    for (const auto c : value)
+    {
+      put(c);
+    }
+  }
+
+  void number(const uint64_t value)
+  {
+    length_ += Format::formatUnsigned(out_.subspan(length_), value);
+  }
+
+  void fixed(const int32_t value, const uint32_t decimals)
+  {
+    const auto scale     = Format::POWERS_OF_TEN.at(decimals);
+    const auto magnitude = static_cast<uint32_t>((value < 0) ? -static_cast<int64_t>(value) : value);
+    if (value < 0)
+    {
+      put('-');
+    }
+    number(magnitude / scale);
+    if (decimals == 0)
+    {
+      return;
+    }
+    put('.');
+    auto fraction = magnitude % scale;
+    for (auto digit = scale / 10; digit > 0; digit /= 10)
+    {
+      put(static_cast<char>('0' + (fraction / digit)));
+      fraction %= digit;
+    }
+  }
+
+  template <typename T>
+  void little(const T value)
+  {
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+      put(static_cast<char>((static_cast<uint32_t>(value) >> (8U * i)) & 0xFFU));
+    }
+  }
+
+  auto length() const -> size_t
+  {
+    return length_;
+  }
+
+private:
+  void put(const char c)
+  {
+    if (length_ < out_.size())
+    {
+      out_[length_++] = c;
+    }
+  }
+
+  std::span<char> out_;
+  size_t          length_ = 0;
+};
+
+class ChunkWriter final
+{
+public:
+  explicit ChunkWriter(HttpResponse& response) : response_(response)
+  {
+  }
+
+  // Room for at least one row, flushing buffered rows to the socket first when needed.
+  auto reserve() -> std::span<char>
+  {
+    if ((buffer_.size() - length_) < MAX_ROW_BYTES)
+    {
+      flush();
+    }
+    return std::span(buffer_).subspan(length_);
+  }
+
+  void commit(const size_t bytes)
+  {
+    length_ += bytes;
+  }
+
+  auto failed() const -> bool
+  {
+    return failed_;
+  }
+
+  auto finish() -> bool
+  {
+    flush();
+    return not failed_ and response_.endChunked();
+  }
+
+private:
+  void flush()
+  {
+    if ((length_ > 0) and not failed_)
+    {
+      failed_ = not response_.writeChunk({buffer_.data(), length_});
+    }
+    length_ = 0;
+  }
+
+  HttpResponse&                       response_;
+  std::array<char, 2 * MAX_ROW_BYTES> buffer_{};
+  size_t                              length_ = 0;
+  bool                                failed_ = false;
+};
+
+auto selected(const Layout& layout, const size_t field) -> bool
+{
+  return (layout.fields & (1U << field)) != 0;
+}
+
+auto rowBytes(const Layout& layout) -> size_t
+{
+  const auto fieldCount = static_cast<size_t>(std::popcount(layout.fields));
+  return sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t) + (fieldCount * layout.values * sizeof(int16_t));
+}
+
+// Binary stream: "SPH1", u32 resolution, u8 field mask, u8 values per field, u16 row size, then rows of u32 time,
+// u16 sample count, u8 validity flags and i16 values (min/mean/max per rollup field, one per raw field); all LE.
+void writeHeader(ChunkWriter& out, const Layout& layout)
+{
+  RowBuilder row(out.reserve());
+  if (layout.encoding == Encoding::BINARY)
+  {
+    row.text({BINARY_MAGIC.data(), BINARY_MAGIC.size()});
+    row.little(layout.resolution);
+    row.little(layout.fields);
+    row.little(static_cast<uint8_t>(layout.values));
+    row.little(static_cast<uint16_t>(rowBytes(layout)));
+    out.commit(row.length());
+    return;
+  }
+
+  row.text((layout.values == 1) ? "time" : "time,count");
+  for (size_t i = 0; i < FIELDS.size(); ++i)
+  {
+    if (not selected(layout, i))
+    {
+      continue;
+    }
+    for (size_t v = 0; v < layout.values; ++v)
+    {
+      row.text(",");
+      row.text(FIELDS.at(i).name);
+      row.text((layout.values == 1) ? "" : ROLLUP_SUFFIXES.at(v));
+    }
+  }
+  row.text(",watering\n");
+  out.commit(row.length());
+}
+
+void writeRow(ChunkWriter& out, const Layout& layout, const RollupBucket& bucket)
+{
+  // Raw samples carry one value per field, rollups min/mean/max.
+  const std::array<const PackedSensorRecord*, ROLLUP_VALUES> rollup = {&bucket.min, &bucket.mean, &bucket.max};
+  const auto values = [&rollup, &layout](const size_t v) -> const PackedSensorRecord&
+  {
+    return *rollup.at((layout.values == 1) ? 1 : v);
+  };
+
+  RowBuilder row(out.reserve());
+  if (layout.encoding == Encoding::BINARY)
+  {
+    row.little(bucket.start);
+    row.little(static_cast<uint16_t>(std::min<uint32_t>(bucket.count, std::numeric_limits<uint16_t>::max())));
+    row.little(bucket.mean.flags);
+  }
+  else
+  {
+    row.number(bucket.start);
+    if (layout.values > 1)
+    {
+      row.text(",");
+      row.number(bucket.count);
+    }
+  }
+
+  for (size_t i = 0; i < FIELDS.size(); ++i)
+  {
+    if (not selected(layout, i))
+    {
+      continue;
+    }
+    const auto valid = bucket.mean.has(PackedSensorRecord::fieldFlag(i));
+    for (size_t v = 0; v < layout.values; ++v)
+    {
+      const auto value = values(v).field(i);
+      if (layout.encoding == Encoding::BINARY)
+      {
+        row.little(static_cast<uint16_t>(valid ? value : 0));
+        continue;
+      }
+      row.text(",");
+      if (valid)
+      {
+        row.fixed(value, FIELDS.at(i).decimals);
+      }
+    }
+  }
+
+  if (layout.encoding == Encoding::CSV)
+  {
+    row.text(bucket.mean.watering() ? ",1\n" : ",0\n");
+  }
+  out.commit(row.length());
+}
+
+}  // namespace
+
+auto HistoryExporter::serve(const std::string_view query, HttpResponse& response) -> bool
+{
+  const auto parsed = parseQuery(query, HistoryStore::getInstance().now());
+  if (not parsed.has_value()) [[unlikely]]
+  {
+    return response.send("Invalid history query", "text/plain", "400 Bad Request");
+  }
+
+  auto&      rollups    = RollupStore::getInstance();
+  const auto resolution = rollups.resolutionFor(parsed->from, parsed->step);
+  const Layout layout{
+    .encoding   = parsed->encoding,
+    .resolution = resolution,
+    .fields     = parsed->fields,
+    .values     = (resolution == RollupStore::RAW) ? size_t{1} : ROLLUP_VALUES,
+  };
+
+  std::array<char, 12> resolutionText{};
+  const auto           length = Format::formatUnsigned(resolutionText, resolution);
+  response.addHeader("Cache-Control", "no-cache");
+  response.addHeader("X-History-Resolution", {resolutionText.data(), length});
+  if (not response.beginChunked((layout.encoding == Encoding::BINARY) ? BINARY_TYPE : CSV_TYPE)) [[unlikely]]
+  {
+    return false;
+  }
+
+  ChunkWriter out(response);
+  writeHeader(out, layout);
+  const auto stream = [&out, &layout](const RollupBucket& bucket)
+  {
+    writeRow(out, layout, bucket);
+    return not out.failed();
+  };
+  const auto rows = rollups.forEach(resolution, parsed->from, parsed->to, stream);
+  printf("[History] Served %zu rows at %lus resolution\n", rows, static_cast<unsigned long>(resolution));
+  return out.finish();
+}
@@ -0,0 +1,208 @@
+#include "HomeAssistantDiscovery.hpp"
+
+#include "Config.hpp"
+#include "Crc32.hpp"
+#include "JsonWriter.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+namespace
+{
+
+using HomeAssistantDiscovery::Component;
+using HomeAssistantDiscovery::COMPONENTS;
+
+inline constexpr std::string_view IDENTIFIER      = Config::System::IDENTIFIER;
+inline constexpr size_t           MAX_BASE_ESCAPE = 96;
+
+struct UniqueId
+{
+  std::array<char, 64> text   = {};
+  size_t               length = 0;
+
+  constexpr auto view() const -> std::string_view
+  {
+    return {text.data(), length};
+  }
+};
+
+constexpr auto uniqueIdOf(const Component& component) -> UniqueId
+{
+  UniqueId id;
+  for (const auto ch : IDENTIFIER)
+  {
+    id.text.at(id.length++) = ch;
+  }
+  id.text.at(id.length++) = '_';
+  for (const auto ch : component.objectId)
+  {
+    id.text.at(id.length++) = ch;
+  }
+  return id;
+}
+
+constexpr void writeComponent(JsonWriter& json, const Component& component, const bool withPlatform)
+{
+  const auto optional = [&json](const std::string_view key, const std::string_view value)
+  {
+    if (not value.empty())
+    {
+      json.field(key, value);
+    }
+  };
+
+  if (withPlatform)
+  {
+    json.field("p", component.platform);
+  }
+  json.field("name", component.name).field("uniq_id", uniqueIdOf(component).view());
+  optional("stat_t", component.stateTopic);
+  optional("cmd_t", component.commandTopic);
+  optional("val_tpl", component.valueTemplate);
+  optional("unit_of_meas", component.unit);
+  optional("dev_cla", component.deviceClass);
+  if (not component.options.empty())
+  {
+    json.key("options").raw(component.options);
+  }
+  if (component.max > component.min)
+  {
+    json.field("min", component.min).field("max", component.max);
+  }
+}
+
+constexpr void writeShared(JsonWriter& json)
+{
+  json.field("avty_t", "~/availability");
+  json.key("dev")
+    .beginObject()
+    .field("ids", IDENTIFIER)
+    .field("name", Config::System::NAME)
+    .field("sw", Config::System::VERSION)
+    .endObject();
+}
+
+struct DeviceTemplate
+{
+  std::array<char, Config::MQTT::DISCOVERY_PAYLOAD_SIZE> text   = {};
+  size_t                                                 length = 0;
+  bool                                                   ok     = false;
+};
+
+consteval auto buildDeviceTemplate() -> DeviceTemplate
+{
+  DeviceTemplate result;
+  JsonWriter     json(result.text);
+  json.beginObject();
+  writeShared(json);
+  json.key("o").beginObject().field("name", IDENTIFIER).field("sw", Config::System::VERSION).endObject();
+  json.key("cmps").beginObject();
+  for (const auto& component : COMPONENTS)
+  {
+    json.key(component.objectId).beginObject();
+    writeComponent(json, component, true);
+    json.endObject();
+  }
+  json.endObject().endObject();
+
+  result.length = json.size();
+  result.ok     = json.ok();
+  return result;
+}
+
+inline constexpr auto DEVICE_TEMPLATE = buildDeviceTemplate();
+
+static_assert(DEVICE_TEMPLATE.ok and ((DEVICE_TEMPLATE.length + MAX_BASE_ESCAPE) <= DEVICE_TEMPLATE.text.size()),
+              "Device discovery payload must fit DISCOVERY_PAYLOAD_SIZE with room for the base topic");
+
+// Members of the template object, spliced in after the runtime "~" base topic.
+inline constexpr auto DEVICE_MEMBERS = std::string_view(DEVICE_TEMPLATE.text.data() + 1, DEVICE_TEMPLATE.length - 2);
+
+template <typename... Args>
+auto formatTopic(const std::span<char> out, const char* const format, const Args... args) -> std::string_view
+{
+  const auto written = std::snprintf(out.data(), out.size(), format, args...);
+  if ((written < 0) or (static_cast<size_t>(written) >= out.size())) [[unlikely]]
+  {
+    return {};
+  }
+  return {out.data(), static_cast<size_t>(written)};
+}
+
+// Length-prefixed, so moving characters between adjacent strings changes the result.
+auto mix(const uint32_t crc, const std::string_view text) -> uint32_t
+{
+  const auto length = static_cast<uint32_t>(text.size());
+  return Crc32::compute(text.data(), text.size(), Crc32::compute(&length, sizeof(length), crc));
+}
+
+}  // namespace
+
+auto HomeAssistantDiscovery::deviceTopic(const std::string_view discoveryPrefix, const std::span<char> out)
+  -> std::string_view
+{
+  return formatTopic(out, "%.*s/device/%s/config", static_cast<int>(discoveryPrefix.size()), discoveryPrefix.data(),
+                     Config::System::IDENTIFIER);
+}
+
+auto HomeAssistantDiscovery::deviceConfig(const std::string_view baseTopic, const std::span<char> out)
+  -> std::string_view
+{
+  JsonWriter json(out);
+  json.beginObject().field("~", baseTopic).raw(DEVICE_MEMBERS).endObject();
+  return json.view();
+}
+
+auto HomeAssistantDiscovery::entityTopic(const Component& component, const std::string_view discoveryPrefix,
+                                         const std::span<char> out) -> std::string_view
+{
+  const auto prefix   = static_cast<int>(discoveryPrefix.size());
+  const auto platform = static_cast<int>(component.platform.size());
+  const auto objectId = static_cast<int>(component.objectId.size());
+  if (component.bareNode)
+  {
+    return formatTopic(out, "%.*s/%.*s/%.*s/config", prefix, discoveryPrefix.data(), platform,
+                       component.platform.data(), objectId, component.objectId.data());
+  }
+  return formatTopic(out, "%.*s/%.*s/%s_%.*s/config", prefix, discoveryPrefix.data(), platform,
+                     component.platform.data(), Config::System::IDENTIFIER, objectId, component.objectId.data());
+}
+
+auto HomeAssistantDiscovery::entityConfig(const Component& component, const std::string_view baseTopic,
+                                          const std::span<char> out) -> std::string_view
+{
+  JsonWriter json(out);
+  json.beginObject().field("~", baseTopic);
+  writeComponent(json, component, false);
+  writeShared(json);
+  json.endObject();
+  return json.view();
+}
+
+// Entity configs are built from the same component fields as the device template, so hashing the template and the
+// topics of the active mode covers both.
+auto HomeAssistantDiscovery::fingerprint(const std::string_view discoveryPrefix, const std::string_view baseTopic,
+                                         const std::string_view brokerHost, const uint16_t brokerPort) -> uint32_t
+{
+  std::array<char, Config::MQTT::QUEUE_TOPIC_SIZE> topic{};
+
+  auto crc = Crc32::compute(&brokerPort, sizeof(brokerPort), mix(0, brokerHost));
+  crc      = mix(mix(crc, baseTopic), DEVICE_MEMBERS);
+  if constexpr (Config::MQTT::DEVICE_DISCOVERY)
+  {
+    crc = mix(crc, deviceTopic(discoveryPrefix, topic));
+  }
+  else
+  {
+    for (const auto& component : COMPONENTS)
+    {
+      crc = mix(crc, entityTopic(component, discoveryPrefix, topic));
+    }
+  }
+  return (crc == NEVER_PUBLISHED) ? crc + 1 : crc;
+}
@@ -0,0 +1,640 @@
+#include "HttpServer.hpp"
+
+#include "Common.hpp"
+#include "Config.hpp"
+#include "TaskConfig.hpp"
+
+#include <FreeRTOS.h>
+#include <lwip/api.h>
+#include <lwip/err.h>
+#include <lwip/ip.h>
+#include <lwip/netbuf.h>
+#include <lwip/tcp.h>
+#include <lwip/tcpip.h>
+#include <projdefs.h>
+#include <queue.h>
+#include <task.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+
+inline constexpr std::string_view HEADER_END = "\r\n\r\n";
+inline constexpr std::string_view LINE_END   = "\r\n";
+inline constexpr size_t           MAX_CHUNK  = 512;
+
+auto equalsIgnoreCase(const std::string_view lhs, const std::string_view rhs) -> bool
+{
+  const auto lower = [](const char ch) { return ((ch >= 'A') and (ch <= 'Z')) ? static_cast<char>(ch + 32) : ch; };
+  return std::ranges::equal(lhs, rhs, [&lower](const char a, const char b) { return lower(a) == lower(b); });
+}
+
+auto trim(std::string_view text) -> std::string_view
+{
+  while (not text.empty() and ((text.front() == ' ') or (text.front() == '\t')))
+  {
+    text.remove_prefix(1);
+  }
+  while (not text.empty() and ((text.back() == ' ') or (text.back() == '\t')))
+  {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+auto writeAll(netconn* const connection, const void* const data, size_t size, const uint8_t flags) -> bool
+{
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0)
+  {
+    size_t     written = 0;
+    const auto err     = netconn_write_partly(connection, bytes, size, flags, &written);
+    if (err != ERR_OK) [[unlikely]]
+    {
+      printf("[HTTP] write failed (%d) with %zu bytes left\n", err, size);
+      return false;
+    }
+    bytes += written;
+    size  -= written;
+  }
+  return true;
+}
+
+void closeConnection(netconn* const connection)
+{
+  netconn_close(connection);
+  netconn_delete(connection);
+}
+
+}  // namespace
+
+auto HttpRequest::header(const std::string_view name) const -> std::string_view
+{
+  auto remaining = headers;
+  while (not remaining.empty())
+  {
+    const auto lineEnd = remaining.find(LINE_END);
+    const auto line    = remaining.substr(0, lineEnd);
+    const auto colon   = line.find(':');
+    if ((colon != std::string_view::npos) and equalsIgnoreCase(trim(line.substr(0, colon)), name))
+    {
+      return trim(line.substr(colon + 1));
+    }
+    if (lineEnd == std::string_view::npos)
+    {
+      break;
+    }
+    remaining.remove_prefix(lineEnd + LINE_END.size());
+  }
+  return {};
+}
+
+HttpResponse::HttpResponse(netconn* const connection, const bool keepAlive, const bool chunkedAllowed)
+  : connection_(connection), keepAlive_(keepAlive), chunkedAllowed_(chunkedAllowed)
+{
+}
+
+auto HttpResponse::addHeader(const std::string_view name, const std::string_view value) -> bool
+{
+  const auto length = name.size() + value.size() + 4;
+  if (sent_ or ((extraLength_ + length) > extraHeaders_.size())) [[unlikely]]
+  {
+    return false;
+  }
+  auto* out = extraHeaders_.data() + extraLength_;
+  out       = std::ranges::copy(name, out).out;
+  *out++    = ':';
+  *out++    = ' ';
+  out       = std::ranges::copy(value, out).out;
+  *out++    = '\r';
+  *out      = '\n';
+  extraLength_ += length;
+  return true;
+}
+
+auto HttpResponse::send(const std::string_view body, const char* const contentType, const char* const status) -> bool
+{
+  return sendHead(status, contentType, body.size(), not body.empty()) and
+         (body.empty() or sendBody(body.data(), body.size(), NETCONN_COPY));
+}
+
+auto HttpResponse::sendStatic(const std::span<const uint8_t> body, const char* const contentType,
+                              const char* const status) -> bool
+{
+  return sendHead(status, contentType, body.size(), not body.empty()) and
+         (body.empty() or sendBody(body.data(), body.size(), NETCONN_NOCOPY));
+}
+
+auto HttpResponse::sendNotModified() -> bool
+{
+  return sendHead("304 Not Modified", nullptr, std::nullopt, false);
+}
+
+auto HttpResponse::beginStream(const char* const contentType) -> bool
+{
+  keepAlive_ = false;
+  return sendHead("200 OK", contentType, std::nullopt, false);
+}
+
+auto HttpResponse::beginChunked(const char* const contentType, const char* const status) -> bool
+{
+  // HTTP/1.0 clients do not understand the chunked coding (RFC 7230 §3.3.1), so their body runs unframed and the
+  // connection close marks its end.
+  chunked_   = true;
+  unframed_  = not chunkedAllowed_;
+  keepAlive_ = keepAlive_ and chunkedAllowed_;
+  return sendHead(status, contentType, std::nullopt, true);
+}
+
+auto HttpResponse::writeChunk(std::string_view data) -> bool
+{
+  if (not chunked_ or not sent_) [[unlikely]]
+  {
+    return false;
+  }
+  if (unframed_)
+  {
+    return data.empty() or sendBody(data.data(), data.size(), NETCONN_COPY | NETCONN_MORE);
+  }
+
+  std::array<char, MAX_CHUNK + 16> frame{};
+  while (not data.empty())
+  {
+    const auto size   = std::min(data.size(), MAX_CHUNK);
+    const auto prefix = static_cast<size_t>(std::snprintf(frame.data(), frame.size(), "%zx\r\n", size));
+    auto       length = prefix + data.copy(frame.data() + prefix, size);
+    frame[length++]   = '\r';
+    frame[length++]   = '\n';
+    if (not sendBody(frame.data(), length, NETCONN_COPY | NETCONN_MORE))
+    {
+      return false;
+    }
+    data.remove_prefix(size);
+  }
+  return true;
+}
+
+auto HttpResponse::endChunked() -> bool
+{
+  if (not chunked_ or not sent_) [[unlikely]]
+  {
+    return false;
+  }
+  if (unframed_)
+  {
+    return true;
+  }
+  constexpr std::string_view LAST_CHUNK = "0\r\n\r\n";
+  return sendBody(LAST_CHUNK.data(), LAST_CHUNK.size(), NETCONN_COPY);
+}
+
+auto HttpResponse::sendHead(const char* const status, const char* const contentType,
+                            const std::optional<size_t> contentLength, const bool hasBody) -> bool
+{
+  if (sent_) [[unlikely]]
+  {
+    return false;
+  }
+  sent_ = true;
+
+  std::array<char, 384> header{};
+  size_t                length = 0;
+  const auto            append = [&header, &length](const char* const format, const auto... args)
+  {
+    if (length < header.size())
+    {
+      const auto count  = std::snprintf(header.data() + length, header.size() - length, format, args...);
+      length           += (count > 0) ? static_cast<size_t>(count) : header.size();
+    }
+  };
+
+  append("HTTP/1.1 %s\r\n", status);
+  if (contentType != nullptr)
+  {
+    append("Content-Type: %s\r\n", contentType);
+  }
+  if (contentLength.has_value())
+  {
+    append("Content-Length: %zu\r\n", *contentLength);
+  }
+  if (chunked_ and not unframed_)
+  {
+    append("Transfer-Encoding: chunked\r\n");
+  }
+  append("%.*sConnection: %s\r\n\r\n", static_cast<int>(extraLength_), extraHeaders_.data(),
+         keepAlive_ ? "keep-alive" : "close");
+  if (length >= header.size()) [[unlikely]]
+  {
+    keepAlive_ = false;
+    return false;
+  }
+
+  const auto flags = static_cast<uint8_t>(NETCONN_COPY | (hasBody ? NETCONN_MORE : 0));
+  const auto ok    = writeAll(connection_, header.data(), length, flags);
+  keepAlive_       = keepAlive_ and ok;
+  return ok;
+}
+
+auto HttpResponse::sendBody(const void* const data, const size_t size, const uint8_t flags) -> bool
+{
+  const auto ok = writeAll(connection_, data, size, flags);
+  keepAlive_    = keepAlive_ and ok;
+  return ok;
+}
+
+void HttpResponse::closeAfterResponse()
+{
+  keepAlive_ = false;
+}
+
+auto HttpResponse::detach() -> netconn*
+{
+  if (not sent_ or detached_) [[unlikely]]
+  {
+    return nullptr;
+  }
+  detached_  = true;
+  keepAlive_ = false;
+  return connection_;
+}
+
+auto HttpResponse::keepAlive() const -> bool
+{
+  return keepAlive_;
+}
+
+auto HttpResponse::sent() const -> bool
+{
+  return sent_;
+}
+
+auto HttpResponse::detached() const -> bool
+{
+  return detached_;
+}
+
+HttpServer::~HttpServer()
+{
+  stop();
+}
+
+auto HttpServer::start(const uint16_t port, Handler handler) -> bool
+{
+  if (running_)
+  {
+    return true;
+  }
+
+  listener_ = netconn_new(NETCONN_TCP);
+  if (listener_ == nullptr) [[unlikely]]
+  {
+    printf("[HTTP] Listener create failed\n");
+    return false;
+  }
+
+  LOCK_TCPIP_CORE();
+  ip_set_option(listener_->pcb.ip, SOF_REUSEADDR);
+  UNLOCK_TCPIP_CORE();
+
+  if ((netconn_bind(listener_, IP_ADDR_ANY, port) != ERR_OK) or
+      (netconn_listen_with_backlog(listener_, Config::Http::MAX_PENDING_CONNECTIONS) != ERR_OK)) [[unlikely]]
+  {
+    printf("[HTTP] Failed to listen on port %u\n", port);
+    netconn_delete(listener_);
+    listener_ = nullptr;
+    return false;
+  }
+  netconn_set_recvtimeout(listener_, static_cast<int32_t>(Config::Http::ACCEPT_POLL_MS));
+
+  pending_ = xQueueCreate(Config::Http::MAX_PENDING_CONNECTIONS, sizeof(netconn*));
+  if (pending_ == nullptr) [[unlikely]]
+  {
+    printf("[HTTP] Failed to create connection queue\n");
+    netconn_delete(listener_);
+    listener_ = nullptr;
+    return false;
+  }
+
+  handler_ = std::move(handler);
+  running_ = true;
+
+  auto ok = true;
+  for (auto& worker : workers_)
+  {
+    worker.server = this;
+    ++activeTasks_;
+    if (xTaskCreate(workerTask, "httpWorker", HTTP_WORKER_STACK, &worker, HTTP_WORKER_PRIORITY, &worker.task) !=
+        pdPASS) [[unlikely]]
+    {
+      --activeTasks_;
+      worker.task = nullptr;
+      ok          = false;
+    }
+  }
+
+  ++activeTasks_;
+  if (xTaskCreate(acceptTask, "httpAccept", HTTP_ACCEPT_STACK, this, HTTP_ACCEPT_PRIORITY, &acceptTask_) != pdPASS)
+    [[unlikely]]
+  {
+    --activeTasks_;
+    acceptTask_ = nullptr;
+    ok          = false;
+  }
+
+  if (not ok) [[unlikely]]
+  {
+    printf("[HTTP] Failed to create server tasks\n");
+    stop();
+    return false;
+  }
+
+  printf("[HTTP] Listening on port %u with %zu workers\n", port, workers_.size());
+  return true;
+}
+
+void HttpServer::stop()
+{
+  if (not running_.exchange(false))
+  {
+    return;
+  }
+
+  while (activeTasks_.load() > 0)
+  {
+    Utils::delayMs(10);
+  }
+
+  netconn* client = nullptr;
+  while (xQueueReceive(pending_, &client, 0) == pdPASS)
+  {
+    closeConnection(client);
+  }
+
+  closeConnection(listener_);
+  listener_ = nullptr;
+  vQueueDelete(pending_);
+  pending_    = nullptr;
+  acceptTask_ = nullptr;
+  for (auto& worker : workers_)
+  {
+    worker.task = nullptr;
+  }
+  handler_ = nullptr;
+  printf("[HTTP] Server stopped\n");
+}
+
+auto HttpServer::isRunning() const -> bool
+{
+  return running_;
+}
+
+void HttpServer::acceptTask(void* const params)
+{
+  auto* server = static_cast<HttpServer*>(params);
+  server->acceptLoop();
+  --server->activeTasks_;
+  vTaskDelete(nullptr);
+}
+
+void HttpServer::workerTask(void* const params)
+{
+  auto* worker = static_cast<Worker*>(params);
+  auto* server = worker->server;
+  while (server->running_)
+  {
+    netconn* client = nullptr;
+    if (xQueueReceive(server->pending_, &client, pdMS_TO_TICKS(Config::Http::ACCEPT_POLL_MS)) == pdPASS)
+    {
+      server->serveConnection(client, worker->buffer);
+    }
+  }
+  --server->activeTasks_;
+  vTaskDelete(nullptr);
+}
+
+void HttpServer::acceptLoop()
+{
+  while (running_)
+  {
+    netconn* client = nullptr;
+    if (netconn_accept(listener_, &client) != ERR_OK)
+    {
+      continue;
+    }
+
+    if (xQueueSend(pending_, &client, 0) != pdPASS) [[unlikely]]
+    {
+      printf("[HTTP] Connection limit reached, rejecting client\n");
+      closeConnection(client);
+    }
+  }
+}
+
+void HttpServer::serveConnection(netconn* const client, const std::span<char> buffer)
+{
+  LOCK_TCPIP_CORE();
+  tcp_nagle_disable(client->pcb.tcp);
+  UNLOCK_TCPIP_CORE();
+  netconn_set_recvtimeout(client, static_cast<int32_t>(Config::Http::IDLE_POLL_MS));
+  netconn_set_sendtimeout(client, static_cast<int32_t>(Config::Http::SEND_TIMEOUT_MS));
+
+  Connection connection{.conn = client};
+  auto       detached = false;
+  for (uint32_t served = 1; running_; ++served)
+  {
+    HttpRequest request;
+    const auto  consumed = readRequest(connection, buffer, request);
+    if (consumed == 0)
+    {
+      break;
+    }
+
+    const auto keepAlive = request.keepAlive and running_ and (served < Config::Http::MAX_KEEP_ALIVE_REQUESTS) and
+                           not shouldYieldConnection();
+    HttpResponse response(client, keepAlive, request.version == "HTTP/1.1");
+    handler_(request, response);
+    if (response.detached())
+    {
+      detached = true;
+      break;
+    }
+    if (not response.sent())
+    {
+      response.send("Not Found", "text/plain", "404 Not Found");
+    }
+    if (not response.keepAlive())
+    {
+      break;
+    }
+
+    connection.buffered -= consumed;
+    std::memmove(buffer.data(), buffer.data() + consumed, connection.buffered);
+  }
+
+  if (connection.pending != nullptr)
+  {
+    netbuf_delete(connection.pending);
+  }
+  if (not detached)
+  {
+    closeConnection(client);
+  }
+}
+
+auto HttpServer::readRequest(Connection& connection, const std::span<char> buffer, HttpRequest& request) -> size_t
+{
+  auto&      buffered     = connection.buffered;
+  const auto receiveUntil = [&](const auto& complete) -> bool
+  {
+    const auto startMs = Utils::getTimeSinceBoot();
+    while (not complete())
+    {
+      if (buffered >= buffer.size()) [[unlikely]]
+      {
+        return false;
+      }
+
+      const auto result = receive(connection, buffer);
+      if (result == ReceiveResult::DATA)
+      {
+        continue;
+      }
+      if (result == ReceiveResult::CLOSED)
+      {
+        return false;
+      }
+
+      const auto idleMs = Utils::getTimeSinceBoot() - startMs;
+      if (buffered == 0)
+      {
+        if (not running_ or (idleMs >= Config::Http::KEEP_ALIVE_TIMEOUT_MS) or shouldYieldConnection())
+        {
+          return false;
+        }
+      }
+      else if (idleMs >= Config::Http::REQUEST_TIMEOUT_MS) [[unlikely]]
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto headerEnd = std::string_view::npos;
+  if (not receiveUntil(
+        [&]
+        {
+          headerEnd = std::string_view(buffer.data(), buffered).find(HEADER_END);
+          return headerEnd != std::string_view::npos;
+        }))
+  {
+    if (buffered >= buffer.size()) [[unlikely]]
+    {
+      HttpResponse(connection.conn, false)
+        .send("Header Too Large", "text/plain", "431 Request Header Fields Too Large");
+    }
+    return 0;
+  }
+
+  const auto head        = std::string_view(buffer.data(), headerEnd);
+  const auto requestLine = head.substr(0, head.find(LINE_END));
+  const auto methodEnd   = requestLine.find(' ');
+  const auto pathEnd =
+    (methodEnd != std::string_view::npos) ? requestLine.find(' ', methodEnd + 1) : std::string_view::npos;
+  if ((methodEnd == std::string_view::npos) or (pathEnd == std::string_view::npos)) [[unlikely]]
+  {
+    HttpResponse(connection.conn, false).send("Bad Request", "text/plain", "400 Bad Request");
+    return 0;
+  }
+
+  const auto target     = requestLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+  const auto queryStart = target.find('?');
+
+  request.method  = requestLine.substr(0, methodEnd);
+  request.path    = target.substr(0, queryStart);
+  request.query   = (queryStart != std::string_view::npos) ? target.substr(queryStart + 1) : "";
+  request.version = requestLine.substr(pathEnd + 1);
+  request.headers = (requestLine.size() < head.size()) ? head.substr(requestLine.size() + LINE_END.size()) : "";
+
+  const auto connectionHeader = request.header("Connection");
+  request.keepAlive           = (request.version == "HTTP/1.1") ? not equalsIgnoreCase(connectionHeader, "close")
+                                                                : equalsIgnoreCase(connectionHeader, "keep-alive");
+
+  size_t     contentLength = 0;
+  const auto lengthValue   = request.header("Content-Length");
+  if (not lengthValue.empty())
+  {
+    const auto* last     = lengthValue.data() + lengthValue.size();
+    const auto [ptr, ec] = std::from_chars(lengthValue.data(), last, contentLength);
+    if ((ec != std::errc{}) or (ptr != last)) [[unlikely]]
+    {
+      HttpResponse(connection.conn, false).send("Bad Request", "text/plain", "400 Bad Request");
+      return 0;
+    }
+  }
+
+  const auto bodyStart = headerEnd + HEADER_END.size();
+  if (contentLength > (buffer.size() - bodyStart)) [[unlikely]]
+  {
+    HttpResponse(connection.conn, false).send("Payload Too Large", "text/plain", "413 Payload Too Large");
+    return 0;
+  }
+
+  const auto total = bodyStart + contentLength;
+  if (not receiveUntil([&] { return buffered >= total; })) [[unlikely]]
+  {
+    return 0;
+  }
+
+  request.body = std::string_view(buffer.data() + bodyStart, contentLength);
+  return total;
+}
+
+auto HttpServer::receive(Connection& connection, const std::span<char> buffer) -> ReceiveResult
+{
+  if (connection.pending == nullptr)
+  {
+    const auto err = netconn_recv(connection.conn, &connection.pending);
+    if (err == ERR_TIMEOUT)
+    {
+      return ReceiveResult::TIMEOUT;
+    }
+    if (err != ERR_OK)
+    {
+      connection.pending = nullptr;
+      return ReceiveResult::CLOSED;
+    }
+    connection.pendingOffset = 0;
+  }
+
+  const auto available = static_cast<size_t>(netbuf_len(connection.pending) - connection.pendingOffset);
+  const auto count     = std::min(available, buffer.size() - connection.buffered);
+  netbuf_copy_partial(connection.pending, buffer.data() + connection.buffered, static_cast<uint16_t>(count),
+                      connection.pendingOffset);
+  connection.buffered      += count;
+  connection.pendingOffset += static_cast<uint16_t>(count);
+
+  if (connection.pendingOffset >= netbuf_len(connection.pending))
+  {
+    netbuf_delete(connection.pending);
+    connection.pending = nullptr;
+  }
+  return ReceiveResult::DATA;
+}
+
+auto HttpServer::shouldYieldConnection() const -> bool
+{
+  return uxQueueMessagesWaiting(pending_) > 0;
+}
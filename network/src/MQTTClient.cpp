@@ -1,11 +1,18 @@
 #include "MQTTClient.hpp"
 
 #include "Config.hpp"
+#include "ConfigService.hpp"
+#include "HistoryStore.hpp"
+#include "HomeAssistantDiscovery.hpp"
 #include "IrrigationController.hpp"
+#include "JsonWriter.hpp"
+#include "MqttOutbox.hpp"
+#include "PackedSensorRecord.hpp"
 #include "SensorController.hpp"
+#include "SensorPayloadCache.hpp"
 #include "Types.hpp"
 
-#include <pico/time.h>
+#include <lwip/apps/mqtt_opts.h>
 
 #include <array>
 #include <charconv>
@@ -21,6 +28,20 @@
 namespace
 {
 
+inline constexpr size_t TOPIC_SIZE           = 128;
+inline constexpr size_t BACKLOG_PAYLOAD_SIZE = 320;
+
+// Each backlog sample is a QoS 1 request held in lwIP until acknowledged; a batch must leave most of the output ring
+// and request slots to live state and command traffic.
+static_assert((Config::MQTT::BACKLOG_BATCH * (TOPIC_SIZE + BACKLOG_PAYLOAD_SIZE)) <= (MQTT_OUTPUT_RINGBUF_SIZE / 2),
+              "Backlog batch would crowd the MQTT output ring");
+static_assert((Config::MQTT::BACKLOG_BATCH * 2) <= MQTT_REQ_MAX_IN_FLIGHT, "Backlog batch would exhaust MQTT requests");
+static_assert((TOPIC_SIZE + Config::MQTT::DISCOVERY_PAYLOAD_SIZE) <= MQTT_OUTPUT_RINGBUF_SIZE,
+              "Device discovery message must fit the MQTT output ring");
+
+// Discovery deliveries carry their fingerprint as token, which is never NEVER_PUBLISHED, so backlog takes that value.
+inline constexpr uint32_t BACKLOG_TOKEN = HomeAssistantDiscovery::NEVER_PUBLISHED;
+
 constexpr auto hasValue(const char* const text) -> bool
 {
   return (text != nullptr) and (std::char_traits<char>::length(text) > 0);
@@ -32,68 +53,25 @@ void formatTopic(std::span<char> buffer, const char* fmt, Args... args)
   (void)std::snprintf(buffer.data(), buffer.size(), fmt, args...);
 }
 
-template <size_t N>
-void buildDiscoveryJson(std::array<char, N>& payload, const char* name, const char* uniqueId, const char* cmdTopic,
-                        const char* stateTopic, const char* availabilityTopic, const char* deviceClass = nullptr,
-                        const char* unit = nullptr, const char* valueTemplate = nullptr, const char* options = nullptr,
-                        const char* min = nullptr, const char* max = nullptr)
+auto serializeBacklog(const OutboxEntry& entry, const uint32_t now, const std::span<char> buffer) -> std::string_view
 {
-  int        offset = 0;
-  const auto append = [&](const char* fmt, auto... args) -> void
-  {
-    if (offset < 0)
-    {
-      return;
-    }
-    const auto remaining = std::span(payload).subspan(offset);
-    const auto written   = std::snprintf(remaining.data(), remaining.size(), fmt, args...);
-    if (written < 0 or static_cast<size_t>(written) >= remaining.size())
-    {
-      offset = -1;
-    }
-    else
-    {
-      offset += written;
-    }
-  };
-
-  append(R"({"name":"%s","uniq_id":"%s","avty_t":"%s")", name, uniqueId, availabilityTopic);
+  const auto data = entry.record.toSensorData(0);
 
-  if (cmdTopic)
-  {
-    append(R"(,"cmd_t":"%s")", cmdTopic);
-  }
-  if (stateTopic)
-  {
-    append(R"(,"stat_t":"%s")", stateTopic);
-  }
-  if (deviceClass)
-  {
-    append(R"(,"dev_cla":"%s")", deviceClass);
-  }
-  if (unit)
-  {
-    append(R"(,"unit_of_meas":"%s")", unit);
-  }
-  if (valueTemplate)
-  {
-    append(R"(,"val_tpl":"%s")", valueTemplate);
-  }
-  if (options)
-  {
-    append(R"(,"options":%s)", options);
-  }
-  if (min)
-  {
-    append(R"(,"min":%s)", min);
-  }
-  if (max)
-  {
-    append(R"(,"max":%s)", max);
-  }
-
-  append(R"(,"device":{"ids":["%s"],"name":"%.*s"}})", Config::System::IDENTIFIER,
-         static_cast<int>(Config::System::NAME.size()), Config::System::NAME.data());
+  JsonWriter json(buffer);
+  json.beginObject()
+    .field("time", entry.time)
+    .field("age", now - entry.time)
+    .field("temperature", data.environment.temperature, 2)
+    .field("humidity", data.environment.humidity, 2)
+    .field("pressure", data.environment.pressure, 2)
+    .field("soil_moisture", data.soil.percentage, 2)
+    .field("light_lux", data.light.isValid() ? data.light.lux : 0.0F, 2)
+    .field("light_available", data.light.isValid())
+    .field("water_level", data.water.isValid() ? data.water.percentage : 0.0F, 2)
+    .field("water_level_available", data.water.isValid())
+    .field("watering", entry.record.watering())
+    .endObject();
+  return json.ok() ? json.view() : std::string_view{};
 }
 
 }  // namespace
@@ -147,6 +125,15 @@ void MQTTClient::clearUpdateRequest()
 
 auto MQTTClient::init(const MqttConfig& config) -> bool
 {
+  if (transport_.isConnected() and (config_ != config))
+  {
+    printf("[MQTTClient] Broker settings changed, disconnecting\n");
+    publishAvailability(false);
+    transport_.service();
+    transport_.disconnect();
+    lastReconnectAttempt_ = 0;
+  }
+
   config_ = config;
   if (not config_.enabled)
   {
@@ -156,6 +143,8 @@ auto MQTTClient::init(const MqttConfig& config) -> bool
   const auto* base = config_.baseTopic.data();
   formatTopic(availabilityTopic_, "%s/availability", base);
   formatTopic(stateTopic_, "%s/state", base);
+  formatTopic(packedStateTopic_, "%s/state/packed", base);
+  formatTopic(backlogTopic_, "%s/state/backlog", base);
   formatTopic(commandTopic_, "%s/command", base);
   formatTopic(modeCommandTopic_, "%s/mode/set", base);
   formatTopic(modeStateTopic_, "%s/mode/state", base);
@@ -164,6 +153,8 @@ auto MQTTClient::init(const MqttConfig& config) -> bool
   formatTopic(intervalCommandTopic_, "%s/interval/set", base);
   formatTopic(intervalStateTopic_, "%s/interval/state", base);
   formatTopic(activityStateTopic_, "%s/activity/state", base);
+  formatTopic(homeAssistantStatusTopic_, "%s/status", config_.discoveryPrefix.data());
+  discoveryFingerprint_ = ConfigService::getInstance().snapshot().discoveryFingerprint;
 
   printf("[MQTTClient] Initializing MQTT integration...\n");
 
@@ -176,6 +167,8 @@ auto MQTTClient::init(const MqttConfig& config) -> bool
 
   transport_.setOnMessage([this](std::string_view topic, std::string_view payload) -> void
                           { this->handleCommand(topic, payload); });
+  transport_.setOnDelivery([this](const uint32_t token, const bool delivered) -> void
+                           { this->handleDelivery(token, delivered); });
 
   printf("[MQTTClient] MQTT client ready\n");
   return true;
@@ -206,6 +199,9 @@ void MQTTClient::loop(const uint32_t nowMs)
       publishIntervalState();
       needsInitialPublish_ = false;
     }
+    drainBacklog(nowMs);
+    transport_.service();
+    confirmDiscovery();
   }
 }
 
@@ -261,167 +257,229 @@ void MQTTClient::publishSensorState(const uint32_t nowMs, const SensorData& data
   lastData_ = data;
   hasData_  = true;
 
-  if (not isConnected())
+  if (not force and (nowMs - lastPublish_) < config_.publishIntervalMs)
   {
     return;
   }
 
-  if (not force and (nowMs - lastPublish_) < config_.publishIntervalMs)
+  if (not isConnected())
   {
+    queueSample(data, watering);
+    lastPublish_ = nowMs;
     return;
   }
 
-  std::array<char, 256> payload{};
-
-  const auto isLightDataValid = data.light.isValid();
-  const auto isWaterDataValid = data.water.isValid();
-
-  (void)std::snprintf(payload.data(), payload.size(),
-                      "{\"temperature\":%.2f,\"humidity\":%.2f,\"pressure\":%.2f,"
-                      "\"soil_moisture\":%.2f,\"light_lux\":%.2f,\"light_available\":%s,"
-                      "\"water_level\":%.2f,\"water_level_available\":%s,\"watering\":%s}",
-                      data.environment.temperature, data.environment.humidity, data.environment.pressure,
-                      data.soil.percentage, isLightDataValid ? data.light.lux : 0.0F,
-                      isLightDataValid ? "true" : "false", isWaterDataValid ? data.water.percentage : 0.0F,
-                      isWaterDataValid ? "true" : "false", watering ? "true" : "false");
+  auto& payloadCache = SensorPayloadCache::getInstance();
+  payloadCache.update(data, watering);
 
-  if (transport_.publish(stateTopic_.data(), payload.data()))
+  const auto payload = payloadCache.acquire();
+  if (payload->empty()) [[unlikely]]
   {
-    lastPublish_ = nowMs;
+    return;
   }
-}
+  if (transport_.publish(stateTopic_.data(), payload->view(), false, MqttPriority::TELEMETRY))
+  {
+    outbox_.markLive();
+  }
+  else
+  {
+    queueSample(data, watering);
+  }
+  lastPublish_ = nowMs;
 
-void MQTTClient::publishDiscovery()
-{
-  publishSensorDiscovery("sensor", "temperature", "Temperature", "{{ value_json.temperature }}", "°C", "temperature");
-  sleep_ms(50);
-  publishSensorDiscovery("sensor", "humidity", "Humidity", "{{ value_json.humidity }}", "%", "humidity");
-  sleep_ms(50);
-  publishSensorDiscovery("sensor", "pressure", "Air Pressure", "{{ value_json.pressure }}", "hPa", "pressure");
-  sleep_ms(50);
-  publishSensorDiscovery("sensor", "soil", "Soil Moisture", "{{ value_json.soil_moisture }}", "%", "moisture");
-  sleep_ms(50);
-  publishSensorDiscovery("sensor", "light", "Ambient Light", "{{ value_json.light_lux }}", "lx", "illuminance");
-  sleep_ms(50);
-  publishSensorDiscovery("sensor", "water", "Water Level", "{{ value_json.water_level }}", "%");
-  sleep_ms(50);
-  publishSelectDiscovery();
-  sleep_ms(50);
-  publishButtonDiscovery();
-  sleep_ms(50);
-  publishUpdateTriggerDiscovery();
-  sleep_ms(50);
-  publishNumberDiscovery();
-  sleep_ms(50);
-  publishTextDiscovery();
+  if constexpr (Config::MQTT::PUBLISH_PACKED_STATE)
+  {
+    const auto record = PackedSensorRecord::from(data, watering);
+    (void)transport_.publish(packedStateTopic_.data(),
+                             std::string_view(reinterpret_cast<const char*>(&record), sizeof(record)), false,
+                             MqttPriority::TELEMETRY);
+  }
 }
 
-void MQTTClient::publishAvailability(const bool online)
+void MQTTClient::queueSample(const SensorData& data, const bool watering)
 {
-  (void)transport_.publish(availabilityTopic_.data(), online ? "online" : "offline", true);
+  outbox_.push(HistoryStore::getInstance().toHistoryTime(data.timestamp), PackedSensorRecord::from(data, watering));
 }
 
-void MQTTClient::publishSensorDiscovery(const std::string_view component, const std::string_view objectId,
-                                        const std::string_view name, const std::string_view valueTemplate,
-                                        const std::string_view unit, const std::string_view deviceClass)
+// Sends one QoS 1 batch at a time, waits for every PUBACK and a pacing gap before the next, so the backlog never
+// holds more than BACKLOG_BATCH requests in lwIP. The transport reports every QoS 1 message once, including those a
+// disconnect drops, so a failed batch stays queued and is resent whole.
+void MQTTClient::drainBacklog(const uint32_t nowMs)
 {
-  std::array<char, 128> topic{};
-  (void)std::snprintf(topic.data(), topic.size(), "%s/%.*s/%.*s/config", config_.discoveryPrefix.data(),
-                      static_cast<int>(component.size()), component.data(), static_cast<int>(objectId.size()),
-                      objectId.data());
+  if (backlogInFlight_ > 0)
+  {
+    const auto acked  = backlogAcked_.load();
+    const auto failed = backlogFailed_.load();
+    if ((acked + failed) < backlogInFlight_)
+    {
+      return;
+    }
+    if (failed == 0)
+    {
+      outbox_.pop(backlogBatch_.at(backlogInFlight_ - 1).time);
+    }
+    backlogInFlight_ = 0;
+    nextBacklogMs_   = nowMs + Config::MQTT::BACKLOG_PACE_MS;
+  }
 
-  std::array<char, 512> payload{};
-  std::array<char, 64>  uniqueId{};
-  (void)std::snprintf(uniqueId.data(), uniqueId.size(), "%s_%.*s", Config::System::IDENTIFIER,
-                      static_cast<int>(objectId.size()), objectId.data());
+  if (outbox_.empty() or (static_cast<int32_t>(nowMs - nextBacklogMs_) < 0))
+  {
+    return;
+  }
 
-  buildDiscoveryJson(payload, std::string(name).c_str(), uniqueId.data(), nullptr, stateTopic_.data(),
-                     availabilityTopic_.data(), deviceClass.empty() ? nullptr : std::string(deviceClass).c_str(),
-                     unit.empty() ? nullptr : std::string(unit).c_str(), std::string(valueTemplate).c_str());
+  const auto count = outbox_.peek(backlogBatch_, config_.publishIntervalMs / 1'000);
+  const auto now   = HistoryStore::getInstance().now();
+  backlogAcked_    = 0;
+  backlogFailed_   = 0;
 
-  (void)transport_.publish(topic.data(), payload.data(), true);
+  std::array<char, BACKLOG_PAYLOAD_SIZE> payload{};
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto json = serializeBacklog(backlogBatch_.at(i), now, payload);
+    if (json.empty() or
+        not transport_.publish(backlogTopic_.data(), json, false, MqttPriority::BACKLOG, 1, BACKLOG_TOKEN))
+    {
+      break;
+    }
+    ++backlogInFlight_;
+  }
+  nextBacklogMs_ = nowMs + Config::MQTT::BACKLOG_PACE_MS;
 }
 
-void MQTTClient::publishSelectDiscovery()
+// Retained configs outlive broker sessions, so they are only republished when the discovery set changed since the
+// last confirmed publish or Home Assistant announced that it came back online. Device mode sends every component in
+// one retained message; the per-entity mode serves Home Assistant releases before 2024.11 and is the fallback when
+// the device message cannot be built or queued. When the set changed, retained per-entity configs left by earlier
+// firmware are cleared ahead of the device message, so Home Assistant never sees their unique IDs twice. Tracked
+// configs go out at QoS 1 tagged with the fingerprint, which is committed only once every one of them has been
+// acknowledged.
+void MQTTClient::publishDiscovery()
 {
-  std::array<char, 128> topic{};
-  (void)std::snprintf(topic.data(), topic.size(), "%s/select/%s_mode/config", config_.discoveryPrefix.data(),
-                      Config::System::IDENTIFIER);
-
-  std::array<char, 512> payload{};
-  std::array<char, 64>  uniqueId{};
-  (void)std::snprintf(uniqueId.data(), uniqueId.size(), "%s_mode", Config::System::IDENTIFIER);
+  const auto fingerprint = HomeAssistantDiscovery::fingerprint(
+    config_.discoveryPrefix.data(), config_.baseTopic.data(), config_.brokerHost.data(), config_.brokerPort);
+  if (not refreshDiscovery_.exchange(false) and (fingerprint == discoveryFingerprint_))
+  {
+    printf("[MQTTClient] Discovery unchanged (%08lx), skipping\n", static_cast<unsigned long>(fingerprint));
+    return;
+  }
 
-  buildDiscoveryJson(payload, "Irrigation Mode", uniqueId.data(), modeCommandTopic_.data(), modeStateTopic_.data(),
-                     availabilityTopic_.data(), nullptr, nullptr, nullptr,
-                     R"(["OFF","MANUAL","TIMER","HUMIDITY","EVAPOTRANSPIRATION"])");
+  if constexpr (Config::MQTT::DEVICE_DISCOVERY)
+  {
+    const auto changed  = fingerprint != discoveryFingerprint_;
+    discoveryUnacked_   = changed ? static_cast<uint32_t>(HomeAssistantDiscovery::COMPONENTS.size() + 1) : 1U;
+    pendingFingerprint_ = fingerprint;
+    if (changed and not clearEntityDiscovery(fingerprint))
+    {
+      pendingFingerprint_ = HomeAssistantDiscovery::NEVER_PUBLISHED;
+    }
+    if (publishDeviceDiscovery(fingerprint))
+    {
+      return;
+    }
+    pendingFingerprint_ = HomeAssistantDiscovery::NEVER_PUBLISHED;
+    printf("[MQTTClient] Device discovery failed, publishing per entity\n");
+  }
 
-  (void)transport_.publish(topic.data(), payload.data(), true);
+  // The fallback describes a different discovery set than the fingerprint, so it is sent untracked.
+  const auto token    = Config::MQTT::DEVICE_DISCOVERY ? HomeAssistantDiscovery::NEVER_PUBLISHED : fingerprint;
+  discoveryUnacked_   = static_cast<uint32_t>(HomeAssistantDiscovery::COMPONENTS.size());
+  pendingFingerprint_ = token;
+  for (const auto& component : HomeAssistantDiscovery::COMPONENTS)
+  {
+    if (not publishEntityDiscovery(component, token))
+    {
+      pendingFingerprint_ = HomeAssistantDiscovery::NEVER_PUBLISHED;
+    }
+  }
 }
 
-void MQTTClient::publishButtonDiscovery()
+// Runs in the tcpip thread or wherever the transport drops messages; the flash write is left to confirmDiscovery().
+void MQTTClient::handleDelivery(const uint32_t token, const bool delivered)
 {
-  std::array<char, 128> topic{};
-  (void)std::snprintf(topic.data(), topic.size(), "%s/button/%s_trigger/config", config_.discoveryPrefix.data(),
-                      Config::System::IDENTIFIER);
-
-  std::array<char, 512> payload{};
-  std::array<char, 64>  uniqueId{};
-  (void)std::snprintf(uniqueId.data(), uniqueId.size(), "%s_trigger", Config::System::IDENTIFIER);
-
-  buildDiscoveryJson(payload, "Trigger Irrigation", uniqueId.data(), triggerCommandTopic_.data(), nullptr,
-                     availabilityTopic_.data());
+  if (token == BACKLOG_TOKEN)
+  {
+    ++(delivered ? backlogAcked_ : backlogFailed_);
+    return;
+  }
 
-  (void)transport_.publish(topic.data(), payload.data(), true);
+  auto expected = token;
+  if (not delivered)
+  {
+    (void)pendingFingerprint_.compare_exchange_strong(expected, HomeAssistantDiscovery::NEVER_PUBLISHED);
+    return;
+  }
+  if ((pendingFingerprint_ == token) and (--discoveryUnacked_ == 0) and
+      pendingFingerprint_.compare_exchange_strong(expected, HomeAssistantDiscovery::NEVER_PUBLISHED))
+  {
+    confirmedFingerprint_ = token;
+  }
 }
 
-void MQTTClient::publishUpdateTriggerDiscovery()
+void MQTTClient::confirmDiscovery()
 {
-  std::array<char, 128> topic{};
-  (void)std::snprintf(topic.data(), topic.size(), "%s/button/%s_update/config", config_.discoveryPrefix.data(),
-                      Config::System::IDENTIFIER);
-
-  std::array<char, 512> payload{};
-  std::array<char, 64>  uniqueId{};
-  (void)std::snprintf(uniqueId.data(), uniqueId.size(), "%s_update", Config::System::IDENTIFIER);
-
-  buildDiscoveryJson(payload, "Update Sensors", uniqueId.data(), updateCommandTopic_.data(), nullptr,
-                     availabilityTopic_.data());
-
-  (void)transport_.publish(topic.data(), payload.data(), true);
+  const auto fingerprint = confirmedFingerprint_.exchange(HomeAssistantDiscovery::NEVER_PUBLISHED);
+  if (fingerprint == HomeAssistantDiscovery::NEVER_PUBLISHED)
+  {
+    return;
+  }
+  discoveryFingerprint_ = fingerprint;
+  if (not ConfigService::getInstance().setDiscoveryFingerprint(fingerprint)) [[unlikely]]
+  {
+    printf("[MQTTClient] Failed to persist discovery fingerprint\n");
+  }
 }
 
-void MQTTClient::publishNumberDiscovery()
+auto MQTTClient::publishDeviceDiscovery(const uint32_t token) -> bool
 {
-  std::array<char, 128> topic{};
-  (void)std::snprintf(topic.data(), topic.size(), "%s/number/%s_interval/config", config_.discoveryPrefix.data(),
-                      Config::System::IDENTIFIER);
-
-  std::array<char, 512> payload{};
-  std::array<char, 64>  uniqueId{};
-  (void)std::snprintf(uniqueId.data(), uniqueId.size(), "%s_interval", Config::System::IDENTIFIER);
-
-  buildDiscoveryJson(payload, "Update Interval", uniqueId.data(), intervalCommandTopic_.data(),
-                     intervalStateTopic_.data(), availabilityTopic_.data(), nullptr, "s", nullptr, nullptr, "60",
-                     "86400");
-
-  (void)transport_.publish(topic.data(), payload.data(), true);
+  std::array<char, TOPIC_SIZE> topic{};
+  if (HomeAssistantDiscovery::deviceTopic(config_.discoveryPrefix.data(), topic).empty()) [[unlikely]]
+  {
+    return false;
+  }
+  const auto payload = HomeAssistantDiscovery::deviceConfig(config_.baseTopic.data(), discoveryPayload_);
+  return not payload.empty() and
+         transport_.publishBorrowed(topic.data(), payload, true, MqttPriority::CONTROL, 1, token);
 }
 
-void MQTTClient::publishTextDiscovery()
+// Empty retained payloads remove the per-entity configs; they are handed to lwIP straight away so the queue keeps
+// room for the device message that follows.
+auto MQTTClient::clearEntityDiscovery(const uint32_t token) -> bool
 {
-  std::array<char, 128> topic{};
-  (void)std::snprintf(topic.data(), topic.size(), "%s/text/%s_activity/config", config_.discoveryPrefix.data(),
-                      Config::System::IDENTIFIER);
+  auto cleared = true;
+  for (const auto& component : HomeAssistantDiscovery::COMPONENTS)
+  {
+    std::array<char, TOPIC_SIZE> topic{};
+    if (HomeAssistantDiscovery::entityTopic(component, config_.discoveryPrefix.data(), topic).empty() or
+        not transport_.publish(topic.data(), std::string_view{}, true, MqttPriority::CONTROL, 1, token)) [[unlikely]]
+    {
+      cleared = false;
+    }
+    transport_.service();
+  }
+  return cleared;
+}
 
-  std::array<char, 512> payload{};
-  std::array<char, 64>  uniqueId{};
-  (void)std::snprintf(uniqueId.data(), uniqueId.size(), "%s_activity", Config::System::IDENTIFIER);
+auto MQTTClient::publishEntityDiscovery(const HomeAssistantDiscovery::Component& component, const uint32_t token)
+  -> bool
+{
+  std::array<char, TOPIC_SIZE>                       topic{};
+  std::array<char, Config::MQTT::QUEUE_PAYLOAD_SIZE> payload{};
 
-  buildDiscoveryJson(payload, "Activity Log", uniqueId.data(), nullptr, activityStateTopic_.data(),
-                     availabilityTopic_.data());
+  const auto topicView = HomeAssistantDiscovery::entityTopic(component, config_.discoveryPrefix.data(), topic);
+  const auto config    = HomeAssistantDiscovery::entityConfig(component, config_.baseTopic.data(), payload);
+  if (topicView.empty() or config.empty()) [[unlikely]]
+  {
+    printf("[MQTTClient] Discovery for %.*s does not fit\n", static_cast<int>(component.objectId.size()),
+           component.objectId.data());
+    return false;
+  }
+  const auto qos = (token == HomeAssistantDiscovery::NEVER_PUBLISHED) ? 0 : 1;
+  return transport_.publish(topic.data(), config, true, MqttPriority::CONTROL, qos, token);
+}
 
-  (void)transport_.publish(topic.data(), payload.data(), true);
+void MQTTClient::publishAvailability(const bool online)
+{
+  (void)transport_.publish(availabilityTopic_.data(), online ? "online" : "offline", true);
 }
 
 void MQTTClient::publishIntervalState()
@@ -437,6 +495,7 @@ void MQTTClient::subscribeToCommands()
   (void)transport_.subscribe(triggerCommandTopic_.data());
   (void)transport_.subscribe(updateCommandTopic_.data());
   (void)transport_.subscribe(intervalCommandTopic_.data());
+  (void)transport_.subscribe(homeAssistantStatusTopic_.data());
 }
 
 void MQTTClient::handleCommand(const std::string_view topic, const std::string_view payload)
@@ -468,6 +527,14 @@ void MQTTClient::handleCommand(const std::string_view topic, const std::string_v
   {
     handleIntervalCommand(payload);
   }
+  else if (topic == std::string_view(homeAssistantStatusTopic_.data()))
+  {
+    if (payload == "online")
+    {
+      refreshDiscovery_ = true;
+      needsDiscovery_   = true;
+    }
+  }
 }
 
 void MQTTClient::handleModeCommand(const std::string_view payload)
@@ -499,14 +566,14 @@ void MQTTClient::handleModeCommand(const std::string_view payload)
   }
 
   irrigationController_.setMode(mode);
-  (void)transport_.publish(modeStateTopic_.data(), std::string(payload).c_str(), true);
+  (void)transport_.publish(modeStateTopic_.data(), payload, true);
 }
 
 void MQTTClient::handleTriggerCommand(const std::string_view payload)
 {
   if (payload == "PRESS" and irrigationController_.getMode() == IrrigationMode::MANUAL)
   {
-    const auto waterLevel = sensorController_.readWaterLevel();
+    const auto waterLevel = sensorController_.readWaterLevel(Config::SENSOR_CACHE_MAX_AGE_MS);
     if (waterLevel.isEmpty())
     {
       printf("[MQTTClient] Trigger ignored: Water tank is empty\n");
@@ -535,5 +602,5 @@ void MQTTClient::setPublishInterval(const uint32_t intervalMs)
 
 void MQTTClient::publishActivity(const std::string_view message)
 {
-  (void)transport_.publish(activityStateTopic_.data(), std::string(message).c_str(), true);
+  (void)transport_.publish(activityStateTopic_.data(), message, true);
 }
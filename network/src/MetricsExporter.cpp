@@ -0,0 +1,270 @@
+#include "MetricsExporter.hpp"
+
+#include "Common.hpp"
+#include "HttpServer.hpp"
+#include "LatencyHistogram.hpp"
+#include "RuntimeMetrics.hpp"
+
+#include <FreeRTOS.h>
+#include <lwip/memp.h>
+#include <lwip/stats.h>
+#include <lwip/tcpip.h>
+#include <portable.h>
+#include <task.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+
+inline constexpr size_t MAX_REPORTED_TASKS = 24;
+
+struct PoolMetric
+{
+  memp_t      pool;
+  const char* name;
+};
+
+inline constexpr std::array<PoolMetric, 6> LWIP_POOLS = {
+  {
+   {MEMP_PBUF_POOL, "pbuf_pool"},
+   {MEMP_PBUF, "pbuf"},
+   {MEMP_TCP_SEG, "tcp_seg"},
+   {MEMP_TCP_PCB, "tcp_pcb"},
+   {MEMP_NETCONN, "netconn"},
+   {MEMP_NETBUF, "netbuf"},
+   }
+};
+
+struct PoolUsage
+{
+  uint32_t used      = 0;
+  uint32_t max       = 0;
+  uint32_t available = 0;
+  uint32_t errors    = 0;
+};
+
+struct LwipSnapshot
+{
+  PoolUsage                                heap;
+  std::array<PoolUsage, LWIP_POOLS.size()> pools;
+  uint32_t                                 tcpSent      = 0;
+  uint32_t                                 tcpReceived  = 0;
+  uint32_t                                 tcpDropped   = 0;
+  uint32_t                                 tcpMemErrors = 0;
+};
+
+class MetricsWriter final
+{
+public:
+  explicit MetricsWriter(HttpResponse& response) : response_(response)
+  {
+  }
+
+  template <typename... Args>
+  void line(const char* const format, const Args... args)
+  {
+    for (auto attempt = 0; (attempt < 2) and not failed_; ++attempt)
+    {
+      const auto remaining = buffer_.size() - length_;
+      const auto count     = std::snprintf(buffer_.data() + length_, remaining, format, args...);
+      if (count < 0) [[unlikely]]
+      {
+        failed_ = true;
+      }
+      else if (static_cast<size_t>(count) < remaining)
+      {
+        length_ += static_cast<size_t>(count);
+        return;
+      }
+      else if (length_ == 0) [[unlikely]]
+      {
+        failed_ = true;
+      }
+      else
+      {
+        flush();
+      }
+    }
+  }
+
+  void family(const char* const name, const char* const type, const char* const help)
+  {
+    line("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+  }
+
+  auto finish() -> bool
+  {
+    flush();
+    return not failed_ and response_.endChunked();
+  }
+
+private:
+  void flush()
+  {
+    if ((length_ > 0) and not failed_)
+    {
+      failed_ = not response_.writeChunk({buffer_.data(), length_});
+    }
+    length_ = 0;
+  }
+
+  HttpResponse&         response_;
+  std::array<char, 512> buffer_{};
+  size_t                length_ = 0;
+  bool                  failed_ = false;
+};
+
+auto toUsage(const stats_mem& stats) -> PoolUsage
+{
+  return {.used = stats.used, .max = stats.max, .available = stats.avail, .errors = stats.err};
+}
+
+auto captureLwip() -> LwipSnapshot
+{
+  LwipSnapshot snapshot;
+  LOCK_TCPIP_CORE();
+  snapshot.heap = toUsage(lwip_stats.mem);
+  for (size_t i = 0; i < LWIP_POOLS.size(); ++i)
+  {
+    snapshot.pools.at(i) = toUsage(*lwip_stats.memp[LWIP_POOLS.at(i).pool]);
+  }
+  snapshot.tcpSent      = lwip_stats.tcp.xmit;
+  snapshot.tcpReceived  = lwip_stats.tcp.recv;
+  snapshot.tcpDropped   = lwip_stats.tcp.drop;
+  snapshot.tcpMemErrors = lwip_stats.tcp.memerr;
+  UNLOCK_TCPIP_CORE();
+  return snapshot;
+}
+
+void writeTasks(MetricsWriter& out)
+{
+  std::array<TaskStatus_t, MAX_REPORTED_TASKS> tasks{};
+  const auto count = uxTaskGetSystemState(tasks.data(), static_cast<UBaseType_t>(tasks.size()), nullptr);
+
+  out.family("freertos_tasks", "gauge", "Number of tasks known to the scheduler.");
+  out.line("freertos_tasks %lu\n", static_cast<unsigned long>(uxTaskGetNumberOfTasks()));
+
+  out.family("freertos_task_cpu_seconds_total", "counter", "CPU time consumed by each task.");
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto runtimeUs = static_cast<uint64_t>(tasks.at(i).ulRunTimeCounter);
+    out.line("freertos_task_cpu_seconds_total{task=\"%s\"} %lu.%06lu\n", tasks.at(i).pcTaskName,
+             static_cast<unsigned long>(runtimeUs / 1'000'000), static_cast<unsigned long>(runtimeUs % 1'000'000));
+  }
+
+  out.family("freertos_task_stack_free_bytes", "gauge", "Lowest remaining stack space observed for each task.");
+  for (size_t i = 0; i < count; ++i)
+  {
+    out.line("freertos_task_stack_free_bytes{task=\"%s\"} %lu\n", tasks.at(i).pcTaskName,
+             static_cast<unsigned long>(tasks.at(i).usStackHighWaterMark * sizeof(StackType_t)));
+  }
+}
+
+void writeHeap(MetricsWriter& out)
+{
+  out.family("freertos_heap_size_bytes", "gauge", "Total FreeRTOS heap size.");
+  out.line("freertos_heap_size_bytes %lu\n", static_cast<unsigned long>(configTOTAL_HEAP_SIZE));
+  out.family("freertos_heap_free_bytes", "gauge", "Currently free FreeRTOS heap.");
+  out.line("freertos_heap_free_bytes %lu\n", static_cast<unsigned long>(xPortGetFreeHeapSize()));
+  out.family("freertos_heap_min_free_bytes", "gauge", "Lowest free FreeRTOS heap since boot.");
+  out.line("freertos_heap_min_free_bytes %lu\n", static_cast<unsigned long>(xPortGetMinimumEverFreeHeapSize()));
+}
+
+void writeLwip(MetricsWriter& out)
+{
+  const auto snapshot = captureLwip();
+
+  out.family("lwip_mem_used_bytes", "gauge", "lwIP heap bytes in use.");
+  out.line("lwip_mem_used_bytes %lu\n", static_cast<unsigned long>(snapshot.heap.used));
+  out.family("lwip_mem_max_used_bytes", "gauge", "Peak lwIP heap bytes in use.");
+  out.line("lwip_mem_max_used_bytes %lu\n", static_cast<unsigned long>(snapshot.heap.max));
+  out.family("lwip_mem_errors_total", "counter", "Failed lwIP heap allocations.");
+  out.line("lwip_mem_errors_total %lu\n", static_cast<unsigned long>(snapshot.heap.errors));
+
+  const auto pools = [&out, &snapshot](const char* const name, const char* const type, const char* const help,
+                                       uint32_t PoolUsage::* const field)
+  {
+    out.family(name, type, help);
+    for (size_t i = 0; i < LWIP_POOLS.size(); ++i)
+    {
+      out.line("%s{pool=\"%s\"} %lu\n", name, LWIP_POOLS.at(i).name,
+               static_cast<unsigned long>(snapshot.pools.at(i).*field));
+    }
+  };
+  pools("lwip_memp_used", "gauge", "Elements in use per lwIP pool.", &PoolUsage::used);
+  pools("lwip_memp_max_used", "gauge", "Peak elements in use per lwIP pool.", &PoolUsage::max);
+  pools("lwip_memp_size", "gauge", "Capacity of each lwIP pool.", &PoolUsage::available);
+  pools("lwip_memp_errors_total", "counter", "Failed allocations per lwIP pool.", &PoolUsage::errors);
+
+  out.family("lwip_tcp_segments_total", "counter", "TCP segments handled by lwIP.");
+  out.line("lwip_tcp_segments_total{direction=\"tx\"} %lu\n", static_cast<unsigned long>(snapshot.tcpSent));
+  out.line("lwip_tcp_segments_total{direction=\"rx\"} %lu\n", static_cast<unsigned long>(snapshot.tcpReceived));
+  out.family("lwip_tcp_dropped_total", "counter", "TCP segments dropped by lwIP.");
+  out.line("lwip_tcp_dropped_total %lu\n", static_cast<unsigned long>(snapshot.tcpDropped));
+  out.family("lwip_tcp_memory_errors_total", "counter", "TCP sends that failed for lack of memory.");
+  out.line("lwip_tcp_memory_errors_total %lu\n", static_cast<unsigned long>(snapshot.tcpMemErrors));
+}
+
+void writeApplication(MetricsWriter& out)
+{
+  const auto& metrics = RuntimeMetrics::getInstance();
+
+  out.family("mqtt_publish_total", "counter", "MQTT publish attempts by outcome.");
+  out.line("mqtt_publish_total{result=\"accepted\"} %lu\n", static_cast<unsigned long>(metrics.mqttPublished()));
+  out.line("mqtt_publish_total{result=\"dropped\"} %lu\n", static_cast<unsigned long>(metrics.mqttDropped()));
+  out.family("mqtt_publish_retries_total", "counter", "MQTT publishes deferred because lwIP was out of memory.");
+  out.line("mqtt_publish_retries_total %lu\n", static_cast<unsigned long>(metrics.mqttRetries()));
+  out.family("mqtt_publish_coalesced_total", "counter", "Queued MQTT telemetry replaced by a newer state.");
+  out.line("mqtt_publish_coalesced_total %lu\n", static_cast<unsigned long>(metrics.mqttCoalesced()));
+  out.family("mqtt_publish_queue_depth", "gauge", "MQTT messages waiting for lwIP.");
+  out.line("mqtt_publish_queue_depth %lu\n", static_cast<unsigned long>(metrics.mqttQueueDepth()));
+
+  out.family("sensor_read_duration_seconds", "histogram", "Sensor read latency.");
+  for (size_t m = 0; m < static_cast<size_t>(LatencyMetric::COUNT); ++m)
+  {
+    const auto  metric     = static_cast<LatencyMetric>(m);
+    const auto* name       = RuntimeMetrics::latencyName(metric);
+    const auto  histogram  = metrics.latency(metric);
+    uint32_t    cumulative = 0;
+    for (size_t i = 0; i < LatencyHistogram::BOUNDS_MS.size(); ++i)
+    {
+      const auto boundMs  = LatencyHistogram::BOUNDS_MS.at(i);
+      cumulative         += histogram.buckets.at(i);
+      out.line("sensor_read_duration_seconds_bucket{sensor=\"%s\",le=\"%lu.%03lu\"} %lu\n", name,
+               static_cast<unsigned long>(boundMs / 1'000), static_cast<unsigned long>(boundMs % 1'000),
+               static_cast<unsigned long>(cumulative));
+    }
+    out.line("sensor_read_duration_seconds_bucket{sensor=\"%s\",le=\"+Inf\"} %lu\n", name,
+             static_cast<unsigned long>(histogram.count));
+    out.line("sensor_read_duration_seconds_sum{sensor=\"%s\"} %lu.%03lu\n", name,
+             static_cast<unsigned long>(histogram.sumMs / 1'000), static_cast<unsigned long>(histogram.sumMs % 1'000));
+    out.line("sensor_read_duration_seconds_count{sensor=\"%s\"} %lu\n", name,
+             static_cast<unsigned long>(histogram.count));
+  }
+}
+
+}  // namespace
+
+auto MetricsExporter::serve(HttpResponse& response) -> bool
+{
+  if (not response.beginChunked("text/plain; version=0.0.4; charset=utf-8")) [[unlikely]]
+  {
+    return false;
+  }
+
+  MetricsWriter out(response);
+  const auto    uptimeMs = Utils::getTimeSinceBoot();
+  out.family("device_uptime_seconds", "gauge", "Time since boot.");
+  out.line("device_uptime_seconds %lu.%03lu\n", static_cast<unsigned long>(uptimeMs / 1'000),
+           static_cast<unsigned long>(uptimeMs % 1'000));
+
+  writeTasks(out);
+  writeHeap(out);
+  writeLwip(out);
+  writeApplication(out);
+  return out.finish();
+}
@@ -0,0 +1,131 @@
+#include "MqttOutbox.hpp"
+
+#include "HistoryStore.hpp"
+#include "PackedSensorRecord.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+void MqttOutbox::push(const uint32_t time, const PackedSensorRecord& record)
+{
+  if (size_ == ring_.size())
+  {
+    spill(ring_.at(head_).time, afterLive_.test(head_));
+    head_ = (head_ + 1) % ring_.size();
+    --size_;
+  }
+  const auto slot = (head_ + size_) % ring_.size();
+  ring_.at(slot)  = {.time = time, .record = record};
+  afterLive_.set(slot, live_);
+  live_ = false;
+  ++size_;
+}
+
+// Called for every sample published live, so the unsent samples on either side of it never share a spill range.
+void MqttOutbox::markLive()
+{
+  live_ = true;
+}
+
+auto MqttOutbox::peek(const std::span<OutboxEntry> out, const uint32_t spacing) -> size_t
+{
+  spacing_ = std::max<uint32_t>(spacing, 1);
+  while ((spillCount_ > 0) and not out.empty())
+  {
+    const auto count = peekSpilled(out);
+    if (count > 0)
+    {
+      return count;
+    }
+    printf("[MqttOutbox] Spilled samples no longer in history, skipping\n");
+    dropSpill();
+  }
+
+  const auto count = std::min(out.size(), size_);
+  for (size_t i = 0; i < count; ++i)
+  {
+    out[i] = ring_.at((head_ + i) % ring_.size());
+  }
+  return count;
+}
+
+void MqttOutbox::pop(const uint32_t through)
+{
+  // Only a batch reaching into the front range trims it; a ring batch peeked before that range spilled ends earlier.
+  if ((spillCount_ > 0) and (through >= spills_.at(spillHead_).from))
+  {
+    auto& range = spills_.at(spillHead_);
+    range.from  = through + spacing_;
+    if (range.from > range.to)
+    {
+      dropSpill();
+    }
+  }
+  while ((size_ > 0) and (ring_.at(head_).time <= through))
+  {
+    head_ = (head_ + 1) % ring_.size();
+    --size_;
+  }
+}
+
+auto MqttOutbox::empty() const -> bool
+{
+  return (spillCount_ == 0) and (size_ == 0);
+}
+
+auto MqttOutbox::spilled() const -> bool
+{
+  return spillCount_ > 0;
+}
+
+// Consecutive evictions extend the newest range unless a live publish came between them. With every range in use the
+// oldest one is given up, as the RAM ring itself gives up its oldest sample.
+void MqttOutbox::spill(const uint32_t time, const bool afterLive)
+{
+  if ((spillCount_ > 0) and not afterLive)
+  {
+    spills_.at((spillHead_ + spillCount_ - 1) % spills_.size()).to = time;
+    return;
+  }
+
+  if (spillCount_ == spills_.size())
+  {
+    printf("[MqttOutbox] Too many outages queued, dropping the oldest\n");
+    dropSpill();
+  }
+  if (spillCount_ == 0)
+  {
+    printf("[MqttOutbox] RAM outbox full, spilling to history flash\n");
+  }
+  spills_.at((spillHead_ + spillCount_) % spills_.size()) = {.from = time, .to = time};
+  ++spillCount_;
+}
+
+// History keeps every reading; replay it at the publish cadence the RAM ring would have kept.
+auto MqttOutbox::peekSpilled(const std::span<OutboxEntry> out) -> size_t
+{
+  const auto& range   = spills_.at(spillHead_);
+  size_t      count   = 0;
+  uint32_t    next    = range.from;
+  const auto  collect = [&](const uint32_t time, const PackedSensorRecord& record)
+  {
+    if (time < next)
+    {
+      return true;
+    }
+    out[count++] = {.time = time, .record = record};
+    next         = time + spacing_;
+    return count < out.size();
+  };
+  (void)HistoryStore::getInstance().forEach(range.from, range.to, collect);
+  return count;
+}
+
+void MqttOutbox::dropSpill()
+{
+  spillHead_ = (spillHead_ + 1) % spills_.size();
+  --spillCount_;
+}
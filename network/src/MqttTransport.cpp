@@ -1,16 +1,40 @@
 #include "MqttTransport.hpp"
 
+#include "Config.hpp"
+#include "RuntimeMetrics.hpp"
+
+#include <FreeRTOS.h>
 #include <lwip/apps/mqtt.h>
+#include <lwip/apps/mqtt_opts.h>
 #include <lwip/dns.h>
 #include <lwip/err.h>
 #include <lwip/ip4_addr.h>
 #include <lwip/ip_addr.h>
+#include <lwip/tcpip.h>
+#include <projdefs.h>
+#include <semphr.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <string_view>
 #include <utility>
 
+// Leave request slots for subscriptions and room in the output ring for a full message from the other side.
+static_assert(Config::MQTT::PUBLISH_IN_FLIGHT < MQTT_REQ_MAX_IN_FLIGHT, "Publishes would starve subscriptions");
+static_assert((Config::MQTT::QUEUE_TOPIC_SIZE + Config::MQTT::QUEUE_PAYLOAD_SIZE) < MQTT_OUTPUT_RINGBUF_SIZE,
+              "Queued message must fit the MQTT output ring");
+static_assert(Config::MQTT::QUEUE_PAYLOAD_SIZE <= UINT16_MAX, "Queued payload length must fit 16 bits");
+
+namespace
+{
+
+inline constexpr size_t BORROWED_PAYLOAD_LIMIT = MQTT_OUTPUT_RINGBUF_SIZE - Config::MQTT::QUEUE_TOPIC_SIZE;
+
+}  // namespace
+
 MqttTransport::~MqttTransport()
 {
   disconnect();
@@ -34,8 +58,12 @@ auto MqttTransport::init(const char* const clientId, const char* const host, con
   {
     client_ = mqtt_client_new();
   }
+  if (queueMutex_ == nullptr)
+  {
+    queueMutex_ = xSemaphoreCreateMutex();
+  }
 
-  return client_ != nullptr;
+  return (client_ != nullptr) and (queueMutex_ != nullptr);
 }
 
 void MqttTransport::connect(ConnectCallback cb)
@@ -117,17 +145,35 @@ void MqttTransport::disconnect()
     mqtt_disconnect(client_);
   }
   connected_ = false;
+  dropAll();
 }
 
-auto MqttTransport::publish(const char* const topic, const char* const payload, const bool retain) -> bool
+auto MqttTransport::publish(const char* const topic, const char* const payload, const bool retain,
+                            const MqttPriority priority) -> bool
 {
-  if (not connected_ or client_ == nullptr)
+  return publish(topic, std::string_view(payload), retain, priority);
+}
+
+auto MqttTransport::publish(const char* const topic, const std::string_view payload, const bool retain,
+                            const MqttPriority priority, const uint8_t qos, const uint32_t token) -> bool
+{
+  if (not connected_ or (client_ == nullptr) or not enqueue(topic, payload, retain, priority, qos, token, false))
   {
+    RuntimeMetrics::getInstance().countMqttPublish(false);
     return false;
   }
+  return true;
+}
 
-  const auto err = mqtt_publish(client_, topic, payload, std::strlen(payload), 0, retain ? 1 : 0, nullptr, nullptr);
-  return err == ERR_OK;
+auto MqttTransport::publishBorrowed(const char* const topic, const std::string_view payload, const bool retain,
+                                    const MqttPriority priority, const uint8_t qos, const uint32_t token) -> bool
+{
+  if (not connected_ or (client_ == nullptr) or not enqueue(topic, payload, retain, priority, qos, token, true))
+  {
+    RuntimeMetrics::getInstance().countMqttPublish(false);
+    return false;
+  }
+  return true;
 }
 
 auto MqttTransport::subscribe(const char* const topic) -> bool
@@ -141,6 +187,66 @@ auto MqttTransport::subscribe(const char* const topic) -> bool
   return err == ERR_OK;
 }
 
+// Hands queued messages to lwIP in priority order while request slots are free. lwIP copies each message into its
+// output ring; ERR_MEM means the ring or the request table is full, so the message stays queued for the next pass.
+void MqttTransport::service()
+{
+  if (not connected_ or (client_ == nullptr) or (queueMutex_ == nullptr))
+  {
+    return;
+  }
+
+  FailedTokens failed;
+  LOCK_TCPIP_CORE();
+  xSemaphoreTake(queueMutex_, portMAX_DELAY);
+  auto* message = nextQueued();
+  while ((message != nullptr) and (inFlight_ < Config::MQTT::PUBLISH_IN_FLIGHT))
+  {
+    Completion* completion = nullptr;
+    if (message->qos > 0)
+    {
+      const auto free = std::ranges::find(completions_, false, &Completion::used);
+      if (free == completions_.end()) [[unlikely]]
+      {
+        break;
+      }
+      completion  = &*free;
+      *completion = {.owner = this, .token = message->token, .used = true};
+    }
+
+    const auto payload = (message->borrowed != nullptr) ? message->borrowed : message->payload.data();
+    const auto err =
+      mqtt_publish(client_, message->topic.data(), payload, message->length, message->qos, message->retain ? 1 : 0,
+                   (completion != nullptr) ? &MqttTransport::mqttAckCb : &MqttTransport::mqttSentCb,
+                   (completion != nullptr) ? static_cast<void*>(completion) : this);
+    if ((err != ERR_OK) and (completion != nullptr))
+    {
+      completion->used = false;
+    }
+    if (err == ERR_MEM)
+    {
+      RuntimeMetrics::getInstance().countMqttRetry();
+      break;
+    }
+
+    RuntimeMetrics::getInstance().countMqttPublish(err == ERR_OK);
+    if (err == ERR_OK)
+    {
+      ++inFlight_;
+    }
+    else if (completion != nullptr)
+    {
+      failed.tokens.at(failed.count++) = message->token;
+    }
+    release(*message);
+    message = nextQueued();
+  }
+  xSemaphoreGive(queueMutex_);
+  UNLOCK_TCPIP_CORE();
+
+  reportFailed(failed);
+}
+
 void MqttTransport::setOnMessage(MessageCallback cb)
 {
   messageCb_ = std::move(cb);
@@ -150,11 +256,178 @@ void MqttTransport::setOnMessage(MessageCallback cb)
   }
 }
 
+void MqttTransport::setOnDelivery(DeliveryCallback cb)
+{
+  deliveryCb_ = std::move(cb);
+}
+
 auto MqttTransport::isConnected() const -> bool
 {
   return connected_;
 }
 
+// Telemetry for a topic that is still queued is replaced in place: the latest state wins and keeps its turn. When
+// the queue is full, the newest message of a lower priority makes room; otherwise the new message is dropped.
+auto MqttTransport::enqueue(const char* const topic, const std::string_view payload, const bool retain,
+                            const MqttPriority priority, const uint8_t qos, const uint32_t token, const bool borrow)
+  -> bool
+{
+  const auto topicLength  = std::strlen(topic);
+  const auto payloadLimit = borrow ? BORROWED_PAYLOAD_LIMIT : Config::MQTT::QUEUE_PAYLOAD_SIZE;
+  if ((queueMutex_ == nullptr) or (topicLength >= Config::MQTT::QUEUE_TOPIC_SIZE) or
+      (payload.size() > payloadLimit)) [[unlikely]]
+  {
+    printf("[MqttTransport] Cannot queue message for %s\n", topic);
+    return false;
+  }
+
+  xSemaphoreTake(queueMutex_, portMAX_DELAY);
+  const auto     topicView   = std::string_view(topic, topicLength);
+  const auto     coalescable = (priority == MqttPriority::TELEMETRY) and (qos == 0) and not borrow;
+  QueuedMessage* slot        = nullptr;
+  QueuedMessage* victim      = nullptr;
+  auto           coalesced   = false;
+  for (auto& candidate : queue_)
+  {
+    if (not candidate.used)
+    {
+      slot = (slot == nullptr) ? &candidate : slot;
+    }
+    else if (coalescable and (candidate.priority == priority) and (candidate.qos == 0) and
+             (candidate.borrowed == nullptr) and (std::string_view(candidate.topic.data()) == topicView))
+    {
+      slot      = &candidate;
+      coalesced = true;
+      break;
+    }
+    else if ((candidate.priority > priority) and
+             ((victim == nullptr) or (candidate.priority > victim->priority) or
+              ((candidate.priority == victim->priority) and (candidate.sequence > victim->sequence))))
+    {
+      victim = &candidate;
+    }
+  }
+
+  FailedTokens evicted;
+  if ((slot == nullptr) and (victim != nullptr))
+  {
+    printf("[MqttTransport] Queue full, dropping %s\n", victim->topic.data());
+    RuntimeMetrics::getInstance().countMqttPublish(false);
+    if (victim->qos > 0)
+    {
+      evicted.tokens.at(evicted.count++) = victim->token;
+    }
+    release(*victim);
+    slot = victim;
+  }
+
+  if (slot != nullptr)
+  {
+    if (coalesced)
+    {
+      RuntimeMetrics::getInstance().countMqttCoalesced();
+    }
+    else
+    {
+      slot->used     = true;
+      slot->sequence = sequence_++;
+      slot->priority = priority;
+      std::memcpy(slot->topic.data(), topic, topicLength + 1);
+      ++queued_;
+    }
+    if (borrow)
+    {
+      slot->borrowed = payload.data();
+    }
+    else
+    {
+      std::memcpy(slot->payload.data(), payload.data(), payload.size());
+      slot->borrowed = nullptr;
+    }
+    slot->length = static_cast<uint16_t>(payload.size());
+    slot->retain = retain;
+    slot->qos    = qos;
+    slot->token  = token;
+  }
+  updateQueueDepth();
+  xSemaphoreGive(queueMutex_);
+
+  reportFailed(evicted);
+  return slot != nullptr;
+}
+
+auto MqttTransport::nextQueued() -> QueuedMessage*
+{
+  QueuedMessage* next = nullptr;
+  for (auto& candidate : queue_)
+  {
+    if (candidate.used and ((next == nullptr) or (candidate.priority < next->priority) or
+                            ((candidate.priority == next->priority) and (candidate.sequence < next->sequence))))
+    {
+      next = &candidate;
+    }
+  }
+  return next;
+}
+
+void MqttTransport::release(QueuedMessage& message)
+{
+  message.used = false;
+  --queued_;
+  updateQueueDepth();
+}
+
+// lwIP frees pending requests without calling back when the connection closes, so every queued or unacknowledged
+// QoS 1 message is reported as failed here.
+void MqttTransport::dropAll()
+{
+  if (queueMutex_ == nullptr)
+  {
+    return;
+  }
+
+  FailedTokens failed;
+  xSemaphoreTake(queueMutex_, portMAX_DELAY);
+  for (auto& message : queue_)
+  {
+    if (message.used)
+    {
+      RuntimeMetrics::getInstance().countMqttPublish(false);
+      if (message.qos > 0)
+      {
+        failed.tokens.at(failed.count++) = message.token;
+      }
+      release(message);
+    }
+  }
+  for (auto& completion : completions_)
+  {
+    if (completion.used)
+    {
+      failed.tokens.at(failed.count++) = completion.token;
+      completion.used                  = false;
+    }
+  }
+  inFlight_ = 0;
+  xSemaphoreGive(queueMutex_);
+
+  reportFailed(failed);
+}
+
+void MqttTransport::updateQueueDepth()
+{
+  RuntimeMetrics::getInstance().setMqttQueueDepth(static_cast<uint32_t>(queued_));
+}
+
+// Called without the queue lock, so the callback may publish again.
+void MqttTransport::reportFailed(const FailedTokens& failed)
+{
+  for (size_t i = 0; (i < failed.count) and deliveryCb_; ++i)
+  {
+    deliveryCb_(failed.tokens.at(i), false);
+  }
+}
+
 void MqttTransport::mqttConnectionCb(mqtt_client_t* const client, void* const arg,
                                      const mqtt_connection_status_t status)
 {
@@ -163,6 +436,7 @@ void MqttTransport::mqttConnectionCb(mqtt_client_t* const client, void* const ar
   {
     printf("[MqttTransport] Connected\n");
     self->connected_ = true;
+    self->inFlight_  = 0;
     if (self->connectCb_)
     {
       self->connectCb_(true);
@@ -177,6 +451,7 @@ void MqttTransport::mqttConnectionCb(mqtt_client_t* const client, void* const ar
   {
     printf("[MqttTransport] Connection failed: %d\n", status);
     self->connected_ = false;
+    self->dropAll();
     if (self->connectCb_)
     {
       self->connectCb_(false);
@@ -206,3 +481,31 @@ void MqttTransport::mqttIncomingDataCb(void* const arg, const uint8_t* const dat
     }
   }
 }
+
+void MqttTransport::mqttSentCb(void* const arg, const err_t /*result*/)
+{
+  auto* self = static_cast<MqttTransport*>(arg);
+  if (self->inFlight_ > 0)
+  {
+    --self->inFlight_;
+  }
+}
+
+// A completion that dropAll() already reported as failed is no longer in use and is ignored.
+void MqttTransport::mqttAckCb(void* const arg, const err_t result)
+{
+  auto* completion = static_cast<Completion*>(arg);
+  auto* self       = completion->owner;
+  mqttSentCb(self, result);
+
+  xSemaphoreTake(self->queueMutex_, portMAX_DELAY);
+  const auto pending = completion->used;
+  const auto token   = completion->token;
+  completion->used   = false;
+  xSemaphoreGive(self->queueMutex_);
+
+  if (pending and self->deliveryCb_)
+  {
+    self->deliveryCb_(token, result == ERR_OK);
+  }
+}
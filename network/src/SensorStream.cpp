@@ -0,0 +1,239 @@
+#include "SensorStream.hpp"
+
+#include "Common.hpp"
+#include "Config.hpp"
+#include "SensorPayloadCache.hpp"
+#include "TaskConfig.hpp"
+
+#include <FreeRTOS.h>
+#include <lwip/api.h>
+#include <lwip/err.h>
+#include <projdefs.h>
+#include <semphr.h>
+#include <task.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+namespace
+{
+
+inline constexpr std::string_view KEEP_ALIVE_COMMENT = ": ping\n\n";
+
+using EventBuffer = std::array<char, 384>;
+
+auto writeAll(netconn* const connection, const char* data, size_t size) -> bool
+{
+  while (size > 0)
+  {
+    size_t written = 0;
+    if (netconn_write_partly(connection, data, size, NETCONN_COPY, &written) != ERR_OK)
+    {
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+auto formatEvent(const std::span<char> buffer) -> size_t
+{
+  const auto payload = SensorPayloadCache::getInstance().acquire();
+  if (payload->empty())
+  {
+    return 0;
+  }
+
+  const auto count = std::snprintf(buffer.data(), buffer.size(), "id: %lu\nevent: sensors\ndata: %.*s\n\n",
+                                   static_cast<unsigned long>(payload->sequence), static_cast<int>(payload->length),
+                                   payload->json.data());
+  return ((count > 0) and (static_cast<size_t>(count) < buffer.size())) ? static_cast<size_t>(count) : 0;
+}
+
+void closeClient(netconn* const client)
+{
+  netconn_close(client);
+  netconn_delete(client);
+}
+
+}  // namespace
+
+SensorStream::~SensorStream()
+{
+  stop();
+}
+
+auto SensorStream::start() -> bool
+{
+  if (running_)
+  {
+    return true;
+  }
+
+  mutex_ = xSemaphoreCreateMutex();
+  if (mutex_ == nullptr) [[unlikely]]
+  {
+    printf("[Stream] Failed to create client mutex\n");
+    return false;
+  }
+
+  running_    = true;
+  taskActive_ = true;
+  if (xTaskCreate(streamTask, "sensorStream", SENSOR_STREAM_STACK, this, SENSOR_STREAM_PRIORITY, &task_) != pdPASS)
+    [[unlikely]]
+  {
+    printf("[Stream] Failed to create stream task\n");
+    taskActive_ = false;
+    task_       = nullptr;
+    stop();
+    return false;
+  }
+  // Registered here rather than in run() so a stop() issued before the task first runs cannot be undone by it.
+  SensorPayloadCache::getInstance().setUpdateListener(task_);
+  return true;
+}
+
+void SensorStream::stop()
+{
+  if (not running_.exchange(false))
+  {
+    return;
+  }
+
+  SensorPayloadCache::getInstance().clearUpdateListener(task_);
+  xSemaphoreTake(mutex_, portMAX_DELAY);
+  if ((task_ != nullptr) and taskActive_.load())
+  {
+    xTaskNotifyGive(task_);
+  }
+  xSemaphoreGive(mutex_);
+  while (taskActive_.load())
+  {
+    Utils::delayMs(10);
+  }
+  task_ = nullptr;
+
+  for (auto& client : clients_)
+  {
+    if (client != nullptr)
+    {
+      closeClient(client);
+      client = nullptr;
+    }
+  }
+  vSemaphoreDelete(mutex_);
+  mutex_ = nullptr;
+}
+
+auto SensorStream::attach(netconn* const client) -> bool
+{
+  if (client == nullptr) [[unlikely]]
+  {
+    return false;
+  }
+  if (not running_) [[unlikely]]
+  {
+    closeClient(client);
+    return false;
+  }
+
+  netconn_set_sendtimeout(client, static_cast<int32_t>(Config::Http::STREAM_SEND_TIMEOUT_MS));
+
+  xSemaphoreTake(mutex_, portMAX_DELAY);
+  const auto slot = std::ranges::find(clients_, nullptr);
+  auto       ok   = slot != clients_.end();
+  if (ok)
+  {
+    EventBuffer buffer{};
+    const auto  retry = std::snprintf(buffer.data(), buffer.size(), "retry: %lu\n\n",
+                                      static_cast<unsigned long>(Config::Http::STREAM_RETRY_MS));
+    const auto  event = formatEvent(std::span(buffer).subspan(static_cast<size_t>(retry)));
+    ok                = writeAll(client, buffer.data(), static_cast<size_t>(retry) + event);
+  }
+  if (ok)
+  {
+    *slot = client;
+  }
+  const auto viewers = std::ranges::count_if(clients_, [](const netconn* const c) { return c != nullptr; });
+  xSemaphoreGive(mutex_);
+
+  if (not ok) [[unlikely]]
+  {
+    printf("[Stream] Rejected viewer\n");
+    closeClient(client);
+    return false;
+  }
+  printf("[Stream] Viewer attached (%d active)\n", static_cast<int>(viewers));
+  return true;
+}
+
+auto SensorStream::hasCapacity() -> bool
+{
+  if (not running_)
+  {
+    return false;
+  }
+  xSemaphoreTake(mutex_, portMAX_DELAY);
+  const auto available = std::ranges::find(clients_, nullptr) != clients_.end();
+  xSemaphoreGive(mutex_);
+  return available;
+}
+
+void SensorStream::streamTask(void* const params)
+{
+  auto* stream = static_cast<SensorStream*>(params);
+  stream->run();
+  SensorPayloadCache::getInstance().clearUpdateListener(xTaskGetCurrentTaskHandle());
+
+  // stop() only notifies while holding the mutex and seeing the task active, so it never signals a deleted task.
+  xSemaphoreTake(stream->mutex_, portMAX_DELAY);
+  stream->taskActive_ = false;
+  xSemaphoreGive(stream->mutex_);
+  vTaskDelete(nullptr);
+}
+
+void SensorStream::run()
+{
+  EventBuffer buffer{};
+  while (running_)
+  {
+    const auto updated = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(Config::Http::STREAM_KEEP_ALIVE_MS)) > 0;
+    if (not running_)
+    {
+      break;
+    }
+
+    if (not updated)
+    {
+      broadcast(KEEP_ALIVE_COMMENT.data(), KEEP_ALIVE_COMMENT.size());
+      continue;
+    }
+
+    const auto length = formatEvent(buffer);
+    if (length > 0)
+    {
+      broadcast(buffer.data(), length);
+    }
+  }
+}
+
+void SensorStream::broadcast(const char* const data, const size_t size)
+{
+  xSemaphoreTake(mutex_, portMAX_DELAY);
+  for (auto& client : clients_)
+  {
+    if ((client != nullptr) and not writeAll(client, data, size))
+    {
+      printf("[Stream] Viewer disconnected\n");
+      closeClient(client);
+      client = nullptr;
+    }
+  }
+  xSemaphoreGive(mutex_);
+}
@@ -1,9 +1,8 @@
 #pragma once
 
+#include "I2cBus.hpp"
 #include "Types.hpp"
 
-#include <hardware/i2c.h>
-
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -35,7 +34,7 @@ class EnvironmentalSensor final
     int8_t  dig_H6 = 0;
   };
 
-  explicit EnvironmentalSensor(i2c_inst_t* i2c, uint8_t address = 0x76);
+  explicit EnvironmentalSensor(I2cBus* bus, uint8_t address = 0x76);
   ~EnvironmentalSensor() = default;
 
   EnvironmentalSensor(const EnvironmentalSensor&)                    = delete;
@@ -45,13 +44,15 @@ class EnvironmentalSensor final
 
   auto init() -> bool;
   auto read() -> std::optional<EnvironmentData>;
+  auto startMeasurement() -> bool;
+  auto collect() -> std::optional<EnvironmentData>;
   auto isAvailable() const -> bool
   {
     return initialized_;
   }
 
 private:
-  i2c_inst_t*     i2c_         = nullptr;
+  I2cBus*         bus_         = nullptr;
   uint8_t         address_     = 0;
   bool            initialized_ = false;
   CalibrationData calib_       = {};
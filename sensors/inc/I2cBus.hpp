@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <FreeRTOS.h>
+#include <hardware/i2c.h>
+#include <task.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+class I2cBus final
+{
+public:
+  explicit I2cBus(i2c_inst_t* i2c);
+  ~I2cBus();
+
+  I2cBus(const I2cBus&)                    = delete;
+  auto operator=(const I2cBus&) -> I2cBus& = delete;
+  I2cBus(I2cBus&&)                         = delete;
+  auto operator=(I2cBus&&) -> I2cBus&      = delete;
+
+  auto init(uint32_t baudrate, uint8_t sdaPin, uint8_t sclPin) -> bool;
+
+  auto write(uint8_t address, std::span<const uint8_t> data,
+             uint32_t timeoutMs = Config::I2C_TRANSACTION_TIMEOUT_MS) -> bool;
+  auto read(uint8_t address, std::span<uint8_t> data, uint32_t timeoutMs = Config::I2C_TRANSACTION_TIMEOUT_MS) -> bool;
+  auto writeRead(uint8_t address, std::span<const uint8_t> command, std::span<uint8_t> data,
+                 uint32_t timeoutMs = Config::I2C_TRANSACTION_TIMEOUT_MS) -> bool;
+
+  auto hasDma() const -> bool;
+
+private:
+  static constexpr size_t MAX_DMA_COMMANDS = 32;
+
+  static void i2c0IrqHandler();
+  static void i2c1IrqHandler();
+  void        handleIrq();
+
+  auto transfer(uint8_t address, std::span<const uint8_t> tx, std::span<uint8_t> rx, uint32_t timeoutMs) -> bool;
+  auto transferDma(uint8_t address, std::span<const uint8_t> tx, std::span<uint8_t> rx, uint32_t timeoutMs) -> bool;
+  auto transferBlocking(uint8_t address, std::span<const uint8_t> tx, std::span<uint8_t> rx,
+                        uint32_t timeoutMs) const -> bool;
+  void abortDma() const;
+
+  static inline std::array<I2cBus*, NUM_I2CS> instances_ = {};
+
+  i2c_inst_t*           i2c_         = nullptr;
+  int32_t               txChannel_   = -1;
+  int32_t               rxChannel_   = -1;
+  uint32_t              irqNumber_   = 0;
+  bool                  initialized_ = false;
+  TaskHandle_t volatile waiter_      = nullptr;
+  volatile bool         aborted_     = false;
+
+  std::array<uint32_t, MAX_DMA_COMMANDS> commands_ = {};
+};
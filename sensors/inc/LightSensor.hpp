@@ -1,17 +1,16 @@
 #pragma once
 
 #include "Config.hpp"
+#include "I2cBus.hpp"
 #include "Types.hpp"
 
-#include <hardware/i2c.h>
-
 #include <cstdint>
 #include <optional>
 
 class LightSensor final
 {
 public:
-  explicit LightSensor(i2c_inst_t* i2c, uint8_t address = Config::LIGHT_SENSOR_I2C_ADDRESS);
+  explicit LightSensor(I2cBus* bus, uint8_t address = Config::LIGHT_SENSOR_I2C_ADDRESS);
   ~LightSensor() = default;
 
   LightSensor(const LightSensor&)                    = delete;
@@ -21,20 +20,23 @@ class LightSensor final
 
   auto init() -> bool;
   auto read() -> std::optional<LightLevelData>;
+  auto startMeasurement() -> bool;
+  auto collect() -> std::optional<LightLevelData>;
   auto isAvailable() const -> bool
   {
     return initialized_;
   }
 
 private:
-  static constexpr uint8_t POWER_ON_CMD           = 0x01;
-  static constexpr uint8_t RESET_CMD              = 0x07;
-  static constexpr uint8_t CONT_HIGH_RES_MODE_CMD = 0x10;
-
-  i2c_inst_t* i2c_              = nullptr;
-  uint8_t     address_          = 0;
-  bool        initialized_      = false;
-  bool        readFailedLogged_ = false;
+  static constexpr uint8_t POWER_DOWN_CMD             = 0x00;
+  static constexpr uint8_t POWER_ON_CMD               = 0x01;
+  static constexpr uint8_t RESET_CMD                  = 0x07;
+  static constexpr uint8_t ONE_TIME_HIGH_RES_MODE_CMD = 0x20;
+
+  I2cBus* bus_              = nullptr;
+  uint8_t address_          = 0;
+  bool    initialized_      = false;
+  bool    readFailedLogged_ = false;
 
   auto writeCommand(uint8_t command) -> bool;
 };
@@ -6,8 +6,11 @@
 #include <hardware/adc.h>
 #include <hardware/gpio.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <span>
 
 class SoilMoistureSensor final
 {
@@ -15,7 +18,7 @@ class SoilMoistureSensor final
   explicit SoilMoistureSensor(uint8_t adcPin     = Config::SOIL_MOISTURE_ADC_PIN,
                               uint8_t adcChannel = Config::SOIL_MOISTURE_ADC_CHANNEL,
                               uint8_t powerPin   = Config::SOIL_MOISTURE_POWER_UP_PIN);
-  ~SoilMoistureSensor() = default;
+  ~SoilMoistureSensor();
 
   SoilMoistureSensor(const SoilMoistureSensor&)                    = delete;
   auto operator=(const SoilMoistureSensor&) -> SoilMoistureSensor& = delete;
@@ -24,6 +27,8 @@ class SoilMoistureSensor final
 
   auto init() -> bool;
   auto read() -> std::optional<SoilMoistureData>;
+  auto powerUp() -> bool;
+  auto collect() -> std::optional<SoilMoistureData>;
   auto isAvailable() const -> bool
   {
     return initialized_;
@@ -32,14 +37,31 @@ class SoilMoistureSensor final
   void calibrate(uint16_t dryValue, uint16_t wetValue);
 
 private:
+  static constexpr size_t ADC_LEVELS = 1U << 12U;
+
+  struct SampleStatistics
+  {
+    uint16_t median        = 0;
+    float    trimmedMean   = 0.0F;
+    float    trimmedStdDev = 0.0F;
+  };
+
   uint8_t adcPin_      = 0;
   uint8_t adcChannel_  = 0;
   uint8_t powerPin_    = 0;
   bool    initialized_ = false;
+  bool    powered_     = false;
+  int32_t dmaChannel_  = -1;
 
   uint16_t soilDryValue_ = Config::SOIL_DRY_VALUE;
   uint16_t soilWetValue_ = Config::SOIL_WET_VALUE;
 
-  static auto readADC(uint8_t channel) -> uint16_t;
+  std::array<uint16_t, Config::SOIL_MOISTURE_SAMPLE_COUNT> samples_   = {};
+  std::array<uint16_t, ADC_LEVELS>                         histogram_ = {};
+
+  void captureSamples();
+
+  static auto computeStatistics(std::span<const uint16_t> samples, std::span<uint16_t, ADC_LEVELS> histogram)
+    -> SampleStatistics;
   static auto mapToPercentage(uint16_t value, uint16_t minVal, uint16_t maxVal) -> float;
 };
@@ -1,17 +1,16 @@
 #pragma once
 
 #include "Config.hpp"
+#include "I2cBus.hpp"
 #include "Types.hpp"
 
-#include <hardware/i2c.h>
-
 #include <cstdint>
 #include <optional>
 
 class WaterLevelSensor final
 {
 public:
-  explicit WaterLevelSensor(i2c_inst_t* i2c, uint8_t lowAddress = Config::WATER_LEVEL_LOW_ADDR,
+  explicit WaterLevelSensor(I2cBus* bus, uint8_t lowAddress = Config::WATER_LEVEL_LOW_ADDR,
                             uint8_t highAddress = Config::WATER_LEVEL_HIGH_ADDR);
   ~WaterLevelSensor() = default;
 
@@ -33,8 +32,8 @@ class WaterLevelSensor final
   static constexpr uint8_t TOTAL_SECTIONS = LOW_SECTIONS + HIGH_SECTIONS;
   static_assert(TOTAL_SECTIONS == Config::WATER_LEVEL_TOTAL_SECTIONS, "Water level section count mismatch");
 
-  i2c_inst_t* i2c_         = nullptr;
-  uint8_t     lowAddress_  = 0;
-  uint8_t     highAddress_ = 0;
-  bool        initialized_ = false;
+  I2cBus* bus_         = nullptr;
+  uint8_t lowAddress_  = 0;
+  uint8_t highAddress_ = 0;
+  bool    initialized_ = false;
 };
@@ -1,13 +1,14 @@
 #include "EnvironmentalSensor.hpp"
+#include "Common.hpp"
+#include "Config.hpp"
+#include "I2cBus.hpp"
 #include "Types.hpp"
 
-#include <hardware/i2c.h>
-#include <pico/time.h>
-
 #include <array>
 #include <cstdint>
 #include <cstdio>
 #include <optional>
+#include <span>
 
 namespace
 {
@@ -24,9 +25,14 @@ inline constexpr uint8_t REG_CALIB_26  = 0xE1;
 
 inline constexpr uint8_t CHIP_ID = 0x60;
 
+inline constexpr uint8_t CTRL_MEAS_OVERSAMPLING = (0x01U << 5U) | (0x01U << 2U);
+inline constexpr uint8_t MODE_SLEEP             = 0x00;
+inline constexpr uint8_t MODE_FORCED            = 0x01;
+inline constexpr uint8_t STATUS_MEASURING       = 0x08;
+
 }  // namespace
 
-EnvironmentalSensor::EnvironmentalSensor(i2c_inst_t* i2c, const uint8_t address) : i2c_(i2c), address_(address)
+EnvironmentalSensor::EnvironmentalSensor(I2cBus* bus, const uint8_t address) : bus_(bus), address_(address)
 {
 }
 
@@ -37,9 +43,9 @@ auto EnvironmentalSensor::init() -> bool
     return true;
   }
 
-  if (i2c_ == nullptr) [[unlikely]]
+  if (bus_ == nullptr) [[unlikely]]
   {
-    printf("[BME280] ERROR: Missing I2C instance\n");
+    printf("[BME280] ERROR: Missing I2C bus\n");
     return false;
   }
 
@@ -51,7 +57,7 @@ auto EnvironmentalSensor::init() -> bool
   }
 
   writeReg(REG_RESET, 0xB6);
-  sleep_ms(100);
+  Utils::delayMs(100);
 
   if (not readCalibrationData()) [[unlikely]]
   {
@@ -61,7 +67,7 @@ auto EnvironmentalSensor::init() -> bool
 
   writeReg(REG_CTRL_HUM, 0x01);
   writeReg(REG_CONFIG, (0x05U << 5U) | (0x00U << 2U));
-  writeReg(REG_CTRL_MEAS, (0x01U << 5U) | (0x01U << 2U) | 0x03U);
+  writeReg(REG_CTRL_MEAS, CTRL_MEAS_OVERSAMPLING | MODE_SLEEP);
 
   initialized_ = true;
   printf("[BME280] Initialized (addr=0x%02X)\n", address_);
@@ -69,12 +75,45 @@ auto EnvironmentalSensor::init() -> bool
 }
 
 auto EnvironmentalSensor::read() -> std::optional<EnvironmentData>
+{
+  if (not startMeasurement()) [[unlikely]]
+  {
+    return std::nullopt;
+  }
+  Utils::delayMs(Config::BME280_MEASURE_MS);
+  return collect();
+}
+
+auto EnvironmentalSensor::startMeasurement() -> bool
 {
   if (not initialized_ and not init()) [[unlikely]]
+  {
+    return false;
+  }
+
+  if (not writeReg(REG_CTRL_MEAS, CTRL_MEAS_OVERSAMPLING | MODE_FORCED)) [[unlikely]]
+  {
+    printf("[BME280] Failed to start measurement\n");
+    initialized_ = false;
+    return false;
+  }
+  return true;
+}
+
+auto EnvironmentalSensor::collect() -> std::optional<EnvironmentData>
+{
+  if (not initialized_) [[unlikely]]
   {
     return std::nullopt;
   }
 
+  uint8_t status = 0;
+  if (not readRegs(REG_STATUS, &status, 1) or ((status & STATUS_MEASURING) != 0U)) [[unlikely]]
+  {
+    printf("[BME280] Measurement not ready (status=0x%02X)\n", status);
+    return std::nullopt;
+  }
+
   std::array<uint8_t, 8> data{};
   if (not readRegs(REG_PRESS_MSB, data.data(), data.size())) [[unlikely]]
   {
@@ -103,16 +142,12 @@ auto EnvironmentalSensor::read() -> std::optional<EnvironmentData>
 auto EnvironmentalSensor::writeReg(const uint8_t reg, const uint8_t value) -> bool
 {
   const std::array<uint8_t, 2> data{reg, value};
-  return i2c_write_blocking(i2c_, address_, data.data(), data.size(), false) == static_cast<int>(data.size());
+  return bus_->write(address_, data);
 }
 
 auto EnvironmentalSensor::readRegs(const uint8_t reg, uint8_t* const buf, const size_t len) -> bool
 {
-  if (i2c_write_blocking(i2c_, address_, &reg, 1, true) != 1) [[unlikely]]
-  {
-    return false;
-  }
-  return i2c_read_blocking(i2c_, address_, buf, len, false) == static_cast<int>(len);
+  return bus_->writeRead(address_, std::span(&reg, 1), std::span(buf, len));
 }
 
 auto EnvironmentalSensor::readCalibrationData() -> bool
@@ -0,0 +1,253 @@
+#include "I2cBus.hpp"
+#include "Config.hpp"
+
+#include <FreeRTOS.h>
+#include <hardware/dma.h>
+#include <hardware/gpio.h>
+#include <hardware/i2c.h>
+#include <hardware/irq.h>
+#include <projdefs.h>
+#include <task.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+I2cBus::I2cBus(i2c_inst_t* i2c) : i2c_(i2c)
+{
+}
+
+I2cBus::~I2cBus()
+{
+  if (not initialized_)
+  {
+    return;
+  }
+
+  irq_set_enabled(irqNumber_, false);
+  instances_.at(i2c_get_index(i2c_)) = nullptr;
+  if (txChannel_ >= 0)
+  {
+    dma_channel_unclaim(static_cast<uint>(txChannel_));
+  }
+  if (rxChannel_ >= 0)
+  {
+    dma_channel_unclaim(static_cast<uint>(rxChannel_));
+  }
+}
+
+auto I2cBus::init(const uint32_t baudrate, const uint8_t sdaPin, const uint8_t sclPin) -> bool
+{
+  if (initialized_)
+  {
+    return true;
+  }
+  if (i2c_ == nullptr) [[unlikely]]
+  {
+    printf("[I2cBus] ERROR: Missing I2C instance\n");
+    return false;
+  }
+
+  i2c_init(i2c_, baudrate);
+  gpio_set_function(sdaPin, GPIO_FUNC_I2C);
+  gpio_set_function(sclPin, GPIO_FUNC_I2C);
+  gpio_pull_up(sdaPin);
+  gpio_pull_up(sclPin);
+
+  const auto index     = i2c_get_index(i2c_);
+  instances_.at(index) = this;
+  initialized_         = true;
+
+  txChannel_ = dma_claim_unused_channel(false);
+  rxChannel_ = dma_claim_unused_channel(false);
+  if (not hasDma()) [[unlikely]]
+  {
+    printf("[I2cBus] WARNING: No free DMA channels for I2C%u, using blocking transfers\n", index);
+    return true;
+  }
+
+  auto* const hw = i2c_get_hw(i2c_);
+  hw->intr_mask  = 0;
+  irqNumber_     = (index == 0) ? I2C0_IRQ : I2C1_IRQ;
+  irq_set_exclusive_handler(irqNumber_, (index == 0) ? &I2cBus::i2c0IrqHandler : &I2cBus::i2c1IrqHandler);
+  irq_set_enabled(irqNumber_, true);
+
+  printf("[I2cBus] I2C%u ready (DMA tx=%d rx=%d)\n", index, txChannel_, rxChannel_);
+  return true;
+}
+
+auto I2cBus::hasDma() const -> bool
+{
+  return (txChannel_ >= 0) and (rxChannel_ >= 0);
+}
+
+auto I2cBus::write(const uint8_t address, const std::span<const uint8_t> data, const uint32_t timeoutMs) -> bool
+{
+  return transfer(address, data, {}, timeoutMs);
+}
+
+auto I2cBus::read(const uint8_t address, const std::span<uint8_t> data, const uint32_t timeoutMs) -> bool
+{
+  return transfer(address, {}, data, timeoutMs);
+}
+
+auto I2cBus::writeRead(const uint8_t address, const std::span<const uint8_t> command, const std::span<uint8_t> data,
+                       const uint32_t timeoutMs) -> bool
+{
+  return transfer(address, command, data, timeoutMs);
+}
+
+auto I2cBus::transfer(const uint8_t address, const std::span<const uint8_t> tx, const std::span<uint8_t> rx,
+                      const uint32_t timeoutMs) -> bool
+{
+  if (not initialized_ or (tx.empty() and rx.empty())) [[unlikely]]
+  {
+    return false;
+  }
+
+  const auto fitsDma = (tx.size() + rx.size()) <= MAX_DMA_COMMANDS;
+  if (hasDma() and fitsDma and (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+  {
+    return transferDma(address, tx, rx, timeoutMs);
+  }
+  return transferBlocking(address, tx, rx, timeoutMs);
+}
+
+auto I2cBus::transferDma(const uint8_t address, const std::span<const uint8_t> tx, const std::span<uint8_t> rx,
+                         const uint32_t timeoutMs) -> bool
+{
+  size_t count = 0;
+  for (const auto byte : tx)
+  {
+    commands_.at(count++) = byte;
+  }
+  for (size_t i = 0; i < rx.size(); ++i)
+  {
+    const auto restart    = (i == 0) and not tx.empty();
+    commands_.at(count++) = I2C_IC_DATA_CMD_CMD_BITS | (restart ? I2C_IC_DATA_CMD_RESTART_BITS : 0U);
+  }
+  commands_.at(count - 1) |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  auto* const hw = i2c_get_hw(i2c_);
+  hw->enable     = 0;
+  hw->tar        = address;
+  hw->enable     = I2C_IC_ENABLE_ENABLE_BITS;
+  (void)hw->clr_tx_abrt;
+  (void)hw->clr_stop_det;
+
+  aborted_ = false;
+  waiter_  = xTaskGetCurrentTaskHandle();
+  (void)ulTaskNotifyValueClearIndexed(nullptr, Config::I2C_NOTIFY_INDEX, UINT32_MAX);
+
+  if (not rx.empty())
+  {
+    auto rxConfig = dma_channel_get_default_config(static_cast<uint>(rxChannel_));
+    channel_config_set_transfer_data_size(&rxConfig, DMA_SIZE_8);
+    channel_config_set_read_increment(&rxConfig, false);
+    channel_config_set_write_increment(&rxConfig, true);
+    channel_config_set_dreq(&rxConfig, i2c_get_dreq(i2c_, false));
+    dma_channel_configure(static_cast<uint>(rxChannel_), &rxConfig, rx.data(), &hw->data_cmd, rx.size(), true);
+  }
+
+  auto txConfig = dma_channel_get_default_config(static_cast<uint>(txChannel_));
+  channel_config_set_transfer_data_size(&txConfig, DMA_SIZE_32);
+  channel_config_set_read_increment(&txConfig, true);
+  channel_config_set_write_increment(&txConfig, false);
+  channel_config_set_dreq(&txConfig, i2c_get_dreq(i2c_, true));
+
+  hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+  dma_channel_configure(static_cast<uint>(txChannel_), &txConfig, &hw->data_cmd, commands_.data(), count, true);
+
+  const auto completed = ulTaskNotifyTakeIndexed(Config::I2C_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(timeoutMs)) != 0U;
+
+  hw->intr_mask = 0;
+  waiter_       = nullptr;
+
+  if (not completed) [[unlikely]]
+  {
+    hw_set_bits(&hw->enable, I2C_IC_ENABLE_ABORT_BITS);
+    abortDma();
+    printf("[I2cBus] Transfer to 0x%02X timed out after %u ms\n", address, timeoutMs);
+    return false;
+  }
+  if (aborted_) [[unlikely]]
+  {
+    abortDma();
+    return false;
+  }
+  if (not rx.empty())
+  {
+    dma_channel_wait_for_finish_blocking(static_cast<uint>(rxChannel_));
+  }
+  return true;
+}
+
+auto I2cBus::transferBlocking(const uint8_t address, const std::span<const uint8_t> tx, const std::span<uint8_t> rx,
+                              const uint32_t timeoutMs) const -> bool
+{
+  const auto timeoutUs = timeoutMs * 1'000U;
+  if (not tx.empty())
+  {
+    const auto written = i2c_write_timeout_us(i2c_, address, tx.data(), tx.size(), not rx.empty(), timeoutUs);
+    if (written != static_cast<int>(tx.size()))
+    {
+      return false;
+    }
+  }
+  if (not rx.empty())
+  {
+    const auto received = i2c_read_timeout_us(i2c_, address, rx.data(), rx.size(), false, timeoutUs);
+    if (received != static_cast<int>(rx.size()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void I2cBus::abortDma() const
+{
+  dma_channel_abort(static_cast<uint>(txChannel_));
+  dma_channel_abort(static_cast<uint>(rxChannel_));
+}
+
+void I2cBus::handleIrq()
+{
+  auto* const hw     = i2c_get_hw(i2c_);
+  const auto  status = hw->intr_stat;
+
+  if ((status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) != 0U)
+  {
+    aborted_ = true;
+    (void)hw->clr_tx_abrt;
+  }
+  if ((status & I2C_IC_INTR_STAT_R_STOP_DET_BITS) != 0U)
+  {
+    (void)hw->clr_stop_det;
+  }
+  hw->intr_mask = 0;
+
+  BaseType_t woken = pdFALSE;
+  if (waiter_ != nullptr)
+  {
+    vTaskNotifyGiveIndexedFromISR(waiter_, Config::I2C_NOTIFY_INDEX, &woken);
+  }
+  portYIELD_FROM_ISR(woken);
+}
+
+void I2cBus::i2c0IrqHandler()
+{
+  if (instances_[0] != nullptr)
+  {
+    instances_[0]->handleIrq();
+  }
+}
+
+void I2cBus::i2c1IrqHandler()
+{
+  if (instances_[1] != nullptr)
+  {
+    instances_[1]->handleIrq();
+  }
+}
@@ -1,13 +1,14 @@
 #include "LightSensor.hpp"
+#include "Common.hpp"
+#include "Config.hpp"
+#include "I2cBus.hpp"
 #include "Types.hpp"
 
-#include <hardware/i2c.h>
-#include <pico/time.h>
-
 #include <array>
 #include <cstdint>
 #include <cstdio>
 #include <optional>
+#include <span>
 
 namespace
 {
@@ -16,7 +17,7 @@ inline constexpr float CORRECTION_FACTOR = 1.0F;
 
 }  // namespace
 
-LightSensor::LightSensor(i2c_inst_t* i2c, const uint8_t address) : i2c_(i2c), address_(address)
+LightSensor::LightSensor(I2cBus* bus, const uint8_t address) : bus_(bus), address_(address)
 {
 }
 
@@ -27,9 +28,9 @@ auto LightSensor::init() -> bool
     return true;
   }
 
-  if (i2c_ == nullptr) [[unlikely]]
+  if (bus_ == nullptr) [[unlikely]]
   {
-    printf("[LightSensor] ERROR: Missing I2C instance\n");
+    printf("[LightSensor] ERROR: Missing I2C bus\n");
     return false;
   }
 
@@ -39,27 +40,51 @@ auto LightSensor::init() -> bool
     return false;
   }
 
-  if (not writeCommand(CONT_HIGH_RES_MODE_CMD)) [[unlikely]]
+  if (not writeCommand(POWER_DOWN_CMD)) [[unlikely]]
   {
-    printf("[LightSensor] Mode set failed\n");
+    printf("[LightSensor] Power down failed\n");
     return false;
   }
 
-  sleep_ms(200);
   initialized_ = true;
   return true;
 }
 
 auto LightSensor::read() -> std::optional<LightLevelData>
+{
+  if (not startMeasurement()) [[unlikely]]
+  {
+    return std::nullopt;
+  }
+  Utils::delayMs(Config::LIGHT_SENSOR_MEASURE_MS);
+  return collect();
+}
+
+auto LightSensor::startMeasurement() -> bool
 {
   if (not initialized_ and not init()) [[unlikely]]
+  {
+    return false;
+  }
+
+  if (not writeCommand(POWER_ON_CMD) or not writeCommand(ONE_TIME_HIGH_RES_MODE_CMD)) [[unlikely]]
+  {
+    printf("[LightSensor] Failed to start measurement\n");
+    initialized_ = false;
+    return false;
+  }
+  return true;
+}
+
+auto LightSensor::collect() -> std::optional<LightLevelData>
+{
+  if (not initialized_) [[unlikely]]
   {
     return std::nullopt;
   }
 
   std::array<uint8_t, 2> buffer{};
-  const auto             count = i2c_read_blocking(i2c_, address_, buffer.data(), buffer.size(), false);
-  if (count != static_cast<int>(buffer.size())) [[unlikely]]
+  if (not bus_->read(address_, buffer)) [[unlikely]]
   {
     initialized_ = false;
     return std::nullopt;
@@ -77,5 +102,5 @@ auto LightSensor::read() -> std::optional<LightLevelData>
 
 auto LightSensor::writeCommand(const uint8_t command) -> bool
 {
-  return i2c_write_blocking(i2c_, address_, &command, 1, false) == 1;
+  return bus_->write(address_, std::span(&command, 1));
 }
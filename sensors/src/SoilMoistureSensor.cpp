@@ -1,21 +1,45 @@
 #include "SoilMoistureSensor.hpp"
+#include "Common.hpp"
 #include "Config.hpp"
+#include "Format.hpp"
 #include "Types.hpp"
 
 #include <hardware/adc.h>
+#include <hardware/dma.h>
 #include <hardware/gpio.h>
-#include <pico/time.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <optional>
+#include <span>
+
+namespace
+{
+
+inline constexpr uint32_t ADC_CLOCK_HZ = 48'000'000;
+inline constexpr float    ADC_CLKDIV   = (ADC_CLOCK_HZ / Config::SOIL_MOISTURE_SAMPLE_RATE_HZ) - 1U;
+inline constexpr uint32_t CAPTURE_MS =
+  ((Config::SOIL_MOISTURE_SAMPLE_COUNT * 1'000U) + Config::SOIL_MOISTURE_SAMPLE_RATE_HZ - 1U) /
+  Config::SOIL_MOISTURE_SAMPLE_RATE_HZ;
+
+}  // namespace
 
 SoilMoistureSensor::SoilMoistureSensor(const uint8_t adcPin, const uint8_t adcChannel, const uint8_t powerPin)
   : adcPin_(adcPin), adcChannel_(adcChannel), powerPin_(powerPin)
 {
 }
 
+SoilMoistureSensor::~SoilMoistureSensor()
+{
+  if (dmaChannel_ >= 0)
+  {
+    dma_channel_unclaim(static_cast<uint>(dmaChannel_));
+  }
+}
+
 auto SoilMoistureSensor::init() -> bool
 {
   if (initialized_)
@@ -30,28 +54,64 @@ auto SoilMoistureSensor::init() -> bool
   gpio_set_dir(powerPin_, GPIO_OUT);
   gpio_put(powerPin_, false);
 
+  dmaChannel_ = dma_claim_unused_channel(false);
+  if (dmaChannel_ < 0) [[unlikely]]
+  {
+    printf("[SoilMoistureSensor] WARNING: No free DMA channel, sampling ADC by polling\n");
+  }
+
   initialized_ = true;
   return initialized_;
 }
 
 auto SoilMoistureSensor::read() -> std::optional<SoilMoistureData>
 {
-  if (not initialized_ and not init()) [[unlikely]]
+  if (not powerUp()) [[unlikely]]
   {
     return std::nullopt;
   }
+  Utils::delayMs(Config::SOIL_MOISTURE_POWER_UP_MS);
+  return collect();
+}
 
-  SoilMoistureData data{};
+auto SoilMoistureSensor::powerUp() -> bool
+{
+  if (not initialized_ and not init()) [[unlikely]]
+  {
+    return false;
+  }
 
   gpio_put(powerPin_, true);
-  sleep_ms(Config::SOIL_MOISTURE_POWER_UP_MS);
-  data.rawValue = readADC(adcChannel_);
+  powered_ = true;
+  return true;
+}
+
+auto SoilMoistureSensor::collect() -> std::optional<SoilMoistureData>
+{
+  if (not powered_) [[unlikely]]
+  {
+    return std::nullopt;
+  }
+
+  captureSamples();
   gpio_put(powerPin_, false);
+  powered_ = false;
+
+  const auto stats = computeStatistics(samples_, histogram_);
 
+  SoilMoistureData data{};
+  data.rawValue   = stats.median;
+  data.rawMean    = stats.trimmedMean;
+  data.noise      = stats.trimmedStdDev;
   data.percentage = 100.0F - mapToPercentage(data.rawValue, soilWetValue_, soilDryValue_);
   data.percentage = std::clamp(data.percentage, 0.0F, 100.0F);
-  data.valid      = true;
+  data.valid      = data.noise <= Config::SOIL_MOISTURE_MAX_NOISE;
 
+  if (not data.valid) [[unlikely]]
+  {
+    printf("[SoilMoistureSensor] Rejected noisy reading (median=%u, noise=%s)\n", data.rawValue,
+           Format::toDecimal(data.noise, 1).c_str());
+  }
   return data;
 }
 
@@ -62,10 +122,92 @@ void SoilMoistureSensor::calibrate(const uint16_t dryValue, const uint16_t wetVa
   printf("[SoilMoistureSensor] Calibrated: dry=%u, wet=%u\n", dryValue, wetValue);
 }
 
-auto SoilMoistureSensor::readADC(const uint8_t channel) -> uint16_t
+void SoilMoistureSensor::captureSamples()
+{
+  adc_select_input(adcChannel_);
+
+  if (dmaChannel_ < 0) [[unlikely]]
+  {
+    for (auto& sample : samples_)
+    {
+      sample = adc_read();
+    }
+    return;
+  }
+
+  const auto channel = static_cast<uint>(dmaChannel_);
+  auto       config  = dma_channel_get_default_config(channel);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+  channel_config_set_read_increment(&config, false);
+  channel_config_set_write_increment(&config, true);
+  channel_config_set_dreq(&config, DREQ_ADC);
+
+  adc_fifo_drain();
+  adc_fifo_setup(true, true, 1, false, false);
+  adc_set_clkdiv(ADC_CLKDIV);
+  dma_channel_configure(channel, &config, samples_.data(), &adc_hw->fifo, samples_.size(), true);
+  adc_run(true);
+
+  Utils::delayMs(CAPTURE_MS);
+  dma_channel_wait_for_finish_blocking(channel);
+
+  adc_run(false);
+  adc_fifo_drain();
+  adc_fifo_setup(false, false, 0, false, false);
+  adc_set_clkdiv(0.0F);
+}
+
+// One pass over the capture builds a 12-bit counting histogram and the range. Median, trimmed mean and the spread of
+// the trimmed samples are read off the occupied span of the histogram, which is cleared on the way for the next
+// capture. The spread ignores the trimmed tails, so a single wild conversion cannot reject an otherwise steady reading.
+auto SoilMoistureSensor::computeStatistics(const std::span<const uint16_t> samples,
+                                           const std::span<uint16_t, ADC_LEVELS> histogram) -> SampleStatistics
 {
-  adc_select_input(channel);
-  return adc_read();
+  uint32_t low  = ADC_LEVELS - 1;
+  uint32_t high = 0;
+  for (const auto sample : samples)
+  {
+    const uint32_t value = sample & (ADC_LEVELS - 1);
+    low                  = std::min(low, value);
+    high                 = std::max(high, value);
+    ++histogram[value];
+  }
+
+  const auto count      = samples.size();
+  const auto trim       = count / 8;
+  const auto kept       = count - (2 * trim);
+  const auto middle     = count / 2;
+  const auto lowMiddle  = ((count % 2) != 0) ? middle : middle - 1;
+  uint64_t   trimSum    = 0;
+  uint64_t   trimSquare = 0;
+  uint32_t   medianSum  = 0;
+  size_t     rank       = 0;
+  for (auto value = low; value <= high; ++value)
+  {
+    const auto first = rank;
+    const auto hits  = histogram[value];
+    histogram[value] = 0;
+    rank            += hits;
+
+    const auto keptFrom = std::max(first, trim);
+    const auto keptTo   = std::min(rank, count - trim);
+    if (keptTo > keptFrom)
+    {
+      const auto weight  = static_cast<uint64_t>(keptTo - keptFrom);
+      trimSum           += weight * value;
+      trimSquare        += weight * value * value;
+    }
+    medianSum += ((first <= lowMiddle) and (lowMiddle < rank)) ? value : 0;
+    medianSum += ((first <= middle) and (middle < rank)) ? value : 0;
+  }
+
+  const auto variance = static_cast<float>((kept * trimSquare) - (trimSum * trimSum)) / static_cast<float>(kept * kept);
+
+  return {
+    .median        = static_cast<uint16_t>((medianSum + 1) / 2),
+    .trimmedMean   = static_cast<float>(trimSum) / static_cast<float>(kept),
+    .trimmedStdDev = std::sqrt(variance),
+  };
 }
 
 auto SoilMoistureSensor::mapToPercentage(const uint16_t value, const uint16_t minVal, const uint16_t maxVal) -> float
@@ -1,17 +1,17 @@
 #include "WaterLevelSensor.hpp"
 #include "Config.hpp"
+#include "I2cBus.hpp"
 #include "Types.hpp"
 
-#include <hardware/i2c.h>
-
 #include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdio>
 #include <optional>
+#include <span>
 
-WaterLevelSensor::WaterLevelSensor(i2c_inst_t* i2c, const uint8_t lowAddress, const uint8_t highAddress)
-  : i2c_(i2c), lowAddress_(lowAddress), highAddress_(highAddress)
+WaterLevelSensor::WaterLevelSensor(I2cBus* bus, const uint8_t lowAddress, const uint8_t highAddress)
+  : bus_(bus), lowAddress_(lowAddress), highAddress_(highAddress)
 {
 }
 
@@ -21,9 +21,9 @@ auto WaterLevelSensor::init() -> bool
   {
     return true;
   }
-  if (i2c_ == nullptr) [[unlikely]]
+  if (bus_ == nullptr) [[unlikely]]
   {
-    printf("[WaterLevelSensor] ERROR: Missing I2C instance\n");
+    printf("[WaterLevelSensor] ERROR: Missing I2C bus\n");
     return false;
   }
   initialized_ = true;
@@ -39,10 +39,10 @@ auto WaterLevelSensor::read() -> std::optional<WaterLevelData>
 
   std::array<uint8_t, TOTAL_SECTIONS> sensorData{};
 
-  const auto retLow  = i2c_read_blocking(i2c_, lowAddress_, sensorData.data(), LOW_SECTIONS, false);
-  const auto retHigh = i2c_read_blocking(i2c_, highAddress_, &sensorData[LOW_SECTIONS], HIGH_SECTIONS, false);
+  const auto lowOk  = bus_->read(lowAddress_, std::span(sensorData).first(LOW_SECTIONS));
+  const auto highOk = bus_->read(highAddress_, std::span(sensorData).subspan(LOW_SECTIONS, HIGH_SECTIONS));
 
-  if ((retLow < 0) and (retHigh < 0)) [[unlikely]]
+  if (not lowOk and not highOk) [[unlikely]]
   {
     printf("[WaterLevelSensor] I2C error: sensor did not respond\n");
     return std::nullopt;
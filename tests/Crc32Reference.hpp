@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Crc32.hpp"
+
+#include <cstdint>
+#include <span>
+
+// Bit-at-a-time CRC-32, the reference both the table-driven and the DMA sniffer paths are checked against.
+namespace Crc32Reference
+{
+
+inline auto bitwise(const std::span<const uint8_t> data, const uint32_t crc = 0) -> uint32_t
+{
+  auto state = ~crc;
+  for (const auto byte : data)
+  {
+    state ^= byte;
+    for (int32_t bit = 0; bit < 8; ++bit)
+    {
+      state = (state >> 1U) ^ (Crc32::POLYNOMIAL & -(state & 1U));
+    }
+  }
+  return ~state;
+}
+
+}  // namespace Crc32Reference
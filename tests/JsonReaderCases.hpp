@@ -0,0 +1,133 @@
+#pragma once
+
+#include "JsonReader.hpp"
+#include "TestData.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+// Fixed vectors, the config body used as fuzz seed and benchmark input, and the mutator, shared by the firmware test
+// and the host fuzz and benchmark targets.
+namespace JsonReaderCases
+{
+
+inline constexpr std::string_view CONFIG_BODY =
+  R"({"wifi_ssid":"Greenhouse","wifi_pass":"p\"a\\ss\u00e9","ap_ssid":"SmartPlant-Setup","ap_pass":"plant1234",)"
+  R"("mqtt_host":"192.168.1.10","mqtt_port":"1883","mqtt_client_id":"smart-plant","mqtt_user":"",)"
+  R"("mqtt_pass":"","mqtt_prefix":"homeassistant","mqtt_topic":"smart_plant","mqtt_interval":"60",)"
+  R"("sensor_interval":"5","irrigation_mode":"2"})";
+
+struct Vector
+{
+  std::string_view json;
+  JsonError        error;
+  size_t           members;
+};
+
+inline constexpr std::array<Vector, 16> VECTORS = {
+  {
+   {R"({})", JsonError::NONE, 0},
+   {R"( { "a" : 1 } )", JsonError::NONE, 1},
+   {R"({"a":-0.5e+3,"b":true,"c":false,"d":null})", JsonError::NONE, 4},
+   {R"({"a":"\ud83d\ude00\n\t\/"})", JsonError::NONE, 1},
+   {R"({"a":[1,{"b":[2.5,"x]"]}],"c":{}})", JsonError::NONE, 2},
+   {R"({"a":1,})", JsonError::UNEXPECTED_CHARACTER, 1},
+   {R"({"a":1)", JsonError::UNEXPECTED_END, 0},
+   {R"({"a":01})", JsonError::INVALID_NUMBER, 0},
+   {R"({"a":1.})", JsonError::INVALID_NUMBER, 0},
+   {R"({"a":"\x"})", JsonError::INVALID_ESCAPE, 0},
+   {R"({"a":"\ud83d"})", JsonError::INVALID_ESCAPE, 0},
+   {R"({"a":tru})", JsonError::UNEXPECTED_CHARACTER, 0},
+   {R"({"a":[1,2}})", JsonError::UNEXPECTED_CHARACTER, 0},
+   {R"({"a":1} x)", JsonError::UNEXPECTED_CHARACTER, 1},
+   {R"([1,2])", JsonError::UNEXPECTED_CHARACTER, 0},
+   {R"({"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa":1})", JsonError::TOO_LONG, 0},
+   }
+};
+
+inline auto countMembers(const std::string_view json, JsonError& error) -> size_t
+{
+  JsonObjectReader reader(json);
+  JsonMember       member;
+  size_t           count = 0;
+  while (reader.next(member))
+  {
+    ++count;
+  }
+  error = reader.error();
+  return count;
+}
+
+inline auto runVectors() -> uint32_t
+{
+  uint32_t failures = 0;
+  for (const auto& vector : VECTORS)
+  {
+    auto       error   = JsonError::NONE;
+    const auto members = countMembers(vector.json, error);
+    if ((error != vector.error) or (members != vector.members))
+    {
+      printf("  FAIL %.*s: %s, %zu members\n", static_cast<int>(vector.json.size()), vector.json.data(),
+             JsonObjectReader::errorString(error), members);
+      ++failures;
+    }
+  }
+
+  JsonObjectReader reader(R"({"s":"\u00e9\ud83d\ude00"})");
+  JsonMember       member;
+  if (not reader.next(member) or (member.text != "\xc3\xa9\xf0\x9f\x98\x80"))
+  {
+    printf("  FAIL unicode escape decoding\n");
+    ++failures;
+  }
+  return failures;
+}
+
+inline constexpr size_t CONFIG_BODY_MEMBERS = 14;
+
+// Overwrites a few bytes of the config body with JSON-significant characters and sometimes truncates it; returns the
+// length of the mutated input.
+inline auto mutate(const std::span<char, CONFIG_BODY.size()> buffer, uint32_t& seed) -> size_t
+{
+  using TestData::nextRandom;
+
+  constexpr std::string_view ALPHABET = "{}[]\":,\\-+.0123456789eEtrufalsn u\x01\xff";
+
+  CONFIG_BODY.copy(buffer.data(), buffer.size());
+  const auto mutations = 1U + (nextRandom(seed) % 4U);
+  for (uint32_t m = 0; m < mutations; ++m)
+  {
+    buffer[nextRandom(seed) % buffer.size()] = ALPHABET[nextRandom(seed) % ALPHABET.size()];
+  }
+  return buffer.size() - (((nextRandom(seed) % 8U) == 0) ? (nextRandom(seed) % buffer.size()) : 0);
+}
+
+// Parses one input to the end and checks the reader's own invariants; returns false on a violation.
+inline auto checkInvariants(const std::string_view json, bool& accepted) -> bool
+{
+  JsonObjectReader reader(json);
+  JsonMember       member;
+  while (reader.next(member))
+  {
+    if ((member.key.size() > JsonObjectReader::MAX_KEY_LENGTH) or
+        (member.text.size() > std::max(JsonObjectReader::MAX_VALUE_LENGTH, json.size())))
+    {
+      printf("  Oversized member\n");
+      return false;
+    }
+  }
+  if ((reader.error() != JsonError::NONE) and (reader.errorOffset() > json.size()))
+  {
+    printf("  Error offset %zu past %zu\n", reader.errorOffset(), json.size());
+    return false;
+  }
+  accepted = reader.error() == JsonError::NONE;
+  return true;
+}
+
+}  // namespace JsonReaderCases
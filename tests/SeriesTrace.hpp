@@ -0,0 +1,126 @@
+#pragma once
+
+#include "PackedSensorRecord.hpp"
+#include "SeriesCodec.hpp"
+#include "TestData.hpp"
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+// Sensor traces and a block-by-block round trip through the series codec, shared by the firmware benchmark and the
+// host test.
+namespace SeriesTrace
+{
+
+inline constexpr uint32_t SAMPLE_PERIOD_S = 300;
+
+struct Sample
+{
+  uint32_t           time = 0;
+  PackedSensorRecord record;
+};
+
+struct RoundTrip
+{
+  uint32_t mismatches = 0;
+  size_t   blocks     = 0;
+  size_t   bytes      = 0;
+};
+
+// Five-minute readings from an indoor plant, with the odd timestamp a second late.
+inline void makeIndoor(const std::span<Sample> trace, const uint32_t seed)
+{
+  TestData::IndoorPlant plant(seed, 0.025F);
+  for (size_t i = 0; i < trace.size(); ++i)
+  {
+    const auto time = (static_cast<uint32_t>(i) * SAMPLE_PERIOD_S) + (((plant.random() % 16) == 0) ? 1 : 0);
+    const auto data = plant.sample(static_cast<float>(time) / 3'600.0F);
+
+    trace[i].time   = time;
+    trace[i].record = PackedSensorRecord::from(data, plant.watering());
+  }
+}
+
+// Worst case: every field random, flags flipping and timestamps jumping in both directions.
+inline void makeNoise(const std::span<Sample> trace, uint32_t seed)
+{
+  using TestData::nextRandom;
+
+  uint32_t time = 1'000'000;
+  for (auto& sample : trace)
+  {
+    time += (nextRandom(seed) % 8 == 0) ? nextRandom(seed) : nextRandom(seed) % 4'000;
+
+    sample.time               = time;
+    sample.record.temperature = static_cast<int16_t>(nextRandom(seed));
+    sample.record.humidity    = static_cast<uint16_t>(nextRandom(seed));
+    sample.record.pressure    = static_cast<uint16_t>(nextRandom(seed));
+    sample.record.soil        = static_cast<uint16_t>(nextRandom(seed));
+    sample.record.water       = static_cast<uint16_t>(nextRandom(seed));
+    sample.record.lux         = static_cast<uint16_t>(nextRandom(seed));
+    sample.record.flags       = static_cast<uint8_t>(nextRandom(seed));
+  }
+}
+
+inline auto matches(const Sample& expected, const uint32_t time, const PackedSensorRecord& record) -> bool
+{
+  const auto& e = expected.record;
+  return (time == expected.time) and (record.temperature == e.temperature) and (record.humidity == e.humidity) and
+         (record.pressure == e.pressure) and (record.soil == e.soil) and (record.water == e.water) and
+         (record.lux == e.lux) and (record.flags == e.flags);
+}
+
+// Decodes one block and checks it against the samples it was built from, including that nothing follows them.
+inline auto verifyBlock(const std::span<const uint8_t> block, const std::span<const Sample> expected) -> uint32_t
+{
+  uint32_t           mismatches = 0;
+  uint32_t           time       = 0;
+  PackedSensorRecord record;
+  SeriesDecoder      decoder(block, expected.size());
+  for (const auto& sample : expected)
+  {
+    if (not decoder.next(time, record) or not matches(sample, time, record))
+    {
+      printf("  Mismatch at sample time %lu\n", static_cast<unsigned long>(sample.time));
+      ++mismatches;
+    }
+  }
+  if (decoder.next(time, record))
+  {
+    printf("  Decoder ran past %zu samples\n", expected.size());
+    ++mismatches;
+  }
+  return mismatches;
+}
+
+// Packs the trace into as many blocks as it takes and decodes every block back.
+inline auto roundTrip(const std::span<const Sample> trace, const std::span<uint8_t> block) -> RoundTrip
+{
+  RoundTrip     result;
+  SeriesEncoder encoder(block);
+  size_t        first = 0;
+  for (size_t i = 0; i <= trace.size(); ++i)
+  {
+    if ((i < trace.size()) and encoder.append(trace[i].time, trace[i].record))
+    {
+      continue;
+    }
+    result.mismatches += verifyBlock(block, trace.subspan(first, encoder.count()));
+    result.bytes      += encoder.bytes();
+    ++result.blocks;
+
+    first = i;
+    encoder.reset(block);
+    if ((i < trace.size()) and not encoder.append(trace[i].time, trace[i].record))
+    {
+      printf("  Sample %zu does not fit an empty block\n", i);
+      ++result.mismatches;
+    }
+  }
+  return result;
+}
+
+}  // namespace SeriesTrace
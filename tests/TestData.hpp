@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+// Seeded sample generators shared by the tests. Nothing here touches the hardware, so the host tests replay the same
+// traces as the firmware images.
+namespace TestData
+{
+
+inline auto nextRandom(uint32_t& state) -> uint32_t
+{
+  state ^= state << 13U;
+  state ^= state >> 17U;
+  state ^= state << 5U;
+  return state;
+}
+
+inline auto noise(uint32_t& state, const float amplitude) -> float
+{
+  return amplitude * ((static_cast<float>(nextRandom(state) % 2'001) / 1'000.0F) - 1.0F);
+}
+
+// An indoor plant: diurnal temperature, humidity and light, slow pressure drift, soil drying out between waterings
+// and a tank that drops a step per watering.
+class IndoorPlant final
+{
+public:
+  IndoorPlant(const uint32_t seed, const float dryingPerSample) : seed_(seed), drying_(dryingPerSample)
+  {
+  }
+
+  // Takes the next reading, `hours` after the start of the trace.
+  auto sample(const float hours) -> SensorData
+  {
+    const auto day = std::sin((2.0F * std::numbers::pi_v<float> * hours / 24.0F) - (std::numbers::pi_v<float> / 2.0F));
+
+    watering_ = soil_ < 35.0F;
+    if (watering_)
+    {
+      soil_  = 65.0F;
+      water_ = std::max(0.0F, water_ - 5.0F);
+    }
+    soil_ -= drying_ + noise(seed_, drying_ * 0.4F);
+
+    SensorData data;
+    data.environment = {
+      .temperature = 22.0F + (2.0F * day) + noise(seed_, 0.03F),
+      .humidity    = 48.0F - (6.0F * day) + noise(seed_, 0.2F),
+      .pressure    = 1'013.0F + (4.0F * std::sin(hours / 40.0F)) + noise(seed_, 0.05F),
+      .valid       = true,
+    };
+    data.light = {.lux = std::max(0.0F, 900.0F * day) + noise(seed_, 2.0F), .valid = true};
+    data.soil  = {.percentage = soil_, .valid = true};
+    data.water = {.percentage = water_, .valid = true};
+    return data;
+  }
+
+  auto watering() const -> bool
+  {
+    return watering_;
+  }
+
+  // The plant's random stream, for callers that jitter timestamps from the same seed.
+  auto random() -> uint32_t
+  {
+    return nextRandom(seed_);
+  }
+
+private:
+  uint32_t seed_     = 0;
+  float    drying_   = 0.0F;
+  float    soil_     = 62.0F;
+  float    water_    = 100.0F;
+  bool     watering_ = false;
+};
+
+}  // namespace TestData
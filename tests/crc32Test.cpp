@@ -0,0 +1,113 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "Crc32.hpp"
+#include "Crc32Reference.hpp"
+#include "TestData.hpp"
+#include "Types.hpp"
+
+#include <pico/stdio.h>
+#include <pico/time.h>
+
+namespace
+{
+
+inline constexpr uint32_t ITERATIONS      = 1'000;
+inline constexpr uint32_t RANDOM_VECTORS  = 2'000;
+inline constexpr size_t   BENCHMARK_BYTES = 4'096;
+
+std::array<uint8_t, BENCHMARK_BYTES + 8> buffer{};
+
+volatile uint32_t sink = 0;
+
+using TestData::nextRandom;
+
+using Crc32Reference::bitwise;
+
+auto verify() -> uint32_t
+{
+  uint32_t mismatches = 0;
+  uint32_t seed       = 0x12'34'56'78U;
+  for (auto& byte : buffer)
+  {
+    byte = static_cast<uint8_t>(nextRandom(seed));
+  }
+
+  for (uint32_t i = 0; i < RANDOM_VECTORS; ++i)
+  {
+    const auto offset = nextRandom(seed) % 8;
+    const auto length = nextRandom(seed) % (BENCHMARK_BYTES + 1);
+    const auto split  = (length == 0) ? 0 : nextRandom(seed) % length;
+    const auto data   = std::span<const uint8_t>(buffer).subspan(offset, length);
+
+    const auto expected = bitwise(data);
+    const auto software = Crc32::software(data);
+    const auto hardware = Crc32::hardware(data);
+    const auto chained  = Crc32::hardware(data.subspan(split), Crc32::software(data.first(split)));
+    if ((software != expected) or (hardware != expected) or (chained != expected))
+    {
+      printf("  Mismatch at offset %lu length %lu: bitwise=%08lx software=%08lx hardware=%08lx chained=%08lx\n",
+             static_cast<unsigned long>(offset), static_cast<unsigned long>(length),
+             static_cast<unsigned long>(expected), static_cast<unsigned long>(software),
+             static_cast<unsigned long>(hardware), static_cast<unsigned long>(chained));
+      ++mismatches;
+    }
+  }
+  return mismatches;
+}
+
+template <typename Crc>
+auto benchmark(const size_t size, Crc crc) -> uint64_t
+{
+  const auto data  = std::span<const uint8_t>(buffer).first(size);
+  const auto start = time_us_64();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    sink = crc(data);
+  }
+  return time_us_64() - start;
+}
+
+void report(const char* const name, const size_t size, const uint64_t elapsedUs)
+{
+  const auto perCallNs = (elapsedUs * 1'000U) / ITERATIONS;
+  const auto mbPerS    = (elapsedUs == 0) ? 0 : (static_cast<uint64_t>(size) * ITERATIONS) / elapsedUs;
+  printf("  %-10s %5zu B %8llu ns/call %5llu MB/s\n", name, size, static_cast<unsigned long long>(perCallNs),
+         static_cast<unsigned long long>(mbPerS));
+}
+
+void runBenchmarks(const size_t size)
+{
+  report("bitwise", size, benchmark(size, [](const auto data) { return bitwise(data); }));
+  report("software", size, benchmark(size, [](const auto data) { return Crc32::software(data); }));
+  report("hardware", size, benchmark(size, [](const auto data) { return Crc32::hardware(data); }));
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  stdio_init_all();
+  sleep_ms(5'000);
+  printf("Starting CRC32 test...\n");
+
+  if (not Crc32::init())
+  {
+    printf("DMA sniffer unavailable, hardware path falls back to software\n");
+  }
+
+  while (true)
+  {
+    printf("Verification: %lu mismatches in %lu vectors\n", static_cast<unsigned long>(verify()),
+           static_cast<unsigned long>(RANDOM_VECTORS));
+    runBenchmarks(sizeof(SystemConfig));
+    runBenchmarks(BENCHMARK_BYTES);
+    printf("\n");
+    sleep_ms(5'000);
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+#include "Format.hpp"
+#include "JsonWriter.hpp"
+
+#include <pico/stdio.h>
+#include <pico/time.h>
+
+namespace
+{
+
+inline constexpr uint32_t ITERATIONS = 10'000;
+
+inline constexpr std::array<float, 8> SAMPLE_VALUES = {
+  0.0F, 21.37F, -4.5F, 1013.25F, 55.555F, 99.996F, 12'345.67F, 0.004F,
+};
+
+inline constexpr const char* PAYLOAD_FORMAT =
+  "{\"temperature\":%.2f,\"humidity\":%.2f,\"pressure\":%.2f,\"soil_moisture\":%.2f,\"light_lux\":%.2f,"
+  "\"light_available\":%s,\"water_level\":%.2f,\"water_level_available\":%s,\"watering\":%s}";
+
+volatile size_t sink = 0;
+
+auto benchmarkSnprintf() -> uint64_t
+{
+  std::array<char, 32> buffer{};
+  const auto           start = time_us_64();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    const auto value = SAMPLE_VALUES.at(i % SAMPLE_VALUES.size());
+    sink             = std::snprintf(buffer.data(), buffer.size(), "%.2f", static_cast<double>(value));
+  }
+  return time_us_64() - start;
+}
+
+auto benchmarkFormatFixed() -> uint64_t
+{
+  std::array<char, 32> buffer{};
+  const auto           start = time_us_64();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    const auto value = SAMPLE_VALUES.at(i % SAMPLE_VALUES.size());
+    sink             = Format::formatFixed(buffer, value, 2);
+  }
+  return time_us_64() - start;
+}
+
+auto benchmarkPayloadSnprintf() -> uint64_t
+{
+  std::array<char, 320> buffer{};
+  const auto            start = time_us_64();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    const auto value = SAMPLE_VALUES.at(i % SAMPLE_VALUES.size());
+    sink             = std::snprintf(buffer.data(), buffer.size(), PAYLOAD_FORMAT, static_cast<double>(value),
+                                     static_cast<double>(value), static_cast<double>(value), static_cast<double>(value),
+                                     static_cast<double>(value), "true", static_cast<double>(value), "true", "false");
+  }
+  return time_us_64() - start;
+}
+
+auto benchmarkPayloadJsonWriter() -> uint64_t
+{
+  std::array<char, 320> buffer{};
+  const auto            start = time_us_64();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    const auto value = SAMPLE_VALUES.at(i % SAMPLE_VALUES.size());
+    JsonWriter json(buffer);
+    json.beginObject()
+      .field("temperature", value, 2)
+      .field("humidity", value, 2)
+      .field("pressure", value, 2)
+      .field("soil_moisture", value, 2)
+      .field("light_lux", value, 2)
+      .field("light_available", true)
+      .field("water_level", value, 2)
+      .field("water_level_available", true)
+      .field("watering", false)
+      .endObject();
+    sink = json.size();
+  }
+  return time_us_64() - start;
+}
+
+auto verifyAgainstSnprintf() -> uint32_t
+{
+  uint32_t mismatches = 0;
+  for (const auto value : SAMPLE_VALUES)
+  {
+    std::array<char, 32> expected{};
+    const auto           length = std::snprintf(expected.data(), expected.size(), "%.2f", static_cast<double>(value));
+    const auto           actual = Format::toDecimal(value, 2);
+    if (actual.view() != std::string_view(expected.data(), static_cast<size_t>(length)))
+    {
+      printf("  Mismatch: snprintf=%s format=%s\n", expected.data(), actual.c_str());
+      ++mismatches;
+    }
+  }
+  return mismatches;
+}
+
+void report(const char* const name, const uint64_t elapsedUs)
+{
+  const auto perCallNs = (elapsedUs * 1'000U) / ITERATIONS;
+  printf("  %-22s %8llu us total, %6llu ns/call\n", name, static_cast<unsigned long long>(elapsedUs),
+         static_cast<unsigned long long>(perCallNs));
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  stdio_init_all();
+  sleep_ms(5'000);
+  printf("Starting format benchmark (%u iterations)...\n", ITERATIONS);
+
+  while (true)
+  {
+    printf("Verification: %u mismatches\n", verifyAgainstSnprintf());
+    report("snprintf %.2f", benchmarkSnprintf());
+    report("Format::formatFixed", benchmarkFormatFixed());
+    report("payload snprintf", benchmarkPayloadSnprintf());
+    report("payload JsonWriter", benchmarkPayloadJsonWriter());
+    printf("\n");
+    sleep_ms(5'000);
+  }
+
+  return 0;
+}
@@ -0,0 +1,210 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "Common.hpp"
+#include "Config.hpp"
+#include "HistoryStore.hpp"
+#include "PackedSensorRecord.hpp"
+#include "SeriesTrace.hpp"
+#include "TestData.hpp"
+#include "Types.hpp"
+
+#include <pico/stdio.h>
+#include <pico/time.h>
+
+namespace
+{
+
+inline constexpr uint32_t FAST_INTERVAL_MS     = 5'000;
+inline constexpr uint32_t FAST_SAMPLES         = 2 * Config::History::FLUSH_AGE_SAMPLES;
+inline constexpr uint32_t DEFAULT_SAMPLES      = 48;
+inline constexpr uint32_t MIN_SAMPLES_PER_PAGE = 32;
+
+struct Result
+{
+  HistoryStats committed;
+  uint64_t     elapsedUs  = 0;
+  uint32_t     samples    = 0;
+  uint32_t     mismatches = 0;
+  bool         stored     = true;
+};
+
+std::array<SeriesTrace::Sample, FAST_SAMPLES> appended{};
+
+// An indoor plant read at a fixed interval. Timestamps jitter by a few hundred milliseconds like the sensor
+// task's loop.
+auto makeSample(TestData::IndoorPlant& plant, const uint32_t index, const uint32_t intervalMs, const uint32_t timestamp)
+  -> SensorData
+{
+  const auto hours = static_cast<float>(index) * static_cast<float>(intervalMs) / 3'600'000.0F;
+
+  auto data      = plant.sample(hours);
+  data.timestamp = timestamp + (plant.random() % 400);
+  return data;
+}
+
+auto since(const HistoryStats& before, const HistoryStats& after) -> HistoryStats
+{
+  return {
+    .commits = after.commits - before.commits,
+    .pages   = after.pages - before.pages,
+    .samples = after.samples - before.samples,
+  };
+}
+
+// Reads the round back through forEach(), which walks committed pages in flash and then the open batch, and compares
+// every sample with what was appended.
+auto readBack(const std::span<const SeriesTrace::Sample> expected) -> uint32_t
+{
+  uint32_t   mismatches = 0;
+  size_t     index      = 0;
+  const auto visited    = HistoryStore::getInstance().forEach(
+    expected.front().time, expected.back().time,
+    [&](const uint32_t time, const PackedSensorRecord& record)
+    {
+      if ((index >= expected.size()) or not SeriesTrace::matches(expected[index], time, record))
+      {
+        printf("  Read back mismatch at sample %zu (time %lu)\n", index, static_cast<unsigned long>(time));
+        ++mismatches;
+      }
+      ++index;
+      return true;
+    });
+  if (visited != expected.size())
+  {
+    printf("  Read back %zu of %zu samples\n", visited, expected.size());
+    ++mismatches;
+  }
+  return mismatches;
+}
+
+auto appendAtCadence(const uint32_t intervalMs, const uint32_t samples, uint32_t& timestamp, uint32_t& seed) -> Result
+{
+  auto& history = HistoryStore::getInstance();
+  history.setSampleInterval(intervalMs);
+
+  // Soil dries by 0.3 % an hour whatever the cadence.
+  const auto            before = history.stats();
+  TestData::IndoorPlant plant(TestData::nextRandom(seed), 0.3F * static_cast<float>(intervalMs) / 3'600'000.0F);
+
+  Result   result;
+  uint64_t appendUs = 0;
+  result.samples    = samples;
+  for (uint32_t i = 0; i < samples; ++i)
+  {
+    const auto data = makeSample(plant, i, intervalMs, timestamp);
+    appended.at(i)  = {.time = history.toHistoryTime(data.timestamp), .record = PackedSensorRecord::from(data, false)};
+
+    const auto start = time_us_64();
+    result.stored    = history.append(data, false) and result.stored;
+    appendUs        += time_us_64() - start;
+    timestamp       += intervalMs;
+  }
+  result.elapsedUs = appendUs;
+  result.committed = since(before, history.stats());
+
+  // Start the next round from an empty batch so its counts cover commits made by append() only.
+  result.stored     = history.flush() and result.stored;
+  result.mismatches = readBack(std::span(appended).first(samples));
+  return result;
+}
+
+auto report(const Result& result) -> bool
+{
+  const auto& committed  = result.committed;
+  const auto  perPage    = (committed.pages == 0) ? 0 : committed.samples / committed.pages;
+  const auto  flashBytes = static_cast<double>(committed.pages * FLASH_PAGE_SIZE);
+  const auto  rawBytes   = static_cast<double>(committed.samples * sizeof(SensorData));
+
+  printf("  %lu samples in %lu pages over %lu commits, %lu samples/page, %4.1fx vs SensorData\n",
+         static_cast<unsigned long>(committed.samples), static_cast<unsigned long>(committed.pages),
+         static_cast<unsigned long>(committed.commits), static_cast<unsigned long>(perPage),
+         (flashBytes == 0.0) ? 0.0 : rawBytes / flashBytes);
+  printf("  append: %llu us for %lu samples\n", static_cast<unsigned long long>(result.elapsedUs),
+         static_cast<unsigned long>(result.samples));
+
+  if (not result.stored)
+  {
+    printf("  Flash write failed\n");
+  }
+  if (result.mismatches > 0)
+  {
+    printf("  %lu samples did not read back as appended\n", static_cast<unsigned long>(result.mismatches));
+  }
+  return result.stored and (result.mismatches == 0);
+}
+
+// Readings arriving fast enough to fill a batch well within the age limit commit as full batches of full pages.
+auto checkBatched(const Result& result) -> bool
+{
+  const auto& committed = result.committed;
+  const auto  perPage   = (committed.pages == 0) ? 0 : committed.samples / committed.pages;
+  const auto  fullBatches =
+    (committed.commits > 0) and (committed.pages == (committed.commits * HistoryStore::BATCH_PAGES));
+
+  auto passed = report(result);
+  if (not fullBatches)
+  {
+    printf("  Committed a partial batch: expected %lu pages per commit\n",
+           static_cast<unsigned long>(HistoryStore::BATCH_PAGES));
+    passed = false;
+  }
+  if (perPage < MIN_SAMPLES_PER_PAGE)
+  {
+    printf("  Pages committed before filling: expected at least %lu samples/page\n",
+           static_cast<unsigned long>(MIN_SAMPLES_PER_PAGE));
+    passed = false;
+  }
+  return passed;
+}
+
+// Slow readings must not wait in RAM for a batch to fill: no more than MAX_FLUSH_AGE_MS of them stay uncommitted.
+auto checkBounded(const Result& result, const uint32_t intervalMs) -> bool
+{
+  const auto maxPending = (Config::History::MAX_FLUSH_AGE_MS / intervalMs) + 2;
+  const auto pending    = result.samples - result.committed.samples;
+
+  auto passed = report(result);
+  if (pending > maxPending)
+  {
+    printf("  %lu samples left uncommitted: expected at most %lu\n", static_cast<unsigned long>(pending),
+           static_cast<unsigned long>(maxPending));
+    passed = false;
+  }
+  return passed;
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  stdio_init_all();
+  sleep_ms(5'000);
+  printf("Starting history store test (overwrites the history region)...\n");
+
+  if (not HistoryStore::getInstance().init())
+  {
+    printf("History store unavailable\n");
+    return 1;
+  }
+
+  uint32_t timestamp = Utils::getTimeSinceBoot();
+  uint32_t seed      = 0x48'49'53'54U;
+  while (true)
+  {
+    constexpr auto slowMs = Config::DEFAULT_SENSOR_READ_INTERVAL_MS;
+
+    const auto batched = checkBatched(appendAtCadence(FAST_INTERVAL_MS, FAST_SAMPLES, timestamp, seed));
+    printf("Fast cadence (%lu ms): %s\n", static_cast<unsigned long>(FAST_INTERVAL_MS), batched ? "PASS" : "FAIL");
+
+    const auto bounded = checkBounded(appendAtCadence(slowMs, DEFAULT_SAMPLES, timestamp, seed), slowMs);
+    printf("Default cadence (%lu ms): %s\n", static_cast<unsigned long>(slowMs), bounded ? "PASS" : "FAIL");
+    printf("\n");
+    sleep_ms(5'000);
+  }
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "Crc32.hpp"
+#include "Crc32Reference.hpp"
+#include "TestData.hpp"
+#include "Types.hpp"
+
+namespace
+{
+
+inline constexpr uint32_t ITERATIONS      = 20'000;
+inline constexpr size_t   BENCHMARK_BYTES = 4'096;
+
+std::array<uint8_t, BENCHMARK_BYTES> buffer{};
+
+volatile uint32_t sink = 0;
+
+template <typename Crc>
+auto benchmark(const size_t size, Crc crc) -> uint32_t
+{
+  const auto data  = std::span<const uint8_t>(buffer).first(size);
+  uint32_t   last  = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    last = crc(data);
+    sink = last;
+  }
+  const auto elapsed   = std::chrono::steady_clock::now() - start;
+  const auto perCallNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                         static_cast<double>(ITERATIONS);
+  printf("  %5zu B %10.1f ns/call %8.1f MB/s\n", size, perCallNs, static_cast<double>(size) * 1'000.0 / perCallNs);
+  return last;
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  uint32_t seed = 0x12'34'56'78U;
+  for (auto& byte : buffer)
+  {
+    byte = static_cast<uint8_t>(TestData::nextRandom(seed));
+  }
+
+  auto matched = true;
+  for (const auto size : {sizeof(SystemConfig), BENCHMARK_BYTES})
+  {
+    printf("bitwise:\n");
+    const auto expected = benchmark(size, [](const auto data) { return Crc32Reference::bitwise(data); });
+    printf("software:\n");
+    const auto software = benchmark(size, [](const auto data) { return Crc32::software(data); });
+    matched             = (software == expected) and matched;
+  }
+
+  if (not matched)
+  {
+    printf("FAIL software CRC differs from the bitwise reference\n");
+    return 1;
+  }
+  return 0;
+}
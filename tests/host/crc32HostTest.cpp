@@ -0,0 +1,80 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+#include "Crc32.hpp"
+#include "Crc32Reference.hpp"
+#include "TestData.hpp"
+
+namespace
+{
+
+inline constexpr size_t   MAX_EXHAUSTIVE_LENGTH = 64;
+inline constexpr uint32_t RANDOM_VECTORS        = 20'000;
+inline constexpr size_t   MAX_RANDOM_LENGTH     = 4'096;
+
+std::array<uint8_t, MAX_RANDOM_LENGTH + 8> buffer{};
+
+auto check(const std::span<const uint8_t> data, const size_t offset, uint32_t& seed) -> bool
+{
+  const auto expected = Crc32Reference::bitwise(data);
+  const auto single   = Crc32::software(data);
+
+  // Three pieces, so the slicing loop restarts on a misaligned span with a non-zero seed.
+  const auto first   = (data.empty()) ? 0 : TestData::nextRandom(seed) % (data.size() + 1);
+  const auto second  = first + ((first == data.size()) ? 0 : TestData::nextRandom(seed) % (data.size() - first + 1));
+  const auto chained = Crc32::software(
+    data.subspan(second),
+    Crc32::software(data.subspan(first, second - first), Crc32::software(data.first(first))));
+
+  if ((single == expected) and (chained == expected))
+  {
+    return true;
+  }
+  printf("FAIL offset %zu length %zu split %zu/%zu: bitwise=%08lx software=%08lx chained=%08lx\n", offset,
+         data.size(), first, second, static_cast<unsigned long>(expected), static_cast<unsigned long>(single),
+         static_cast<unsigned long>(chained));
+  return false;
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  uint32_t seed = 0x12'34'56'78U;
+  for (auto& byte : buffer)
+  {
+    byte = static_cast<uint8_t>(TestData::nextRandom(seed));
+  }
+
+  uint32_t failures = 0;
+
+  constexpr std::string_view CHECK = "123456789";
+  if (Crc32::software(std::span(reinterpret_cast<const uint8_t*>(CHECK.data()), CHECK.size())) != 0xCB'F4'39'26U)
+  {
+    printf("FAIL check value\n");
+    ++failures;
+  }
+
+  // Every short length at every alignment covers each split between the 8-byte loop and the byte tail.
+  for (size_t offset = 0; offset < 8; ++offset)
+  {
+    for (size_t length = 0; length <= MAX_EXHAUSTIVE_LENGTH; ++length)
+    {
+      failures += check(std::span<const uint8_t>(buffer).subspan(offset, length), offset, seed) ? 0 : 1;
+    }
+  }
+
+  for (uint32_t i = 0; i < RANDOM_VECTORS; ++i)
+  {
+    const auto offset = TestData::nextRandom(seed) % 8;
+    const auto length = TestData::nextRandom(seed) % (MAX_RANDOM_LENGTH + 1);
+    failures         += check(std::span<const uint8_t>(buffer).subspan(offset, length), offset, seed) ? 0 : 1;
+  }
+
+  printf("%s: %lu failures\n", (failures == 0) ? "PASS" : "FAIL", static_cast<unsigned long>(failures));
+  return (failures == 0) ? 0 : 1;
+}
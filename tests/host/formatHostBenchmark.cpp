@@ -0,0 +1,233 @@
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+#include "Format.hpp"
+#include "JsonWriter.hpp"
+#include "TestData.hpp"
+
+namespace
+{
+
+inline constexpr uint32_t ITERATIONS   = 1'000'000;
+inline constexpr uint32_t SWEEP_VALUES = 2'000'000;
+
+inline constexpr std::array<float, 8> SAMPLE_VALUES = {
+  0.0F, 21.37F, -4.5F, 1013.25F, 55.555F, 99.996F, 12'345.67F, 0.004F,
+};
+
+inline constexpr const char* PAYLOAD_FORMAT =
+  "{\"temperature\":%.2f,\"humidity\":%.2f,\"pressure\":%.2f,\"soil_moisture\":%.2f,\"light_lux\":%.2f,"
+  "\"light_available\":%s,\"water_level\":%.2f,\"water_level_available\":%s,\"watering\":%s}";
+
+// Where the two are expected to part ways. snprintf rounds the exact binary value half to even and keeps the sign of
+// a negative value that rounds to zero; Format rounds half up in float arithmetic and prints zero unsigned.
+struct KnownDifference
+{
+  float            value    = 0.0F;
+  uint32_t         decimals = 0;
+  std::string_view format;
+  std::string_view snprintf;
+};
+
+inline constexpr std::array<KnownDifference, 5> KNOWN_DIFFERENCES = {{
+  {.value = 0.125F, .decimals = 2, .format = "0.13", .snprintf = "0.12"},
+  {.value = 2.5F, .decimals = 0, .format = "3", .snprintf = "2"},
+  {.value = -20.625F, .decimals = 2, .format = "-20.63", .snprintf = "-20.62"},
+  {.value = 0.5F, .decimals = 0, .format = "1", .snprintf = "0"},
+  {.value = -0.004F, .decimals = 2, .format = "0.00", .snprintf = "-0.00"},
+}};
+
+struct Comparison
+{
+  uint32_t mismatches = 0;
+  uint32_t ties       = 0;
+  uint32_t negZeros   = 0;
+};
+
+volatile size_t sink = 0;
+
+auto viaSnprintf(const std::span<char> out, const double value, const uint32_t decimals) -> std::string_view
+{
+  const auto length = std::snprintf(out.data(), out.size(), "%.*f", static_cast<int>(decimals), value);
+  return {out.data(), static_cast<size_t>(length)};
+}
+
+// Sorts one snprintf/Format disagreement into the two expected kinds; anything else is a bug in Format.
+void classify(Comparison& result, const float value, const uint32_t decimals, const std::string_view expected,
+              const std::string_view actual)
+{
+  if ((expected.front() == '-') and (expected.substr(1) == actual) and
+      (expected.find_first_not_of("-0.") == std::string_view::npos))
+  {
+    ++result.negZeros;
+    return;
+  }
+
+  // Format scales and rounds in float, so it only sees a tie to within a few float ulps of the scaled value.
+  const auto scale     = static_cast<double>(Format::POWERS_OF_TEN.at(decimals));
+  const auto scaled    = std::fabs(static_cast<double>(value)) * scale;
+  const auto tolerance = std::ldexp(scale, -22);
+  if (std::fabs(scaled - std::floor(scaled) - 0.5) <= tolerance)
+  {
+    std::array<char, 64> up{};
+    const auto           roundedUp = std::copysign((std::floor(scaled) + 1.0) / scale, static_cast<double>(value));
+    if (viaSnprintf(up, roundedUp, decimals) == actual)
+    {
+      ++result.ties;
+      return;
+    }
+  }
+
+  printf("  Mismatch at %.9g (%lu decimals): snprintf=%.*s format=%.*s\n", static_cast<double>(value),
+         static_cast<unsigned long>(decimals), static_cast<int>(expected.size()), expected.data(),
+         static_cast<int>(actual.size()), actual.data());
+  ++result.mismatches;
+}
+
+void compare(Comparison& result, const float value, const uint32_t decimals)
+{
+  std::array<char, 64> buffer{};
+  const auto           expected = viaSnprintf(buffer, static_cast<double>(value), decimals);
+  const auto           actual   = Format::toDecimal(value, decimals);
+  if (actual.view() != expected)
+  {
+    classify(result, value, decimals, expected, actual.view());
+  }
+}
+
+// Random readings at the magnitudes the sensors produce, every value on a quarter boundary (the exact binary ties)
+// and random bit patterns up to Format's 1e18 limit.
+auto verifyAgainstSnprintf() -> Comparison
+{
+  Comparison result;
+  uint32_t   seed = 0x5E'ED'F0'01U;
+  for (uint32_t i = 0; i < SWEEP_VALUES; ++i)
+  {
+    const auto decimals = TestData::nextRandom(seed) % (Format::MAX_DECIMALS + 1);
+    const auto reading  = static_cast<float>(static_cast<int32_t>(TestData::nextRandom(seed) % 2'000'001) - 1'000'000);
+    compare(result, reading / 1'000.0F, decimals);
+    compare(result, static_cast<float>(static_cast<int32_t>(i) - static_cast<int32_t>(SWEEP_VALUES / 2)) / 8.0F,
+            decimals);
+
+    const auto exponent = 100U + (TestData::nextRandom(seed) % 85U);
+    const auto bits     = (TestData::nextRandom(seed) & 0x80'7F'FF'FFU) | (exponent << 23U);
+    compare(result, std::bit_cast<float>(bits), decimals);
+  }
+
+  for (const auto& known : KNOWN_DIFFERENCES)
+  {
+    std::array<char, 64> buffer{};
+    const auto           actual = Format::toDecimal(known.value, known.decimals);
+    if ((actual.view() != known.format) or (viaSnprintf(buffer, static_cast<double>(known.value), known.decimals) !=
+                                            known.snprintf))
+    {
+      printf("  Known difference at %.9g changed: format=%s\n", static_cast<double>(known.value), actual.c_str());
+      ++result.mismatches;
+    }
+  }
+  return result;
+}
+
+auto verifyPayload() -> uint32_t
+{
+  uint32_t mismatches = 0;
+  for (const auto value : SAMPLE_VALUES)
+  {
+    std::array<char, 320> expected{};
+    std::array<char, 320> buffer{};
+    const auto            number = static_cast<double>(value);
+    const auto length = std::snprintf(expected.data(), expected.size(), PAYLOAD_FORMAT, number, number, number, number,
+                                      number, "true", number, "true", "false");
+    JsonWriter json(buffer);
+    json.beginObject()
+      .field("temperature", value, 2)
+      .field("humidity", value, 2)
+      .field("pressure", value, 2)
+      .field("soil_moisture", value, 2)
+      .field("light_lux", value, 2)
+      .field("light_available", true)
+      .field("water_level", value, 2)
+      .field("water_level_available", true)
+      .field("watering", false)
+      .endObject();
+    if (json.view() != std::string_view(expected.data(), static_cast<size_t>(length)))
+    {
+      printf("  Payload mismatch:\n    snprintf=%s\n    writer  =%.*s\n", expected.data(),
+             static_cast<int>(json.size()), buffer.data());
+      ++mismatches;
+    }
+  }
+  return mismatches;
+}
+
+template <typename Body>
+void benchmark(const char* const name, Body body)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    sink = body(SAMPLE_VALUES.at(i % SAMPLE_VALUES.size()));
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const auto ns      = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  printf("  %-22s %8.1f ns/call\n", name, static_cast<double>(ns) / ITERATIONS);
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  const auto values   = verifyAgainstSnprintf();
+  const auto payloads = verifyPayload();
+  printf("Verification: %lu mismatches, %lu payload mismatches, %lu half-up ties, %lu unsigned zeros\n",
+         static_cast<unsigned long>(values.mismatches), static_cast<unsigned long>(payloads),
+         static_cast<unsigned long>(values.ties), static_cast<unsigned long>(values.negZeros));
+
+  benchmark("snprintf %.2f",
+            [](const float value)
+            {
+              std::array<char, 32> buffer{};
+              return std::snprintf(buffer.data(), buffer.size(), "%.2f", static_cast<double>(value));
+            });
+  benchmark("Format::formatFixed",
+            [](const float value)
+            {
+              std::array<char, 32> buffer{};
+              return Format::formatFixed(buffer, value, 2);
+            });
+  benchmark("payload snprintf",
+            [](const float value)
+            {
+              std::array<char, 320> buffer{};
+              const auto            number = static_cast<double>(value);
+              return std::snprintf(buffer.data(), buffer.size(), PAYLOAD_FORMAT, number, number, number, number,
+                                   number, "true", number, "true", "false");
+            });
+  benchmark("payload JsonWriter",
+            [](const float value)
+            {
+              std::array<char, 320> buffer{};
+              JsonWriter            json(buffer);
+              json.beginObject()
+                .field("temperature", value, 2)
+                .field("humidity", value, 2)
+                .field("pressure", value, 2)
+                .field("soil_moisture", value, 2)
+                .field("light_lux", value, 2)
+                .field("light_available", true)
+                .field("water_level", value, 2)
+                .field("water_level_available", true)
+                .field("watering", false)
+                .endObject();
+              return json.size();
+            });
+
+  return ((values.mismatches == 0) and (payloads == 0)) ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "JsonReader.hpp"
+#include "JsonReaderCases.hpp"
+
+namespace
+{
+
+inline constexpr uint32_t ITERATIONS = 200'000;
+
+volatile size_t sink = 0;
+
+}  // namespace
+
+auto main() -> int
+{
+  using JsonReaderCases::CONFIG_BODY;
+
+  size_t     members = 0;
+  const auto start   = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ITERATIONS; ++i)
+  {
+    auto error  = JsonError::NONE;
+    members    += JsonReaderCases::countMembers(CONFIG_BODY, error);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  sink               = members;
+
+  const auto ns        = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  const auto perBodyNs = static_cast<double>(ns) / ITERATIONS;
+  printf("Parse: %.0f ns/body, %.1f MB/s (%zu bytes, %zu members)\n", perBodyNs,
+         static_cast<double>(CONFIG_BODY.size()) * 1'000.0 / perBodyNs, CONFIG_BODY.size(),
+         JsonReaderCases::CONFIG_BODY_MEMBERS);
+
+  if (members != ITERATIONS * JsonReaderCases::CONFIG_BODY_MEMBERS)
+  {
+    printf("FAIL parsed %zu members\n", members);
+    return 1;
+  }
+  return 0;
+}
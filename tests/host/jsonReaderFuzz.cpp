@@ -0,0 +1,84 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#include "JsonReader.hpp"
+#include "JsonReaderCases.hpp"
+#include "TestData.hpp"
+
+namespace
+{
+
+inline constexpr uint32_t MUTATION_ITERATIONS = 500'000;
+inline constexpr uint32_t RANDOM_ITERATIONS   = 100'000;
+inline constexpr size_t   MAX_RANDOM_LENGTH   = 96;
+
+using JsonReaderCases::CONFIG_BODY;
+
+// Every input is parsed from a heap copy of exactly its length, so the sanitizers catch any read past the end.
+auto parseExact(const char* const data, const size_t length, bool& accepted) -> bool
+{
+  const auto copy = std::make_unique<char[]>(length);
+  std::memcpy(copy.get(), data, length);
+  return JsonReaderCases::checkInvariants(std::string_view(copy.get(), length), accepted);
+}
+
+auto fuzzMutations(uint32_t seed, uint32_t& accepted) -> bool
+{
+  std::array<char, CONFIG_BODY.size()> buffer{};
+  for (uint32_t i = 0; i < MUTATION_ITERATIONS; ++i)
+  {
+    const auto length = JsonReaderCases::mutate(buffer, seed);
+    auto       valid  = false;
+    if (not parseExact(buffer.data(), length, valid))
+    {
+      printf("FAIL mutation %lu: %.*s\n", static_cast<unsigned long>(i), static_cast<int>(length), buffer.data());
+      return false;
+    }
+    accepted += valid ? 1U : 0U;
+  }
+  return true;
+}
+
+// Short inputs drawn from JSON punctuation and escapes reach the tokenizer's error paths the config body never does.
+auto fuzzRandom(uint32_t seed) -> bool
+{
+  constexpr std::string_view ALPHABET = "{}[]\":,\\/-+.0eE1tfnu\"ab\x01\xff ";
+
+  std::array<char, MAX_RANDOM_LENGTH> buffer{};
+  for (uint32_t i = 0; i < RANDOM_ITERATIONS; ++i)
+  {
+    const auto length = TestData::nextRandom(seed) % (buffer.size() + 1);
+    buffer.at(0)      = '{';
+    for (size_t j = 1; j < length; ++j)
+    {
+      buffer.at(j) = ALPHABET[TestData::nextRandom(seed) % ALPHABET.size()];
+    }
+    auto valid = false;
+    if (not parseExact(buffer.data(), length, valid))
+    {
+      printf("FAIL random input %lu: %.*s\n", static_cast<unsigned long>(i), static_cast<int>(length), buffer.data());
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  const auto failures = JsonReaderCases::runVectors();
+
+  uint32_t   accepted = 0;
+  const auto fuzzed   = fuzzMutations(0x1234'5678U, accepted) and fuzzRandom(0x9E37'79B9U);
+
+  printf("%s: %u vector failures, %lu mutations (%lu accepted), %lu random inputs\n",
+         ((failures == 0) and fuzzed) ? "PASS" : "FAIL", failures, static_cast<unsigned long>(MUTATION_ITERATIONS),
+         static_cast<unsigned long>(accepted), static_cast<unsigned long>(RANDOM_ITERATIONS));
+  return ((failures == 0) and fuzzed) ? 0 : 1;
+}
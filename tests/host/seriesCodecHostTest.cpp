@@ -0,0 +1,58 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "SeriesCodec.hpp"
+#include "SeriesTrace.hpp"
+#include "TestData.hpp"
+
+namespace
+{
+
+inline constexpr size_t   TRACE_LENGTH = 2'016;
+inline constexpr uint32_t SEEDS        = 16;
+
+// A flash page payload (HISTORY_PAYLOAD_BYTES on the device), plus the smallest block that holds any first sample
+// and one large enough for a whole trace to go through a single block.
+inline constexpr size_t PAGE_PAYLOAD_BYTES = 256 - 24;
+inline constexpr size_t MIN_BLOCK_BYTES    = (SeriesCodec::FIRST_RECORD_BITS + 7) / 8;
+inline constexpr size_t LARGE_BLOCK_BYTES  = 16 * 1'024;
+
+std::array<SeriesTrace::Sample, TRACE_LENGTH> trace{};
+std::array<uint8_t, LARGE_BLOCK_BYTES>        block{};
+
+auto run(const char* const name, const size_t blockBytes) -> uint32_t
+{
+  const auto result = SeriesTrace::roundTrip(trace, std::span(block).first(blockBytes));
+  if (result.mismatches > 0)
+  {
+    printf("FAIL %-7s %5zu-byte blocks: %lu mismatches\n", name, blockBytes,
+           static_cast<unsigned long>(result.mismatches));
+  }
+  return result.mismatches;
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  uint32_t mismatches = 0;
+  uint32_t seed       = 0x5E'ED'00'01U;
+  for (uint32_t round = 0; round < SEEDS; ++round)
+  {
+    for (const auto blockBytes : {MIN_BLOCK_BYTES, PAGE_PAYLOAD_BYTES, LARGE_BLOCK_BYTES})
+    {
+      SeriesTrace::makeNoise(trace, TestData::nextRandom(seed));
+      mismatches += run("noise", blockBytes);
+
+      SeriesTrace::makeIndoor(trace, TestData::nextRandom(seed));
+      mismatches += run("indoor", blockBytes);
+    }
+  }
+
+  printf("%s: %lu mismatches over %lu seeds\n", (mismatches == 0) ? "PASS" : "FAIL",
+         static_cast<unsigned long>(mismatches), static_cast<unsigned long>(SEEDS));
+  return (mismatches == 0) ? 0 : 1;
+}
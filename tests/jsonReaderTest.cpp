@@ -0,0 +1,81 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#include "JsonReader.hpp"
+#include "JsonReaderCases.hpp"
+#include "TestData.hpp"
+
+#include <pico/stdio.h>
+#include <pico/time.h>
+
+namespace
+{
+
+inline constexpr uint32_t FUZZ_ITERATIONS      = 20'000;
+inline constexpr uint32_t BENCHMARK_ITERATIONS = 2'000;
+
+using JsonReaderCases::CONFIG_BODY;
+
+auto runFuzz(uint32_t seed) -> uint32_t
+{
+  std::array<char, CONFIG_BODY.size()> buffer{};
+  uint32_t                             accepted = 0;
+  for (uint32_t i = 0; i < FUZZ_ITERATIONS; ++i)
+  {
+    const auto length = JsonReaderCases::mutate(buffer, seed);
+    auto       valid  = false;
+    if (not JsonReaderCases::checkInvariants(std::string_view(buffer.data(), length), valid))
+    {
+      printf("  FAIL fuzz iteration %u\n", i);
+      return 0;
+    }
+    accepted += valid ? 1U : 0U;
+  }
+  return accepted;
+}
+
+auto benchmarkParse() -> uint64_t
+{
+  size_t     members = 0;
+  const auto start   = time_us_64();
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i)
+  {
+    auto error  = JsonError::NONE;
+    members    += JsonReaderCases::countMembers(CONFIG_BODY, error);
+  }
+  const auto elapsed = time_us_64() - start;
+  if (members != BENCHMARK_ITERATIONS * JsonReaderCases::CONFIG_BODY_MEMBERS)
+  {
+    printf("  FAIL benchmark parsed %zu members\n", members);
+  }
+  return elapsed;
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  stdio_init_all();
+  sleep_ms(5'000);
+  printf("Starting JSON reader test...\n");
+
+  uint32_t seed = 0x1234'5678U;
+  while (true)
+  {
+    printf("Vectors: %u failures\n", JsonReaderCases::runVectors());
+
+    const auto accepted = runFuzz(seed);
+    printf("Fuzz: %u iterations, %u accepted\n", FUZZ_ITERATIONS, accepted);
+    seed = TestData::nextRandom(seed);
+
+    const auto elapsedUs = benchmarkParse();
+    printf("Parse: %llu us total, %llu us/body (%zu bytes)\n\n", static_cast<unsigned long long>(elapsedUs),
+           static_cast<unsigned long long>(elapsedUs / BENCHMARK_ITERATIONS), CONFIG_BODY.size());
+    sleep_ms(5'000);
+  }
+
+  return 0;
+}
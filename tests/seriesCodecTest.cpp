@@ -0,0 +1,116 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "HistoryStore.hpp"
+#include "PackedSensorRecord.hpp"
+#include "SeriesCodec.hpp"
+#include "SeriesTrace.hpp"
+#include "TestData.hpp"
+
+#include <pico/stdio.h>
+#include <pico/time.h>
+
+namespace
+{
+
+inline constexpr size_t   TRACE_LENGTH = 2'016;
+inline constexpr uint32_t ITERATIONS   = 20;
+
+using SeriesTrace::RoundTrip;
+using SeriesTrace::Sample;
+
+std::array<Sample, TRACE_LENGTH>           trace{};
+std::array<uint8_t, HISTORY_PAYLOAD_BYTES> block{};
+
+volatile size_t sink = 0;
+
+void report(const char* const name, const RoundTrip& result)
+{
+  const auto perSample = static_cast<double>(result.bytes) / static_cast<double>(trace.size());
+  printf("  %-7s %lu mismatches, %zu blocks, %5.2f B/sample, %4.1fx vs SensorData, %4.1fx vs packed\n", name,
+         static_cast<unsigned long>(result.mismatches), result.blocks, perSample,
+         static_cast<double>(sizeof(SensorData)) / perSample,
+         static_cast<double>(sizeof(PackedSensorRecord)) / perSample);
+}
+
+auto benchmarkEncode() -> uint64_t
+{
+  SeriesEncoder encoder(block);
+  const auto    start = time_us_64();
+  for (uint32_t iteration = 0; iteration < ITERATIONS; ++iteration)
+  {
+    encoder.reset(block);
+    for (const auto& sample : trace)
+    {
+      if (not encoder.append(sample.time, sample.record))
+      {
+        encoder.reset(block);
+        (void)encoder.append(sample.time, sample.record);
+      }
+    }
+    sink = encoder.count();
+  }
+  return time_us_64() - start;
+}
+
+auto benchmarkDecode() -> uint64_t
+{
+  SeriesEncoder encoder(block);
+  size_t        count = 0;
+  while ((count < trace.size()) and encoder.append(trace.at(count).time, trace.at(count).record))
+  {
+    ++count;
+  }
+
+  size_t             decoded = 0;
+  uint32_t           time    = 0;
+  PackedSensorRecord record;
+  const auto         start = time_us_64();
+  while (decoded < (ITERATIONS * trace.size()))
+  {
+    SeriesDecoder decoder(block, count);
+    while (decoder.next(time, record))
+    {
+      ++decoded;
+    }
+    sink = time;
+  }
+  const auto elapsedUs = time_us_64() - start;
+  return (elapsedUs * (ITERATIONS * trace.size())) / decoded;
+}
+
+void reportBenchmark(const char* const name, const uint64_t elapsedUs)
+{
+  const auto samples   = static_cast<uint64_t>(ITERATIONS) * trace.size();
+  const auto perCallNs = (elapsedUs * 1'000U) / samples;
+  const auto perSecond = (elapsedUs == 0) ? 0 : (samples * 1'000'000U) / elapsedUs;
+  printf("  %-7s %6llu ns/sample %8llu samples/s\n", name, static_cast<unsigned long long>(perCallNs),
+         static_cast<unsigned long long>(perSecond));
+}
+
+}  // namespace
+
+auto main() -> int
+{
+  stdio_init_all();
+  sleep_ms(5'000);
+  printf("Starting series codec test...\n");
+
+  uint32_t seed = 0x5E'ED'00'01U;
+  while (true)
+  {
+    SeriesTrace::makeNoise(trace, TestData::nextRandom(seed));
+    report("noise", SeriesTrace::roundTrip(trace, block));
+
+    SeriesTrace::makeIndoor(trace, TestData::nextRandom(seed));
+    report("indoor", SeriesTrace::roundTrip(trace, block));
+    reportBenchmark("encode", benchmarkEncode());
+    reportBenchmark("decode", benchmarkDecode());
+    printf("\n");
+    sleep_ms(5'000);
+  }
+
+  return 0;
+}
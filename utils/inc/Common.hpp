@@ -7,4 +7,8 @@ namespace Utils
 
 auto getTimeSinceBoot() -> uint32_t;
 
+void delayMs(uint32_t ms);
+auto getYieldedDelayMs() -> uint32_t;
+auto getBusyDelayMs() -> uint32_t;
+
 }  // namespace Utils
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "DoubleBuffer.hpp"
+#include "Types.hpp"
+
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <task.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ConfigField
+{
+inline constexpr uint32_t WIFI            = 1U << 0U;
+inline constexpr uint32_t AP              = 1U << 1U;
+inline constexpr uint32_t MQTT            = 1U << 2U;
+inline constexpr uint32_t SENSOR_INTERVAL = 1U << 3U;
+inline constexpr uint32_t IRRIGATION_MODE = 1U << 4U;
+inline constexpr uint32_t DISCOVERY       = 1U << 5U;
+inline constexpr uint32_t ALL             = WIFI | AP | MQTT | SENSOR_INTERVAL | IRRIGATION_MODE | DISCOVERY;
+}  // namespace ConfigField
+
+class ConfigService final
+{
+public:
+  using Lease = DoubleBuffer<SystemConfig>::Lease;
+
+  static constexpr size_t MAX_SUBSCRIBERS = 4;
+
+  ConfigService(const ConfigService&)                    = delete;
+  auto operator=(const ConfigService&) -> ConfigService& = delete;
+  ConfigService(ConfigService&&)                         = delete;
+  auto operator=(ConfigService&&) -> ConfigService&      = delete;
+
+  static auto getInstance() -> ConfigService&;
+
+  static auto defaults() -> SystemConfig;
+  static auto diff(const SystemConfig& before, const SystemConfig& after) -> uint32_t;
+  static auto waitForChanges(TickType_t timeout) -> uint32_t;
+
+  auto load() -> bool;
+  auto acquire() const -> Lease;
+  auto snapshot() const -> SystemConfig;
+  auto version() const -> uint32_t;
+
+  auto update(const SystemConfig& config) -> bool;
+  auto setDiscoveryFingerprint(uint32_t fingerprint) -> bool;
+  auto subscribe(TaskHandle_t task, uint32_t fields) -> bool;
+
+private:
+  struct Subscriber
+  {
+    TaskHandle_t task   = nullptr;
+    uint32_t     fields = 0;
+  };
+
+  ConfigService();
+  ~ConfigService() = default;
+
+  auto apply(const SystemConfig& config) -> bool;
+  void notify(uint32_t changed);
+
+  SemaphoreHandle_t                       writeMutex_      = nullptr;
+  DoubleBuffer<SystemConfig>              buffer_;
+  std::atomic<uint32_t>                   version_         = 0;
+  std::array<Subscriber, MAX_SUBSCRIBERS> subscribers_     = {};
+  size_t                                  subscriberCount_ = 0;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace Crc32
+{
+
+inline constexpr uint32_t POLYNOMIAL = 0xED'B8'83'20U;
+
+using Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr auto makeTables() -> Tables
+{
+  Tables tables{};
+  for (uint32_t i = 0; i < 256; ++i)
+  {
+    auto crc = i;
+    for (int32_t bit = 0; bit < 8; ++bit)
+    {
+      crc = (crc >> 1U) ^ (POLYNOMIAL & -(crc & 1U));
+    }
+    tables.at(0).at(i) = crc;
+  }
+  for (size_t slice = 1; slice < tables.size(); ++slice)
+  {
+    for (size_t i = 0; i < 256; ++i)
+    {
+      const auto previous    = tables.at(slice - 1).at(i);
+      tables.at(slice).at(i) = (previous >> 8U) ^ tables.at(0).at(previous & 0xFFU);
+    }
+  }
+  return tables;
+}
+
+inline constexpr Tables TABLES = makeTables();
+
+constexpr auto loadLittleEndian(const std::span<const uint8_t> bytes) -> uint32_t
+{
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8U) |
+         (static_cast<uint32_t>(bytes[2]) << 16U) | (static_cast<uint32_t>(bytes[3]) << 24U);
+}
+
+constexpr auto software(std::span<const uint8_t> data, const uint32_t crc = 0) -> uint32_t
+{
+  const auto& t     = TABLES;
+  auto        state = ~crc;
+  while (data.size() >= 8)
+  {
+    const auto low  = state ^ loadLittleEndian(data.first(4));
+    const auto high = loadLittleEndian(data.subspan(4, 4));
+
+    state = t[7][low & 0xFFU] ^ t[6][(low >> 8U) & 0xFFU] ^ t[5][(low >> 16U) & 0xFFU] ^ t[4][low >> 24U] ^
+            t[3][high & 0xFFU] ^ t[2][(high >> 8U) & 0xFFU] ^ t[1][(high >> 16U) & 0xFFU] ^ t[0][high >> 24U];
+    data = data.subspan(8);
+  }
+  for (const auto byte : data)
+  {
+    state = (state >> 8U) ^ t[0][(state ^ byte) & 0xFFU];
+  }
+  return ~state;
+}
+
+auto init() -> bool;
+auto hardware(std::span<const uint8_t> data, uint32_t crc = 0) -> uint32_t;
+
+constexpr auto compute(const std::span<const uint8_t> data, const uint32_t crc = 0) -> uint32_t
+{
+  if (std::is_constant_evaluated())
+  {
+    return software(data, crc);
+  }
+  return hardware(data, crc);
+}
+
+inline auto compute(const void* const data, const size_t size, const uint32_t crc = 0) -> uint32_t
+{
+  return compute(std::span(static_cast<const uint8_t*>(data), size), crc);
+}
+
+}  // namespace Crc32
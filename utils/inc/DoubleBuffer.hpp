@@ -0,0 +1,91 @@
+#pragma once
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class DoubleBuffer final
+{
+public:
+  class Lease final
+  {
+  public:
+    Lease(const DoubleBuffer& owner, const uint32_t index) : owner_(owner), index_(index)
+    {
+    }
+    ~Lease()
+    {
+      owner_.readers_[index_].fetch_sub(1);
+    }
+
+    Lease(const Lease&)                    = delete;
+    auto operator=(const Lease&) -> Lease& = delete;
+    Lease(Lease&&)                         = delete;
+    auto operator=(Lease&&) -> Lease&      = delete;
+
+    auto operator*() const -> const T&
+    {
+      return owner_.slots_[index_];
+    }
+    auto operator->() const -> const T*
+    {
+      return &owner_.slots_[index_];
+    }
+
+  private:
+    const DoubleBuffer& owner_;
+    uint32_t            index_ = 0;
+  };
+
+  DoubleBuffer()  = default;
+  ~DoubleBuffer() = default;
+
+  DoubleBuffer(const DoubleBuffer&)                    = delete;
+  auto operator=(const DoubleBuffer&) -> DoubleBuffer& = delete;
+  DoubleBuffer(DoubleBuffer&&)                         = delete;
+  auto operator=(DoubleBuffer&&) -> DoubleBuffer&      = delete;
+
+  auto acquire() const -> Lease
+  {
+    while (true)
+    {
+      const auto index = front_.load();
+      readers_[index].fetch_add(1);
+      if (front_.load() == index)
+      {
+        return Lease(*this, index);
+      }
+      readers_[index].fetch_sub(1);
+    }
+  }
+
+  // Single writer: concurrent publishers must be serialized by the caller. Waits for readers of the back slot to
+  // release it; without a running scheduler nothing else can, so the publish is refused instead.
+  template <typename Fill>
+  auto publish(Fill&& fill) -> bool
+  {
+    const auto back = 1U - front_.load();
+    while (readers_[back].load() != 0)
+    {
+      if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) [[unlikely]]
+      {
+        return false;
+      }
+      vTaskDelay(1);
+    }
+
+    slots_[back] = slots_[1U - back];
+    fill(slots_[back]);
+    front_.store(back);
+    return true;
+  }
+
+private:
+  std::array<T, 2>                             slots_   = {};
+  std::atomic<uint32_t>                        front_   = 0;
+  mutable std::array<std::atomic<uint32_t>, 2> readers_ = {};
+};
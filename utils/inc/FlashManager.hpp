@@ -8,9 +8,10 @@
 
 struct FlashRecord
 {
-  uint32_t     magic  = 0;
-  SystemConfig config = {};
-  uint32_t     crc    = 0;
+  uint32_t     magic    = 0;
+  uint32_t     sequence = 0;
+  SystemConfig config   = {};
+  uint32_t     crc      = 0;
 };
 
 struct FlashOpContext
@@ -33,8 +34,10 @@ class FlashManager final
   static auto read(uint32_t offset, std::span<uint8_t> buffer) -> bool;
   static auto write(uint32_t offset, std::span<const uint8_t> data) -> bool;
   static auto erase(uint32_t offset, size_t size) -> bool;
+  static auto isErased(uint32_t offset, size_t size) -> bool;
 
   static auto getFlashAddress(uint32_t offset) -> uint32_t;
+  static auto configJournalOffset() -> uint32_t;
 
   static auto loadConfig(SystemConfig& config) -> bool;
   static auto saveConfig(const SystemConfig& config) -> bool;
@@ -42,6 +45,18 @@ class FlashManager final
   static auto flushOutputBuffers() -> bool;
 
 private:
+  struct JournalState
+  {
+    int32_t  newestSlot   = -1;
+    uint32_t nextSequence = 1;
+  };
+
   FlashManager()  = default;
   ~FlashManager() = default;
+
+  static auto scanJournal(FlashRecord* newest) -> JournalState;
+  static auto readRecord(uint32_t slot, FlashRecord& record) -> bool;
+  static auto loadLegacyConfig(SystemConfig& config) -> bool;
+  static auto isSlotErased(uint32_t slot) -> bool;
+  static auto execute(void (*operation)(void*), FlashOpContext& ctx) -> bool;
 };
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+
+namespace Format
+{
+
+inline constexpr uint32_t MAX_DECIMALS = 6;
+
+inline constexpr std::array<uint32_t, MAX_DECIMALS + 1> POWERS_OF_TEN = {1, 10, 100, 1'000, 10'000, 100'000, 1'000'000};
+
+constexpr auto formatUnsigned(const std::span<char> out, uint64_t value) -> size_t
+{
+  std::array<char, 20> digits{};
+  size_t               count = 0;
+  do
+  {
+    digits.at(count++) = static_cast<char>('0' + (value % 10));
+    value /= 10;
+  } while (value != 0);
+
+  if (count > out.size()) [[unlikely]]
+  {
+    return 0;
+  }
+  for (size_t i = 0; i < count; ++i)
+  {
+    out[i] = digits.at(count - 1 - i);
+  }
+  return count;
+}
+
+constexpr auto formatSigned(const std::span<char> out, const int64_t value) -> size_t
+{
+  if (value >= 0)
+  {
+    return formatUnsigned(out, static_cast<uint64_t>(value));
+  }
+  if (out.empty()) [[unlikely]]
+  {
+    return 0;
+  }
+  out[0]           = '-';
+  const auto count = formatUnsigned(out.subspan(1), static_cast<uint64_t>(-(value + 1)) + 1);
+  return (count == 0) ? 0 : count + 1;
+}
+
+constexpr auto formatFixed(const std::span<char> out, const float value, uint32_t decimals) -> size_t
+{
+  constexpr auto LIMIT = 1.0e18F;
+
+  const auto copyText = [out](const std::string_view text) -> size_t
+  {
+    if (text.size() > out.size()) [[unlikely]]
+    {
+      return 0;
+    }
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+      out[i] = text[i];
+    }
+    return text.size();
+  };
+
+  if (value != value) [[unlikely]]
+  {
+    return copyText("nan");
+  }
+
+  decimals             = (decimals > MAX_DECIMALS) ? MAX_DECIMALS : decimals;
+  const auto scale     = POWERS_OF_TEN.at(decimals);
+  const auto negative  = value < 0.0F;
+  const auto magnitude = negative ? -value : value;
+  if (magnitude >= LIMIT) [[unlikely]]
+  {
+    return copyText(negative ? "-inf" : "inf");
+  }
+
+  auto       integral  = static_cast<uint64_t>(magnitude);
+  const auto remainder = magnitude - static_cast<float>(integral);
+  auto       fraction  = static_cast<uint32_t>((remainder * static_cast<float>(scale)) + 0.5F);
+  if (fraction >= scale)
+  {
+    fraction -= scale;
+    ++integral;
+  }
+
+  size_t pos = 0;
+  if (negative and ((integral != 0) or (fraction != 0)))
+  {
+    if (out.empty()) [[unlikely]]
+    {
+      return 0;
+    }
+    out[pos++] = '-';
+  }
+
+  const auto intCount = formatUnsigned(out.subspan(pos), integral);
+  if (intCount == 0) [[unlikely]]
+  {
+    return 0;
+  }
+  pos += intCount;
+
+  if (decimals == 0)
+  {
+    return pos;
+  }
+  if ((pos + 1 + decimals) > out.size()) [[unlikely]]
+  {
+    return 0;
+  }
+  out[pos++] = '.';
+  for (auto i = decimals; i > 0; --i)
+  {
+    out[pos + i - 1] = static_cast<char>('0' + (fraction % 10));
+    fraction /= 10;
+  }
+  return pos + decimals;
+}
+
+struct Decimal
+{
+  std::array<char, 32> text   = {};
+  size_t               length = 0;
+
+  auto c_str() const -> const char*
+  {
+    return text.data();
+  }
+  constexpr auto view() const -> std::string_view
+  {
+    return {text.data(), length};
+  }
+};
+
+constexpr auto toDecimal(const float value, const uint32_t decimals) -> Decimal
+{
+  Decimal result{};
+  result.length = formatFixed(std::span(result.text).first(result.text.size() - 1), value, decimals);
+  return result;
+}
+
+static_assert(toDecimal(0.0F, 2).view() == "0.00");
+static_assert(toDecimal(21.456F, 1).view() == "21.5");
+static_assert(toDecimal(-3.25F, 2).view() == "-3.25");
+static_assert(toDecimal(-0.001F, 2).view() == "0.00");
+static_assert(toDecimal(1013.25F, 2).view() == "1013.25");
+static_assert(toDecimal(99.96F, 1).view() == "100.0");
+static_assert(toDecimal(42.0F, 0).view() == "42");
+static_assert(toDecimal(std::numeric_limits<float>::infinity(), 1).view() == "inf");
+
+}  // namespace Format
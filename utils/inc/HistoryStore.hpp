@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Config.hpp"
+#include "SeriesCodec.hpp"
+#include "Types.hpp"
+
+#include <FreeRTOS.h>
+#include <hardware/flash.h>
+#include <semphr.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+struct HistoryPageHeader
+{
+  uint32_t magic     = 0;
+  uint32_t crc       = 0;
+  uint32_t sequence  = 0;
+  uint32_t firstTime = 0;
+  uint32_t lastTime  = 0;
+  uint16_t count     = 0;
+  uint16_t reserved  = 0;
+};
+
+inline constexpr size_t HISTORY_PAYLOAD_BYTES = FLASH_PAGE_SIZE - sizeof(HistoryPageHeader);
+
+struct HistoryPage
+{
+  HistoryPageHeader                          header;
+  std::array<uint8_t, HISTORY_PAYLOAD_BYTES> payload;
+};
+
+struct HistoryStats
+{
+  uint32_t commits = 0;
+  uint32_t pages   = 0;
+  uint32_t samples = 0;
+};
+
+static_assert(sizeof(HistoryPage) == FLASH_PAGE_SIZE, "History page must fill exactly one flash page");
+static_assert((HISTORY_PAYLOAD_BYTES * 8) >= SeriesCodec::FIRST_RECORD_BITS, "History page must hold a sample");
+
+class HistoryStore final
+{
+public:
+  using Visitor = std::function<bool(uint32_t time, const PackedSensorRecord& record)>;
+
+  static constexpr uint32_t PAGES_PER_SECTOR = FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE;
+  static constexpr uint32_t SECTORS          = Config::History::FLASH_SECTORS;
+  static constexpr uint32_t PAGES            = SECTORS * PAGES_PER_SECTOR;
+  static constexpr size_t   BATCH_PAGES      = Config::History::BATCH_PAGES;
+
+  HistoryStore(const HistoryStore&)                    = delete;
+  auto operator=(const HistoryStore&) -> HistoryStore& = delete;
+  HistoryStore(HistoryStore&&)                         = delete;
+  auto operator=(HistoryStore&&) -> HistoryStore&      = delete;
+
+  static auto getInstance() -> HistoryStore&;
+
+  auto init() -> bool;
+  auto append(const SensorData& data, bool watering) -> bool;
+  auto flush() -> bool;
+  auto flushIfStale(uint32_t nowMs) -> bool;
+  void setSampleInterval(uint32_t intervalMs);
+
+  auto forEach(uint32_t from, uint32_t to, const Visitor& visit) -> size_t;
+  auto stats() const -> HistoryStats;
+
+  auto now() const -> uint32_t;
+  auto toHistoryTime(uint32_t uptimeMs) const -> uint32_t;
+
+private:
+  static constexpr uint32_t EMPTY_SECTOR        = 0xFF'FF'FF'FFU;
+  static constexpr uint32_t UPTIME_WRAP_SECONDS = 4'294'968;
+
+  HistoryStore();
+  ~HistoryStore() = default;
+
+  static auto regionOffset() -> uint32_t;
+  static auto pageOffset(uint32_t page) -> uint32_t;
+  static auto readPage(uint32_t page, HistoryPage& out) -> bool;
+
+  auto prepareHead() -> bool;
+  auto advanceHead(uint32_t pages) -> bool;
+  void openPage();
+  void sealOpenPage();
+  auto commitLocked() -> bool;
+  auto isStaleLocked(uint32_t nowMs) const -> bool;
+  auto findStartPage(uint32_t from) const -> uint32_t;
+
+  SemaphoreHandle_t mutex_       = nullptr;
+  bool              initialized_ = false;
+
+  uint32_t head_         = 0;
+  uint32_t nextSequence_ = 1;
+  uint32_t timeBase_     = 0;
+  uint32_t uptimeWraps_  = 0;
+  uint32_t lastUptimeMs_ = 0;
+
+  std::array<uint32_t, SECTORS>        sectorFirstTime_ = {};
+  std::array<HistoryPage, BATCH_PAGES> pending_         = {};
+  size_t                               sealedPages_     = 0;
+  SeriesEncoder                        encoder_;
+  uint32_t                             pendingSinceMs_  = 0;
+  std::atomic<uint32_t>                flushAgeMs_      = 0;
+  HistoryStats                         stats_;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class JsonError : uint8_t
+{
+  NONE,
+  UNEXPECTED_END,
+  UNEXPECTED_CHARACTER,
+  INVALID_ESCAPE,
+  INVALID_NUMBER,
+  TOO_LONG,
+  TOO_DEEP,
+};
+
+enum class JsonType : uint8_t
+{
+  STRING,
+  NUMBER,
+  BOOLEAN,
+  NULL_VALUE,
+  OBJECT,
+  ARRAY,
+};
+
+struct JsonMember
+{
+  std::string_view key;
+  JsonType         type    = JsonType::NULL_VALUE;
+  std::string_view text;
+  bool             boolean = false;
+};
+
+class JsonObjectReader final
+{
+public:
+  static constexpr size_t MAX_KEY_LENGTH   = 32;
+  static constexpr size_t MAX_VALUE_LENGTH = 128;
+  static constexpr size_t MAX_DEPTH        = 8;
+
+  explicit JsonObjectReader(std::string_view json);
+  ~JsonObjectReader() = default;
+
+  JsonObjectReader(const JsonObjectReader&)                    = delete;
+  auto operator=(const JsonObjectReader&) -> JsonObjectReader& = delete;
+  JsonObjectReader(JsonObjectReader&&)                         = delete;
+  auto operator=(JsonObjectReader&&) -> JsonObjectReader&      = delete;
+
+  auto next(JsonMember& member) -> bool;
+
+  auto error() const -> JsonError;
+  auto errorOffset() const -> size_t;
+
+  static auto errorString(JsonError error) -> const char*;
+
+private:
+  enum class State : uint8_t
+  {
+    START,
+    MEMBER_OR_END,
+    MEMBER,
+    DONE,
+  };
+
+  auto fail(JsonError error) -> bool;
+  void skipWhitespace();
+  auto peek() const -> char;
+  auto consume(char expected) -> bool;
+  auto consumeLiteral(std::string_view literal) -> bool;
+
+  auto parseString(char* out, size_t capacity, size_t& length) -> bool;
+  auto parseEscape(char* out, size_t capacity, size_t& length) -> bool;
+  auto parseHex4(uint32_t& codePoint) -> bool;
+  auto parseNumber() -> bool;
+  auto parseValue(JsonMember& member) -> bool;
+  auto skipContainer() -> bool;
+
+  std::string_view json_;
+  size_t           pos_         = 0;
+  size_t           errorOffset_ = 0;
+  JsonError        error_       = JsonError::NONE;
+  State            state_       = State::START;
+
+  std::array<char, MAX_KEY_LENGTH>   key_   = {};
+  std::array<char, MAX_VALUE_LENGTH> value_ = {};
+};
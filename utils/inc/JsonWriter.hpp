@@ -0,0 +1,229 @@
+#pragma once
+
+#include "Format.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+class JsonWriter final
+{
+public:
+  constexpr explicit JsonWriter(const std::span<char> buffer) : buffer_(buffer)
+  {
+  }
+
+  constexpr auto beginObject() -> JsonWriter&
+  {
+    separate();
+    append('{');
+    needsComma_ = false;
+    return *this;
+  }
+
+  constexpr auto endObject() -> JsonWriter&
+  {
+    append('}');
+    needsComma_ = true;
+    return *this;
+  }
+
+  constexpr auto key(const std::string_view name) -> JsonWriter&
+  {
+    separate();
+    appendString(name);
+    append(':');
+    needsComma_ = false;
+    return *this;
+  }
+
+  constexpr auto value(const std::string_view text) -> JsonWriter&
+  {
+    separate();
+    appendString(text);
+    needsComma_ = true;
+    return *this;
+  }
+
+  constexpr auto value(const bool flag) -> JsonWriter&
+  {
+    separate();
+    appendRaw(flag ? "true" : "false");
+    needsComma_ = true;
+    return *this;
+  }
+
+  template <std::integral T>
+    requires(not std::same_as<T, bool>)
+  constexpr auto value(const T number) -> JsonWriter&
+  {
+    separate();
+    advance(Format::formatSigned(remaining(), static_cast<int64_t>(number)));
+    needsComma_ = true;
+    return *this;
+  }
+
+  constexpr auto value(const float number, const uint32_t decimals) -> JsonWriter&
+  {
+    separate();
+    if ((number != number) or (number > MAX_FINITE) or (number < -MAX_FINITE)) [[unlikely]]
+    {
+      appendRaw("null");
+    }
+    else
+    {
+      advance(Format::formatFixed(remaining(), number, decimals));
+    }
+    needsComma_ = true;
+    return *this;
+  }
+
+  // Appends already serialized JSON verbatim: a value, or a run of members inside an object.
+  constexpr auto raw(const std::string_view json) -> JsonWriter&
+  {
+    separate();
+    appendRaw(json);
+    needsComma_ = true;
+    return *this;
+  }
+
+  constexpr auto field(const std::string_view name, const std::string_view text) -> JsonWriter&
+  {
+    return key(name).value(text);
+  }
+
+  constexpr auto field(const std::string_view name, const char* const text) -> JsonWriter&
+  {
+    return key(name).value(std::string_view(text));
+  }
+
+  constexpr auto field(const std::string_view name, const bool flag) -> JsonWriter&
+  {
+    return key(name).value(flag);
+  }
+
+  template <std::integral T>
+    requires(not std::same_as<T, bool>)
+  constexpr auto field(const std::string_view name, const T number) -> JsonWriter&
+  {
+    return key(name).value(number);
+  }
+
+  constexpr auto field(const std::string_view name, const float number, const uint32_t decimals) -> JsonWriter&
+  {
+    return key(name).value(number, decimals);
+  }
+
+  constexpr auto ok() const -> bool
+  {
+    return ok_;
+  }
+
+  constexpr auto size() const -> size_t
+  {
+    return length_;
+  }
+
+  constexpr auto view() const -> std::string_view
+  {
+    return ok_ ? std::string_view(buffer_.data(), length_) : std::string_view{};
+  }
+
+private:
+  static constexpr float MAX_FINITE = 3.402'823'466e38F;
+
+  constexpr auto remaining() const -> std::span<char>
+  {
+    return buffer_.subspan(length_);
+  }
+
+  constexpr void advance(const size_t count)
+  {
+    if (count == 0) [[unlikely]]
+    {
+      ok_ = false;
+    }
+    length_ += count;
+  }
+
+  constexpr void separate()
+  {
+    if (needsComma_)
+    {
+      append(',');
+    }
+  }
+
+  constexpr void append(const char ch)
+  {
+    if (length_ >= buffer_.size()) [[unlikely]]
+    {
+      ok_ = false;
+      return;
+    }
+    buffer_[length_++] = ch;
+  }
+
+  constexpr void appendRaw(const std::string_view text)
+  {
+    for (const auto ch : text)
+    {
+      append(ch);
+    }
+  }
+
+  constexpr void appendString(const std::string_view text)
+  {
+    constexpr std::string_view HEX = "0123456789abcdef";
+
+    append('"');
+    for (const auto ch : text)
+    {
+      const auto byte = static_cast<uint8_t>(ch);
+      if ((ch == '"') or (ch == '\\'))
+      {
+        append('\\');
+        append(ch);
+      }
+      else if (byte < 0x20U)
+      {
+        appendRaw("\\u00");
+        append(HEX[byte >> 4U]);
+        append(HEX[byte & 0x0FU]);
+      }
+      else
+      {
+        append(ch);
+      }
+    }
+    append('"');
+  }
+
+  std::span<char> buffer_;
+  size_t          length_     = 0;
+  bool            ok_         = true;
+  bool            needsComma_ = false;
+};
+
+namespace JsonWriterChecks
+{
+
+constexpr auto sample() -> bool
+{
+  std::array<char, 96> buffer{};
+  JsonWriter           json(buffer);
+  json.beginObject()
+    .field("t", 21.456F, 2)
+    .field("ok", true)
+    .field("n", -7)
+    .field("s", "a\"b\n")
+    .endObject();
+  return json.ok() and (json.view() == R"({"t":21.46,"ok":true,"n":-7,"s":"a\"b\u000a"})");
+}
+
+static_assert(sample());
+
+}  // namespace JsonWriterChecks
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class LatencyHistogram final
+{
+public:
+  static constexpr std::array<uint32_t, 10> BOUNDS_MS = {5, 10, 25, 50, 100, 250, 500, 1'000, 2'500, 5'000};
+
+  struct Snapshot
+  {
+    std::array<uint32_t, BOUNDS_MS.size() + 1> buckets = {};
+    uint32_t                                   count   = 0;
+    uint32_t                                   sumMs   = 0;
+  };
+
+  LatencyHistogram()  = default;
+  ~LatencyHistogram() = default;
+
+  LatencyHistogram(const LatencyHistogram&)                    = delete;
+  auto operator=(const LatencyHistogram&) -> LatencyHistogram& = delete;
+  LatencyHistogram(LatencyHistogram&&)                         = delete;
+  auto operator=(LatencyHistogram&&) -> LatencyHistogram&      = delete;
+
+  void record(const uint32_t ms)
+  {
+    const auto bucket = static_cast<size_t>(std::ranges::lower_bound(BOUNDS_MS, ms) - BOUNDS_MS.begin());
+    buckets_.at(bucket).fetch_add(1, std::memory_order_relaxed);
+    sumMs_.fetch_add(ms, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  auto snapshot() const -> Snapshot
+  {
+    Snapshot result;
+    result.count = count_.load(std::memory_order_relaxed);
+    result.sumMs = sumMs_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < buckets_.size(); ++i)
+    {
+      result.buckets.at(i) = buckets_.at(i).load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+private:
+  std::array<std::atomic<uint32_t>, BOUNDS_MS.size() + 1> buckets_ = {};
+  std::atomic<uint32_t>                                   count_   = 0;
+  std::atomic<uint32_t>                                   sumMs_   = 0;
+};
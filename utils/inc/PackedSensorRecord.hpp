@@ -0,0 +1,214 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace PackedFixed
+{
+
+template <typename T>
+constexpr auto encode(const float value, const float scale) -> T
+{
+  const auto scaled = value * scale;
+  if (scaled != scaled)
+  {
+    return 0;
+  }
+  const auto clamped = std::clamp(scaled, static_cast<float>(std::numeric_limits<T>::min()),
+                                  static_cast<float>(std::numeric_limits<T>::max()));
+  return static_cast<T>((clamped < 0.0F) ? clamped - 0.5F : clamped + 0.5F);
+}
+
+template <typename T>
+constexpr auto decode(const T value, const float scale) -> float
+{
+  return static_cast<float>(value) / scale;
+}
+
+}  // namespace PackedFixed
+
+struct PackedSensorRecord
+{
+  static constexpr uint8_t ENVIRONMENT_VALID = 1U << 0U;
+  static constexpr uint8_t LIGHT_VALID       = 1U << 1U;
+  static constexpr uint8_t SOIL_VALID        = 1U << 2U;
+  static constexpr uint8_t WATER_VALID       = 1U << 3U;
+  static constexpr uint8_t WATERING          = 1U << 7U;
+
+  static constexpr float TEMPERATURE_SCALE = 100.0F;
+  static constexpr float HUMIDITY_SCALE    = 100.0F;
+  static constexpr float PRESSURE_SCALE    = 10.0F;
+  static constexpr float PERCENT_SCALE     = 100.0F;
+  static constexpr float LUX_SCALE         = 1.0F;
+
+  static constexpr size_t FIELD_COUNT = 6;
+
+  uint16_t timeDelta   = 0;
+  int16_t  temperature = 0;
+  uint16_t humidity    = 0;
+  uint16_t pressure    = 0;
+  uint16_t soil        = 0;
+  uint16_t water       = 0;
+  uint16_t lux         = 0;
+  uint8_t  flags       = 0;
+  uint8_t  reserved    = 0;
+
+  static constexpr auto from(const SensorData& data, const bool watering, const uint16_t timeDelta = 0)
+    -> PackedSensorRecord
+  {
+    PackedSensorRecord record;
+    record.timeDelta = timeDelta;
+    if (data.environment.isValid())
+    {
+      record.temperature  = PackedFixed::encode<int16_t>(data.environment.temperature, TEMPERATURE_SCALE);
+      record.humidity     = PackedFixed::encode<uint16_t>(data.environment.humidity, HUMIDITY_SCALE);
+      record.pressure     = PackedFixed::encode<uint16_t>(data.environment.pressure, PRESSURE_SCALE);
+      record.flags       |= ENVIRONMENT_VALID;
+    }
+    if (data.light.isValid())
+    {
+      record.lux    = PackedFixed::encode<uint16_t>(data.light.lux, LUX_SCALE);
+      record.flags |= LIGHT_VALID;
+    }
+    if (data.soil.isValid())
+    {
+      record.soil   = PackedFixed::encode<uint16_t>(data.soil.percentage, PERCENT_SCALE);
+      record.flags |= SOIL_VALID;
+    }
+    if (data.water.isValid())
+    {
+      record.water  = PackedFixed::encode<uint16_t>(data.water.percentage, PERCENT_SCALE);
+      record.flags |= WATER_VALID;
+    }
+    if (watering)
+    {
+      record.flags |= WATERING;
+    }
+    return record;
+  }
+
+  constexpr auto toSensorData(const uint32_t timestamp) const -> SensorData
+  {
+    SensorData data;
+    data.environment = {
+      .temperature = PackedFixed::decode(temperature, TEMPERATURE_SCALE),
+      .humidity    = PackedFixed::decode(humidity, HUMIDITY_SCALE),
+      .pressure    = PackedFixed::decode(pressure, PRESSURE_SCALE),
+      .valid       = has(ENVIRONMENT_VALID),
+    };
+    data.light.lux        = PackedFixed::decode(lux, LUX_SCALE);
+    data.light.valid      = has(LIGHT_VALID);
+    data.soil.percentage  = PackedFixed::decode(soil, PERCENT_SCALE);
+    data.soil.valid       = has(SOIL_VALID);
+    data.water.percentage = PackedFixed::decode(water, PERCENT_SCALE);
+    data.water.valid      = has(WATER_VALID);
+    data.timestamp        = timestamp;
+    return data;
+  }
+
+  constexpr auto has(const uint8_t flag) const -> bool
+  {
+    return (flags & flag) != 0;
+  }
+  constexpr auto watering() const -> bool
+  {
+    return has(WATERING);
+  }
+
+  // Fields in declaration order (temperature, humidity, pressure, soil, water, lux), in packed units.
+  static constexpr auto fieldFlag(const size_t index) -> uint8_t
+  {
+    switch (index)
+    {
+      case 0:
+      case 1:
+      case 2:
+        return ENVIRONMENT_VALID;
+      case 3:
+        return SOIL_VALID;
+      case 4:
+        return WATER_VALID;
+      default:
+        return LIGHT_VALID;
+    }
+  }
+
+  constexpr auto field(const size_t index) const -> int32_t
+  {
+    switch (index)
+    {
+      case 0:
+        return temperature;
+      case 1:
+        return humidity;
+      case 2:
+        return pressure;
+      case 3:
+        return soil;
+      case 4:
+        return water;
+      default:
+        return lux;
+    }
+  }
+
+  constexpr void setField(const size_t index, const int32_t value)
+  {
+    switch (index)
+    {
+      case 0:
+        temperature = static_cast<int16_t>(value);
+        break;
+      case 1:
+        humidity = static_cast<uint16_t>(value);
+        break;
+      case 2:
+        pressure = static_cast<uint16_t>(value);
+        break;
+      case 3:
+        soil = static_cast<uint16_t>(value);
+        break;
+      case 4:
+        water = static_cast<uint16_t>(value);
+        break;
+      default:
+        lux = static_cast<uint16_t>(value);
+        break;
+    }
+  }
+};
+
+static_assert(sizeof(PackedSensorRecord) == 16, "Packed sensor record must stay 16 bytes");
+
+namespace PackedSensorRecordChecks
+{
+
+constexpr auto sample() -> SensorData
+{
+  SensorData data;
+  data.environment = {.temperature = -12.34F, .humidity = 56.78F, .pressure = 1'013.2F, .valid = true};
+  data.light.lux        = 1'234.0F;
+  data.light.valid      = true;
+  data.soil.percentage  = 42.5F;
+  data.soil.valid       = true;
+  data.water.percentage = 0.0F;
+  data.water.valid      = false;
+  return data;
+}
+
+inline constexpr auto PACKED   = PackedSensorRecord::from(sample(), true, 30);
+inline constexpr auto UNPACKED = PACKED.toSensorData(1'000);
+
+static_assert(PACKED.temperature == -1'234 and PACKED.humidity == 5'678 and PACKED.pressure == 10'132);
+static_assert(PACKED.lux == 1'234 and PACKED.soil == 4'250 and PACKED.timeDelta == 30 and PACKED.watering());
+static_assert(PACKED.has(PackedSensorRecord::SOIL_VALID) and not PACKED.has(PackedSensorRecord::WATER_VALID));
+static_assert(UNPACKED.environment.isValid() and not UNPACKED.water.isValid() and UNPACKED.timestamp == 1'000);
+static_assert(PACKED.field(0) == -1'234 and PACKED.field(5) == 1'234 and PACKED.has(PackedSensorRecord::fieldFlag(3)));
+static_assert(PackedFixed::encode<uint16_t>(-5.0F, 100.0F) == 0);
+static_assert(PackedFixed::encode<int16_t>(400.0F, 100.0F) == 32'767);
+
+}  // namespace PackedSensorRecordChecks
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Config.hpp"
+#include "PackedSensorRecord.hpp"
+
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+struct RollupBucket
+{
+  uint32_t           start = 0;
+  uint32_t           count = 0;
+  PackedSensorRecord min;
+  PackedSensorRecord max;
+  PackedSensorRecord mean;
+};
+
+class RollupTier final
+{
+public:
+  RollupTier(uint32_t seconds, std::span<RollupBucket> ring);
+
+  void add(uint32_t time, const PackedSensorRecord& record);
+  auto collect(uint32_t from, uint32_t to, std::span<RollupBucket> out) const -> size_t;
+
+  auto seconds() const -> uint32_t;
+  auto oldest() const -> uint32_t;
+
+private:
+  static constexpr size_t FIELDS = PackedSensorRecord::FIELD_COUNT;
+
+  struct Accumulator
+  {
+    uint32_t                     start = 0;
+    uint32_t                     count = 0;
+    uint8_t                      flags = 0;
+    std::array<int32_t, FIELDS>  min   = {};
+    std::array<int32_t, FIELDS>  max   = {};
+    std::array<int64_t, FIELDS>  sum   = {};
+    std::array<uint32_t, FIELDS> valid = {};
+  };
+
+  static auto toBucket(const Accumulator& open) -> RollupBucket;
+
+  auto at(size_t index) const -> const RollupBucket&;
+  void close();
+
+  uint32_t                seconds_;
+  std::span<RollupBucket> ring_;
+  size_t                  head_ = 0;
+  size_t                  size_ = 0;
+  Accumulator             open_;
+};
+
+class RollupStore final
+{
+public:
+  using Visitor = std::function<bool(const RollupBucket& bucket)>;
+
+  static constexpr uint32_t RAW = 0;
+
+  RollupStore(const RollupStore&)                    = delete;
+  auto operator=(const RollupStore&) -> RollupStore& = delete;
+  RollupStore(RollupStore&&)                         = delete;
+  auto operator=(RollupStore&&) -> RollupStore&      = delete;
+
+  static auto getInstance() -> RollupStore&;
+
+  auto init() -> bool;
+  void add(uint32_t time, const PackedSensorRecord& record);
+
+  auto resolutionFor(uint32_t from, uint32_t step) const -> uint32_t;
+  auto forEach(uint32_t resolution, uint32_t from, uint32_t to, const Visitor& visit) const -> size_t;
+
+private:
+  static constexpr size_t CHUNK_BUCKETS = 8;
+
+  RollupStore();
+  ~RollupStore() = default;
+
+  auto tierFor(uint32_t resolution) const -> const RollupTier*;
+
+  SemaphoreHandle_t mutex_ = nullptr;
+
+  std::array<RollupBucket, Config::History::FIVE_MINUTE_BUCKETS> fiveMinuteRing_ = {};
+  std::array<RollupBucket, Config::History::HOURLY_BUCKETS>      hourlyRing_     = {};
+  std::array<RollupBucket, Config::History::DAILY_BUCKETS>       dailyRing_      = {};
+
+  std::array<RollupTier, 3> tiers_;
+};
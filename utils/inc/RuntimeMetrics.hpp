@@ -0,0 +1,55 @@
+#pragma once
+
+#include "LatencyHistogram.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class LatencyMetric : uint8_t
+{
+  ENVIRONMENT,
+  LIGHT,
+  SOIL,
+  WATER,
+  ACQUISITION,
+  COUNT,
+};
+
+class RuntimeMetrics final
+{
+public:
+  RuntimeMetrics(const RuntimeMetrics&)                    = delete;
+  auto operator=(const RuntimeMetrics&) -> RuntimeMetrics& = delete;
+  RuntimeMetrics(RuntimeMetrics&&)                         = delete;
+  auto operator=(RuntimeMetrics&&) -> RuntimeMetrics&      = delete;
+
+  static auto getInstance() -> RuntimeMetrics&;
+  static auto latencyName(LatencyMetric metric) -> const char*;
+
+  void recordLatency(LatencyMetric metric, uint32_t ms);
+  auto latency(LatencyMetric metric) const -> LatencyHistogram::Snapshot;
+
+  void countMqttPublish(bool accepted);
+  auto mqttPublished() const -> uint32_t;
+  auto mqttDropped() const -> uint32_t;
+  void countMqttRetry();
+  auto mqttRetries() const -> uint32_t;
+  void countMqttCoalesced();
+  auto mqttCoalesced() const -> uint32_t;
+  void setMqttQueueDepth(uint32_t depth);
+  auto mqttQueueDepth() const -> uint32_t;
+
+private:
+  RuntimeMetrics()  = default;
+  ~RuntimeMetrics() = default;
+
+  std::array<LatencyHistogram, static_cast<size_t>(LatencyMetric::COUNT)> latency_;
+
+  std::atomic<uint32_t> mqttPublished_  = 0;
+  std::atomic<uint32_t> mqttDropped_    = 0;
+  std::atomic<uint32_t> mqttRetries_    = 0;
+  std::atomic<uint32_t> mqttCoalesced_  = 0;
+  std::atomic<uint32_t> mqttQueueDepth_ = 0;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "DoubleBuffer.hpp"
+#include "Types.hpp"
+
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <task.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+struct SensorPayload
+{
+  std::array<char, 320> json      = {};
+  size_t                length    = 0;
+  uint32_t              timestamp = 0;
+  uint32_t              sequence  = 0;
+  bool                  watering  = false;
+
+  auto view() const -> std::string_view
+  {
+    return {json.data(), length};
+  }
+  auto empty() const -> bool
+  {
+    return length == 0;
+  }
+};
+
+class SensorPayloadCache final
+{
+public:
+  using Lease = DoubleBuffer<SensorPayload>::Lease;
+
+  SensorPayloadCache(const SensorPayloadCache&)                    = delete;
+  auto operator=(const SensorPayloadCache&) -> SensorPayloadCache& = delete;
+  SensorPayloadCache(SensorPayloadCache&&)                         = delete;
+  auto operator=(SensorPayloadCache&&) -> SensorPayloadCache&      = delete;
+
+  static auto getInstance() -> SensorPayloadCache&;
+
+  void update(const SensorData& data, bool watering);
+  auto acquire() const -> Lease;
+  auto copy(std::span<char> out) const -> std::string_view;
+
+  void setUpdateListener(TaskHandle_t task);
+  // Clears the listener only if it is still `task`, so a stale owner cannot unregister its successor.
+  void clearUpdateListener(TaskHandle_t task);
+
+  // Latest irrigation state, kept by the sensor task for readers that refresh the payload themselves.
+  void setWatering(bool watering);
+  auto isWatering() const -> bool;
+
+private:
+  SensorPayloadCache();
+  ~SensorPayloadCache() = default;
+
+  static auto serialize(const SensorData& data, bool watering, SensorPayload& payload) -> bool;
+
+  SemaphoreHandle_t           writeMutex_ = nullptr;
+  DoubleBuffer<SensorPayload> buffer_;
+  uint32_t                    sequence_   = 0;
+
+  TaskHandle_t      listener_ = nullptr;
+  std::atomic<bool> watering_ = false;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "PackedSensorRecord.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Gorilla-style block codec for sensor series, bit-packed MSB first into a caller-owned buffer. Timestamps are
+// delta-of-delta coded; each fixed-point field stores its zigzag residual to the previous sample using Gorilla's
+// leading-zero window (residuals rather than XOR, since +/-1 steps on integers flip many XOR bits). Each block is
+// self-contained; state is O(1) per field and nothing allocates.
+
+class BitWriter final
+{
+public:
+  explicit BitWriter(std::span<uint8_t> buffer = {});
+
+  auto write(uint32_t value, uint32_t bits) -> bool;
+  void truncate(size_t bit);
+  auto bits() const -> size_t;
+  auto capacity() const -> size_t;
+
+private:
+  std::span<uint8_t> buffer_;
+  size_t             bit_ = 0;
+};
+
+class BitReader final
+{
+public:
+  explicit BitReader(std::span<const uint8_t> buffer = {});
+
+  auto read(uint32_t bits, uint32_t& value) -> bool;
+  auto bits() const -> size_t;
+
+private:
+  std::span<const uint8_t> buffer_;
+  size_t                   bit_ = 0;
+};
+
+namespace SeriesCodec
+{
+
+inline constexpr size_t FIELDS = 6;
+
+struct Channel
+{
+  uint16_t previous = 0;
+  uint8_t  leading  = 0;
+  uint8_t  length   = 0;
+};
+
+struct State
+{
+  size_t                      count         = 0;
+  uint32_t                    previousTime  = 0;
+  int32_t                     previousDelta = 0;
+  uint8_t                     previousFlags = 0;
+  std::array<Channel, FIELDS> channels      = {};
+};
+
+inline constexpr size_t FIRST_RECORD_BITS = 32 + (FIELDS * 16) + 8;
+
+}  // namespace SeriesCodec
+
+class SeriesEncoder final
+{
+public:
+  explicit SeriesEncoder(std::span<uint8_t> buffer = {});
+
+  void reset(std::span<uint8_t> buffer);
+  auto append(uint32_t time, const PackedSensorRecord& record) -> bool;
+
+  auto count() const -> size_t;
+  auto bytes() const -> size_t;
+
+private:
+  auto encode(uint32_t time, const PackedSensorRecord& record) -> bool;
+  auto encodeTime(uint32_t time) -> bool;
+  auto encodeValue(SeriesCodec::Channel& channel, uint16_t value) -> bool;
+
+  BitWriter          writer_;
+  SeriesCodec::State state_;
+};
+
+class SeriesDecoder final
+{
+public:
+  SeriesDecoder(std::span<const uint8_t> buffer, size_t count);
+
+  auto next(uint32_t& time, PackedSensorRecord& record) -> bool;
+
+private:
+  auto decodeTime(uint32_t& time) -> bool;
+  auto decodeValue(SeriesCodec::Channel& channel, uint16_t& value) -> bool;
+
+  BitReader          reader_;
+  size_t             total_ = 0;
+  SeriesCodec::State state_;
+};
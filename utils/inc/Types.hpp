@@ -16,6 +16,8 @@ struct WifiCredentials
   std::array<char, 33> ssid  = {};
   std::array<char, 65> pass  = {};
   bool                 valid = false;
+
+  auto operator==(const WifiCredentials&) const -> bool = default;
 };
 
 struct MqttConfig
@@ -29,12 +31,16 @@ struct MqttConfig
   std::array<char, 32> baseTopic         = {};
   uint32_t             publishIntervalMs = 3'600'000;
   bool                 enabled           = true;
+
+  auto operator==(const MqttConfig&) const -> bool = default;
 };
 
 struct ApConfig
 {
   std::array<char, 33> ssid = {};
   std::array<char, 65> pass = {};
+
+  auto operator==(const ApConfig&) const -> bool = default;
 };
 
 enum class IrrigationMode : uint8_t
@@ -62,6 +68,7 @@ struct SystemConfig
   MqttConfig      mqtt;
   uint32_t        sensorReadIntervalMs = 3'600'000;
   IrrigationMode  irrigationMode       = IrrigationMode::EVAPOTRANSPIRATION;
+  uint32_t        discoveryFingerprint = 0;
 };
 
 struct EnvironmentData
@@ -81,6 +88,8 @@ struct SoilMoistureData
 {
   float    percentage = 0.0F;
   uint16_t rawValue   = 0;
+  float    rawMean    = 0.0F;
+  float    noise      = 0.0F;
   bool     valid      = false;
 
   constexpr auto isValid() const -> bool
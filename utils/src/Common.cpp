@@ -1,10 +1,50 @@
 #include "Common.hpp"
 
+#include <FreeRTOS.h>
 #include <pico/time.h>
+#include <projdefs.h>
+#include <task.h>
 
+#include <atomic>
 #include <cstdint>
 
+namespace
+{
+
+std::atomic<uint32_t> yieldedDelayMs{0};
+std::atomic<uint32_t> busyDelayMs{0};
+
+}  // namespace
+
 auto Utils::getTimeSinceBoot() -> uint32_t
 {
   return to_ms_since_boot(get_absolute_time());
 }
+
+void Utils::delayMs(const uint32_t ms)
+{
+  if (ms == 0)
+  {
+    return;
+  }
+
+  if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+  {
+    vTaskDelay(pdMS_TO_TICKS(ms) + 1);
+    yieldedDelayMs.fetch_add(ms, std::memory_order_relaxed);
+    return;
+  }
+
+  sleep_ms(ms);
+  busyDelayMs.fetch_add(ms, std::memory_order_relaxed);
+}
+
+auto Utils::getYieldedDelayMs() -> uint32_t
+{
+  return yieldedDelayMs.load(std::memory_order_relaxed);
+}
+
+auto Utils::getBusyDelayMs() -> uint32_t
+{
+  return busyDelayMs.load(std::memory_order_relaxed);
+}
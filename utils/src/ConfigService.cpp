@@ -0,0 +1,241 @@
+#include "ConfigService.hpp"
+#include "Config.hpp"
+#include "FlashManager.hpp"
+#include "Types.hpp"
+
+#include <FreeRTOS.h>
+#include <projdefs.h>
+#include <semphr.h>
+#include <task.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+
+template <size_t N>
+void copyDefault(std::array<char, N>& field, const char* const value)
+{
+  if (value != nullptr)
+  {
+    std::strncpy(field.data(), value, field.size() - 1);
+  }
+}
+
+}  // namespace
+
+auto ConfigService::getInstance() -> ConfigService&
+{
+  static ConfigService instance;
+  return instance;
+}
+
+ConfigService::ConfigService() : writeMutex_(xSemaphoreCreateMutex())
+{
+  (void)buffer_.publish([](SystemConfig& config) { config = defaults(); });
+}
+
+auto ConfigService::defaults() -> SystemConfig
+{
+  SystemConfig config;
+  config.sensorReadIntervalMs = Config::DEFAULT_SENSOR_READ_INTERVAL_MS;
+  config.irrigationMode       = Config::DEFAULT_IRRIGATION_MODE;
+  copyDefault(config.ap.ssid, Config::AP::DEFAULT_SSID);
+  copyDefault(config.ap.pass, Config::AP::DEFAULT_PASS);
+  copyDefault(config.wifi.ssid, Config::WiFi::DEFAULT_SSID);
+  copyDefault(config.wifi.pass, Config::WiFi::DEFAULT_PASS);
+  config.mqtt.brokerPort        = Config::MQTT::DEFAULT_BROKER_PORT;
+  config.mqtt.publishIntervalMs = Config::MQTT::DEFAULT_PUBLISH_INTERVAL_MS;
+  copyDefault(config.mqtt.brokerHost, Config::MQTT::DEFAULT_BROKER_HOST);
+  copyDefault(config.mqtt.clientId, Config::MQTT::DEFAULT_CLIENT_ID);
+  copyDefault(config.mqtt.username, Config::MQTT::DEFAULT_USERNAME);
+  copyDefault(config.mqtt.password, Config::MQTT::DEFAULT_PASSWORD);
+  copyDefault(config.mqtt.discoveryPrefix, Config::MQTT::DEFAULT_DISCOVERY_PREFIX);
+  copyDefault(config.mqtt.baseTopic, Config::MQTT::DEFAULT_BASE_TOPIC);
+  return config;
+}
+
+auto ConfigService::diff(const SystemConfig& before, const SystemConfig& after) -> uint32_t
+{
+  uint32_t changed = 0;
+  if (before.wifi != after.wifi)
+  {
+    changed |= ConfigField::WIFI;
+  }
+  if (before.ap != after.ap)
+  {
+    changed |= ConfigField::AP;
+  }
+  if (before.mqtt != after.mqtt)
+  {
+    changed |= ConfigField::MQTT;
+  }
+  if (before.sensorReadIntervalMs != after.sensorReadIntervalMs)
+  {
+    changed |= ConfigField::SENSOR_INTERVAL;
+  }
+  if (before.irrigationMode != after.irrigationMode)
+  {
+    changed |= ConfigField::IRRIGATION_MODE;
+  }
+  if (before.discoveryFingerprint != after.discoveryFingerprint)
+  {
+    changed |= ConfigField::DISCOVERY;
+  }
+  return changed;
+}
+
+auto ConfigService::waitForChanges(const TickType_t timeout) -> uint32_t
+{
+  uint32_t changed = 0;
+  if (xTaskNotifyWaitIndexed(Config::CONFIG_NOTIFY_INDEX, 0, std::numeric_limits<uint32_t>::max(), &changed,
+                             timeout) != pdPASS)
+  {
+    return 0;
+  }
+  return changed;
+}
+
+auto ConfigService::load() -> bool
+{
+  SystemConfig config;
+  const auto   loaded = FlashManager::loadConfig(config);
+  if (not loaded)
+  {
+    printf("[ConfigService] No stored configuration, using defaults\n");
+    config = defaults();
+  }
+
+  if ((writeMutex_ == nullptr) or (xSemaphoreTake(writeMutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return false;
+  }
+  const auto published = buffer_.publish([&config](SystemConfig& current) { current = config; });
+  if (published)
+  {
+    ++version_;
+  }
+  xSemaphoreGive(writeMutex_);
+  return loaded and published;
+}
+
+auto ConfigService::acquire() const -> Lease
+{
+  return buffer_.acquire();
+}
+
+auto ConfigService::snapshot() const -> SystemConfig
+{
+  const auto lease = buffer_.acquire();
+  return *lease;
+}
+
+auto ConfigService::version() const -> uint32_t
+{
+  return version_.load();
+}
+
+auto ConfigService::update(const SystemConfig& config) -> bool
+{
+  if ((writeMutex_ == nullptr) or (xSemaphoreTake(writeMutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return false;
+  }
+  const auto applied = apply(config);
+  xSemaphoreGive(writeMutex_);
+  return applied;
+}
+
+// Read-modify-write under the write lock, so a concurrent update from the config API is never overwritten.
+auto ConfigService::setDiscoveryFingerprint(const uint32_t fingerprint) -> bool
+{
+  if ((writeMutex_ == nullptr) or (xSemaphoreTake(writeMutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return false;
+  }
+  auto config                 = snapshot();
+  config.discoveryFingerprint = fingerprint;
+  const auto applied          = apply(config);
+  xSemaphoreGive(writeMutex_);
+  return applied;
+}
+
+auto ConfigService::subscribe(TaskHandle_t const task, const uint32_t fields) -> bool
+{
+  if ((task == nullptr) or (writeMutex_ == nullptr) or (xSemaphoreTake(writeMutex_, portMAX_DELAY) != pdPASS))
+    [[unlikely]]
+  {
+    return false;
+  }
+
+  auto subscribed = false;
+  for (size_t i = 0; i < subscriberCount_; ++i)
+  {
+    if (subscribers_.at(i).task == task)
+    {
+      subscribers_.at(i).fields |= fields;
+      subscribed                 = true;
+    }
+  }
+  if (not subscribed and (subscriberCount_ < subscribers_.size()))
+  {
+    subscribers_.at(subscriberCount_++) = {.task = task, .fields = fields};
+    subscribed                          = true;
+  }
+
+  xSemaphoreGive(writeMutex_);
+  if (not subscribed) [[unlikely]]
+  {
+    printf("[ConfigService] Subscriber table full\n");
+  }
+  return subscribed;
+}
+
+auto ConfigService::apply(const SystemConfig& config) -> bool
+{
+  const auto changed = [&]
+  {
+    const auto current = buffer_.acquire();
+    return diff(*current, config);
+  }();
+  if (changed == 0)
+  {
+    return true;
+  }
+
+  if (not FlashManager::saveConfig(config)) [[unlikely]]
+  {
+    printf("[ConfigService] Failed to persist configuration\n");
+    return false;
+  }
+
+  if (not buffer_.publish([&config](SystemConfig& current) { current = config; })) [[unlikely]]
+  {
+    printf("[ConfigService] Configuration saved but not applied\n");
+    return false;
+  }
+  ++version_;
+  notify(changed);
+
+  printf("[ConfigService] Configuration v%lu applied (changed 0x%02lx)\n", static_cast<unsigned long>(version_.load()),
+         static_cast<unsigned long>(changed));
+  return true;
+}
+
+void ConfigService::notify(const uint32_t changed)
+{
+  for (size_t i = 0; i < subscriberCount_; ++i)
+  {
+    const auto& subscriber = subscribers_.at(i);
+    const auto  relevant   = changed & subscriber.fields;
+    if (relevant != 0)
+    {
+      (void)xTaskNotifyIndexed(subscriber.task, Config::CONFIG_NOTIFY_INDEX, relevant, eSetBits);
+    }
+  }
+}
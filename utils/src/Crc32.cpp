@@ -0,0 +1,84 @@
+#include "Crc32.hpp"
+
+#include <hardware/dma.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+namespace
+{
+
+inline constexpr uint32_t SNIFF_CRC32_REVERSED_DATA = 0x1;
+
+inline constexpr std::array<uint8_t, 9> CHECK_INPUT = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+static_assert(Crc32::software(std::span<const uint8_t>()) == 0);
+static_assert(Crc32::software(CHECK_INPUT) == 0xCB'F4'39'26U);
+static_assert(Crc32::software(std::span(CHECK_INPUT).subspan(4), Crc32::software(std::span(CHECK_INPUT).first(4))) ==
+              0xCB'F4'39'26U);
+
+std::atomic<int32_t> snifferChannel = -1;
+std::atomic_flag     snifferBusy    = ATOMIC_FLAG_INIT;
+volatile uint8_t     snifferSink    = 0;
+
+constexpr auto reverseBits(uint32_t value) -> uint32_t
+{
+  uint32_t result = 0;
+  for (int32_t bit = 0; bit < 32; ++bit)
+  {
+    result   = (result << 1U) | (value & 1U);
+    value  >>= 1U;
+  }
+  return result;
+}
+
+}  // namespace
+
+auto Crc32::init() -> bool
+{
+  if (snifferChannel.load() >= 0)
+  {
+    return true;
+  }
+
+  const auto channel = dma_claim_unused_channel(false);
+  if (channel < 0) [[unlikely]]
+  {
+    printf("[Crc32] No DMA channel available, using software CRC\n");
+    return false;
+  }
+  snifferChannel = channel;
+  return true;
+}
+
+auto Crc32::hardware(const std::span<const uint8_t> data, const uint32_t crc) -> uint32_t
+{
+  const auto channel = snifferChannel.load();
+  if ((channel < 0) or data.empty() or snifferBusy.test_and_set(std::memory_order_acquire))
+  {
+    return software(data, crc);
+  }
+
+  auto config = dma_channel_get_default_config(static_cast<uint>(channel));
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+  channel_config_set_read_increment(&config, true);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_sniff_enable(&config, true);
+
+  dma_sniffer_set_data_accumulator(reverseBits(~crc));
+  dma_sniffer_set_output_reverse_enabled(true);
+  dma_sniffer_set_output_invert_enabled(true);
+  dma_sniffer_enable(static_cast<uint>(channel), SNIFF_CRC32_REVERSED_DATA, true);
+
+  dma_channel_configure(static_cast<uint>(channel), &config, &snifferSink, data.data(), data.size(), true);
+  dma_channel_wait_for_finish_blocking(static_cast<uint>(channel));
+
+  const auto result = dma_sniffer_get_data_accumulator();
+  dma_sniffer_disable();
+  snifferBusy.clear(std::memory_order_release);
+  return result;
+}
@@ -1,4 +1,5 @@
 #include "FlashManager.hpp"
+#include "Crc32.hpp"
 #include "Types.hpp"
 
 #include <FreeRTOS.h>
@@ -7,7 +8,6 @@
 #include <cyw43_configport.h>
 #include <hardware/flash.h>
 #include <hardware/regs/addressmap.h>
-#include <hardware/sync.h>
 #include <pico/cyw43_arch.h>
 #include <pico/error.h>
 #include <pico/flash.h>
@@ -16,9 +16,10 @@
 #include <pico/platform/sections.h>
 #include <pico/stdio.h>
 #include <pico/time.h>
-#include <task.h>
 
+#include <algorithm>
 #include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
@@ -27,31 +28,70 @@
 namespace
 {
 
-inline constexpr uint32_t CONFIG_MAGIC      = 0x53'59'53'43U;
-inline constexpr uint32_t CRC32_POLYNOMIAL  = 0xED'B8'83'20U;
-inline constexpr uint32_t CRC32_INITIAL     = 0xFF'FF'FF'FFU;
-inline constexpr uint32_t SAVING_TIMEOUT_MS = 2'000U;
+inline constexpr uint32_t CONFIG_MAGIC         = 0x53'59'53'43U;
+inline constexpr uint32_t JOURNAL_MAGIC        = 0x4A'52'4E'32U;
+inline constexpr uint32_t JOURNAL_V1_MAGIC     = 0x4A'52'4E'4CU;
+inline constexpr uint32_t ERASED_WORD          = 0xFF'FF'FF'FFU;
+inline constexpr uint32_t SAVING_TIMEOUT_MS    = 2'000U;
+inline constexpr uint32_t JOURNAL_SECTORS      = 4;
+inline constexpr uint32_t JOURNAL_SLOT_SIZE    = 2 * FLASH_PAGE_SIZE;
+inline constexpr uint32_t SLOTS_PER_SECTOR     = FLASH_SECTOR_SIZE / JOURNAL_SLOT_SIZE;
+inline constexpr uint32_t JOURNAL_SLOTS        = JOURNAL_SECTORS * SLOTS_PER_SECTOR;
+inline constexpr uint32_t JOURNAL_OFFSET       = PICO_FLASH_SIZE_BYTES - (JOURNAL_SECTORS * FLASH_SECTOR_SIZE);
+inline constexpr uint32_t LEGACY_CONFIG_OFFSET = PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE;
 
-constexpr auto crc32(const void* const data, const size_t len) -> uint32_t
+static_assert(sizeof(FlashRecord) <= JOURNAL_SLOT_SIZE, "Configuration record must fit in one journal slot");
+static_assert(FLASH_SECTOR_SIZE % JOURNAL_SLOT_SIZE == 0, "Journal slots must tile a flash sector");
+
+// Records written before the discovery fingerprint was appended to SystemConfig hold only the fields before it.
+inline constexpr size_t V1_CONFIG_SIZE = offsetof(SystemConfig, discoveryFingerprint);
+
+using V1Config = std::array<uint8_t, V1_CONFIG_SIZE>;
+
+static_assert(V1_CONFIG_SIZE % sizeof(uint32_t) == 0, "Version 1 records must keep their CRC word aligned");
+
+struct LegacyFlashRecord
 {
-  auto        crc      = CRC32_INITIAL;
-  const auto* bytes    = static_cast<const uint8_t*>(data);
-  const auto  byteSpan = std::span<const uint8_t>(bytes, len);
-  for (const auto byte : byteSpan)
-  {
-    crc ^= byte;
-    for (int32_t j = 0; j < 8; ++j)
-    {
-      const auto mask = -(crc & 1U);
-      crc             = (crc >> 1U) ^ (CRC32_POLYNOMIAL & mask);
-    }
-  }
-  return ~crc;
+  uint32_t magic  = 0;
+  V1Config config = {};
+  uint32_t crc    = 0;
+};
+
+struct FlashRecordV1
+{
+  uint32_t magic    = 0;
+  uint32_t sequence = 0;
+  V1Config config   = {};
+  uint32_t crc      = 0;
+};
+
+constexpr auto slotOffset(const uint32_t slot) -> uint32_t
+{
+  return JOURNAL_OFFSET + (slot * JOURNAL_SLOT_SIZE);
 }
 
-constexpr auto getOffsetSize() -> uint32_t
+template <typename Record>
+auto recordCrc(const Record& record) -> uint32_t
 {
-  return PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE;
+  return Crc32::compute(&record.sequence, offsetof(Record, crc) - offsetof(Record, sequence));
+}
+
+auto upgradeConfig(const V1Config& stored) -> SystemConfig
+{
+  SystemConfig config;
+  std::memcpy(&config, stored.data(), stored.size());
+  return config;
+}
+
+auto isValidRecord(const uint32_t address) -> bool
+{
+  const auto* const record = std::bit_cast<const FlashRecord*>(address);
+  if (record->magic == JOURNAL_V1_MAGIC)
+  {
+    const auto* const previous = std::bit_cast<const FlashRecordV1*>(address);
+    return recordCrc(*previous) == previous->crc;
+  }
+  return (record->magic == JOURNAL_MAGIC) and (recordCrc(*record) == record->crc);
 }
 
 void __no_inline_not_in_flash_func(flashProgramTrampoline)(void* const param)
@@ -79,6 +119,11 @@ auto FlashManager::getFlashAddress(const uint32_t offset) -> uint32_t
   return XIP_BASE + offset;
 }
 
+auto FlashManager::configJournalOffset() -> uint32_t
+{
+  return JOURNAL_OFFSET;
+}
+
 auto FlashManager::read(const uint32_t offset, const std::span<uint8_t> buffer) -> bool
 {
   if (offset + buffer.size() > PICO_FLASH_SIZE_BYTES) [[unlikely]]
@@ -104,21 +149,11 @@ auto FlashManager::write(const uint32_t offset, const std::span<const uint8_t> d
     .size   = data.size(),
   };
 
-  if (not flushOutputBuffers()) [[unlikely]]
+  if (not execute(flashProgramTrampoline, ctx)) [[unlikely]]
   {
     return false;
   }
 
-  cyw43_arch_lwip_begin();
-  vTaskSuspendAll();
-
-  const auto interrupts = save_and_disable_interrupts();
-  flashProgramTrampoline(&ctx);
-  restore_interrupts(interrupts);
-
-  xTaskResumeAll();
-  cyw43_arch_lwip_end();
-
   printf("[FlashManager] Write succeeded\n");
 
   return true;
@@ -143,68 +178,184 @@ auto FlashManager::erase(const uint32_t offset, const size_t size) -> bool
     .size   = size,
   };
 
-  if (not flushOutputBuffers()) [[unlikely]]
+  if (not execute(flashEraseTrampoline, ctx)) [[unlikely]]
   {
     return false;
   }
 
-  cyw43_arch_lwip_begin();
-  vTaskSuspendAll();
+  printf("[FlashManager] Erase succeeded\n");
 
-  const auto interrupts = save_and_disable_interrupts();
-  flashEraseTrampoline(&ctx);
-  restore_interrupts(interrupts);
+  return true;
+}
 
-  xTaskResumeAll();
-  cyw43_arch_lwip_end();
+auto FlashManager::loadConfig(SystemConfig& config) -> bool
+{
+  auto newest = FlashRecord{};
+  if (scanJournal(&newest).newestSlot < 0)
+  {
+    return loadLegacyConfig(config);
+  }
 
-  printf("[FlashManager] Erase succeeded\n");
+  config = newest.config;
+  return true;
+}
+
+auto FlashManager::saveConfig(const SystemConfig& config) -> bool
+{
+  const auto state = scanJournal(nullptr);
+
+  auto slot = static_cast<uint32_t>(state.newestSlot + 1) % JOURNAL_SLOTS;
+  while (not isSlotErased(slot))
+  {
+    if ((slot % SLOTS_PER_SECTOR) == 0)
+    {
+      if (not erase(slotOffset(slot), FLASH_SECTOR_SIZE)) [[unlikely]]
+      {
+        return false;
+      }
+      break;
+    }
+    slot = (slot + 1) % JOURNAL_SLOTS;
+  }
+
+  auto record = FlashRecord{
+    .magic    = JOURNAL_MAGIC,
+    .sequence = state.nextSequence,
+    .config   = config,
+    .crc      = 0,
+  };
+  record.crc = recordCrc(record);
+
+  std::array<uint8_t, JOURNAL_SLOT_SIZE> buffer{};
+  buffer.fill(0xFF);
+  std::memcpy(buffer.data(), &record, sizeof(record));
 
+  if (not write(slotOffset(slot), buffer)) [[unlikely]]
+  {
+    return false;
+  }
+
+  printf("[FlashManager] Config record %lu stored in slot %lu\n", static_cast<unsigned long>(record.sequence),
+         static_cast<unsigned long>(slot));
   return true;
 }
 
-auto FlashManager::loadConfig(SystemConfig& config) -> bool
+auto FlashManager::scanJournal(FlashRecord* const newest) -> JournalState
 {
-  const auto offset = getOffsetSize();
-  auto       record = FlashRecord{};
+  JournalState state;
+  uint32_t     newestSequence = 0;
+  for (uint32_t slot = 0; slot < JOURNAL_SLOTS; ++slot)
+  {
+    const auto        address = getFlashAddress(slotOffset(slot));
+    const auto* const record  = std::bit_cast<const FlashRecord*>(address);
+    if (((record->magic != JOURNAL_MAGIC) and (record->magic != JOURNAL_V1_MAGIC)) or
+        ((state.newestSlot >= 0) and (record->sequence <= newestSequence)))
+    {
+      continue;
+    }
+    if (not isValidRecord(address)) [[unlikely]]
+    {
+      continue;
+    }
+
+    state.newestSlot = static_cast<int32_t>(slot);
+    newestSequence   = record->sequence;
+  }
 
-  if (not read(offset, std::span(reinterpret_cast<uint8_t*>(&record), sizeof(record)))) [[unlikely]]
+  if (state.newestSlot >= 0)
+  {
+    state.nextSequence = newestSequence + 1;
+    if (newest != nullptr)
+    {
+      (void)readRecord(static_cast<uint32_t>(state.newestSlot), *newest);
+    }
+  }
+  return state;
+}
+
+auto FlashManager::readRecord(const uint32_t slot, FlashRecord& record) -> bool
+{
+  auto previous = FlashRecordV1{};
+  if (not read(slotOffset(slot), std::span(reinterpret_cast<uint8_t*>(&previous), sizeof(previous)))) [[unlikely]]
   {
     return false;
   }
-  if (record.magic != CONFIG_MAGIC) [[unlikely]]
+  if (previous.magic != JOURNAL_V1_MAGIC)
+  {
+    return read(slotOffset(slot), std::span(reinterpret_cast<uint8_t*>(&record), sizeof(record)));
+  }
+
+  record = FlashRecord{
+    .magic    = previous.magic,
+    .sequence = previous.sequence,
+    .config   = upgradeConfig(previous.config),
+    .crc      = previous.crc,
+  };
+  return true;
+}
+
+auto FlashManager::loadLegacyConfig(SystemConfig& config) -> bool
+{
+  auto record = LegacyFlashRecord{};
+  if (not read(LEGACY_CONFIG_OFFSET, std::span(reinterpret_cast<uint8_t*>(&record), sizeof(record)))) [[unlikely]]
   {
     return false;
   }
-  const uint32_t calculatedCrc = crc32(&record.config, sizeof(record.config));
-  if (calculatedCrc != record.crc) [[unlikely]]
+  if ((record.magic != CONFIG_MAGIC) or (Crc32::compute(&record.config, sizeof(record.config)) != record.crc))
+    [[unlikely]]
   {
     return false;
   }
 
-  config = record.config;
+  config = upgradeConfig(record.config);
   return true;
 }
 
-auto FlashManager::saveConfig(const SystemConfig& config) -> bool
+auto FlashManager::isSlotErased(const uint32_t slot) -> bool
 {
-  const auto offset = getOffsetSize();
-  const auto record = FlashRecord{
-    .magic  = CONFIG_MAGIC,
-    .config = config,
-    .crc    = crc32(&config, sizeof(config)),
-  };
+  return isErased(slotOffset(slot), JOURNAL_SLOT_SIZE);
+}
 
-  std::array<uint8_t, 1024> buffer{};
-  buffer.fill(0xFF);
-  std::memcpy(buffer.data(), &record, sizeof(record));
+auto FlashManager::isErased(const uint32_t offset, const size_t size) -> bool
+{
+  if ((offset + size > PICO_FLASH_SIZE_BYTES) or (offset % sizeof(uint32_t) != 0) or (size % sizeof(uint32_t) != 0))
+    [[unlikely]]
+  {
+    return false;
+  }
 
-  if (not erase(offset, FLASH_SECTOR_SIZE)) [[unlikely]]
+  const auto* const words = std::bit_cast<const uint32_t*>(getFlashAddress(offset));
+  return std::all_of(words, words + (size / sizeof(uint32_t)), [](const uint32_t word) { return word == ERASED_WORD; });
+}
+
+// flash_safe_execute() parks the other core in RAM and disables interrupts on this one, so neither core fetches from
+// XIP while the flash is busy. Suspending the scheduler alone leaves the other SMP core running from flash.
+auto FlashManager::execute(void (*const operation)(void*), FlashOpContext& ctx) -> bool
+{
+  if (not flushOutputBuffers()) [[unlikely]]
   {
     return false;
   }
 
-  return write(offset, buffer);
+  // History init and commits can run before WifiDriver::init() has created the cyw43 async context (or after it
+  // failed); the lwIP lock only exists once that context does, and there is no network traffic to fence before then.
+  const auto lockNetwork = cyw43_arch_async_context() != nullptr;
+  if (lockNetwork)
+  {
+    cyw43_arch_lwip_begin();
+  }
+  const auto result = flash_safe_execute(operation, &ctx, SAVING_TIMEOUT_MS);
+  if (lockNetwork)
+  {
+    cyw43_arch_lwip_end();
+  }
+
+  if (result != PICO_OK) [[unlikely]]
+  {
+    printf("[FlashManager] Flash lockout failed: %d\n", result);
+    return false;
+  }
+  return true;
 }
 
 auto FlashManager::flushOutputBuffers() -> bool
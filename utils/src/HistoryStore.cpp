@@ -0,0 +1,440 @@
+#include "HistoryStore.hpp"
+#include "Common.hpp"
+#include "Config.hpp"
+#include "Crc32.hpp"
+#include "FlashManager.hpp"
+#include "PackedSensorRecord.hpp"
+#include "SeriesCodec.hpp"
+#include "Types.hpp"
+
+#include <FreeRTOS.h>
+#include <hardware/flash.h>
+#include <hardware/regs/addressmap.h>
+#include <projdefs.h>
+#include <semphr.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+extern "C" char __flash_binary_end;
+
+namespace
+{
+
+inline constexpr uint32_t HISTORY_MAGIC = 0x48'49'53'54U;
+
+static_assert(offsetof(HistoryPage, payload) == sizeof(HistoryPageHeader), "Payload must follow the page header");
+
+auto pageCrc(const HistoryPage& page) -> uint32_t
+{
+  return Crc32::compute(&page.header.sequence, sizeof(HistoryPage) - offsetof(HistoryPageHeader, sequence));
+}
+
+auto isValidPage(const HistoryPage& page) -> bool
+{
+  return (page.header.magic == HISTORY_MAGIC) and (page.header.count > 0) and
+         (page.header.count <= (HISTORY_PAYLOAD_BYTES * 8)) and (pageCrc(page) == page.header.crc);
+}
+
+auto hasWrapped(const uint32_t uptimeMs, const uint32_t lastUptimeMs) -> bool
+{
+  return (uptimeMs < lastUptimeMs) and ((lastUptimeMs - uptimeMs) > (1U << 31U));
+}
+
+}  // namespace
+
+auto HistoryStore::getInstance() -> HistoryStore&
+{
+  static HistoryStore instance;
+  return instance;
+}
+
+HistoryStore::HistoryStore() : mutex_(xSemaphoreCreateMutex())
+{
+  sectorFirstTime_.fill(EMPTY_SECTOR);
+  openPage();
+  setSampleInterval(Config::DEFAULT_SENSOR_READ_INTERVAL_MS);
+}
+
+auto HistoryStore::init() -> bool
+{
+  if (initialized_)
+  {
+    return true;
+  }
+
+  const auto firmwareEnd = std::bit_cast<uintptr_t>(&__flash_binary_end) - XIP_BASE;
+  if (firmwareEnd > regionOffset()) [[unlikely]]
+  {
+    printf("[HistoryStore] Firmware overlaps history region, history disabled\n");
+    return false;
+  }
+  if ((mutex_ == nullptr) or (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return false;
+  }
+
+  int32_t  newestPage     = -1;
+  uint32_t newestSequence = 0;
+  uint32_t newestTime     = 0;
+  for (uint32_t page = 0; page < PAGES; ++page)
+  {
+    const auto& stored = *std::bit_cast<const HistoryPage*>(FlashManager::getFlashAddress(pageOffset(page)));
+    if (not isValidPage(stored))
+    {
+      continue;
+    }
+
+    auto& sectorFirstTime = sectorFirstTime_.at(page / PAGES_PER_SECTOR);
+    if (sectorFirstTime == EMPTY_SECTOR)
+    {
+      sectorFirstTime = stored.header.firstTime;
+    }
+    if ((newestPage < 0) or (stored.header.sequence > newestSequence))
+    {
+      newestPage     = static_cast<int32_t>(page);
+      newestSequence = stored.header.sequence;
+      newestTime     = stored.header.lastTime;
+    }
+  }
+
+  head_         = (newestPage < 0) ? 0 : (static_cast<uint32_t>(newestPage) + 1) % PAGES;
+  nextSequence_ = newestSequence + 1;
+  timeBase_     = (newestPage < 0) ? 0 : newestTime + 1;
+
+  initialized_ = prepareHead();
+  xSemaphoreGive(mutex_);
+
+  printf("[HistoryStore] %lu pages, head at %lu, next sequence %lu\n", static_cast<unsigned long>(PAGES),
+         static_cast<unsigned long>(head_), static_cast<unsigned long>(nextSequence_));
+  return initialized_;
+}
+
+auto HistoryStore::append(const SensorData& data, const bool watering) -> bool
+{
+  if (not initialized_)
+  {
+    return false;
+  }
+
+  const auto record = PackedSensorRecord::from(data, watering);
+  if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS) [[unlikely]]
+  {
+    return false;
+  }
+
+  const auto time = toHistoryTime(data.timestamp);
+  if (hasWrapped(data.timestamp, lastUptimeMs_))
+  {
+    ++uptimeWraps_;
+  }
+  lastUptimeMs_ = data.timestamp;
+
+  auto stored = true;
+  if (not encoder_.append(time, record))
+  {
+    sealOpenPage();
+    if (sealedPages_ == pending_.size())
+    {
+      stored = commitLocked();
+    }
+    (void)encoder_.append(time, record);
+  }
+
+  auto& header = pending_.at(sealedPages_).header;
+  if (encoder_.count() == 1)
+  {
+    header.firstTime = time;
+    if (sealedPages_ == 0)
+    {
+      pendingSinceMs_ = data.timestamp;
+    }
+  }
+  header.lastTime = time;
+  header.count    = static_cast<uint16_t>(encoder_.count());
+
+  if (isStaleLocked(data.timestamp))
+  {
+    stored = commitLocked() and stored;
+  }
+  xSemaphoreGive(mutex_);
+  return stored;
+}
+
+auto HistoryStore::flush() -> bool
+{
+  if (not initialized_)
+  {
+    return false;
+  }
+  if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS) [[unlikely]]
+  {
+    return false;
+  }
+  const auto flushed = ((sealedPages_ == 0) and (encoder_.count() == 0)) or commitLocked();
+  xSemaphoreGive(mutex_);
+  return flushed;
+}
+
+// Backstop for when samples stop arriving; a steady stream commits through append() once the batch is full.
+auto HistoryStore::flushIfStale(const uint32_t nowMs) -> bool
+{
+  if (not initialized_)
+  {
+    return false;
+  }
+  if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS) [[unlikely]]
+  {
+    return false;
+  }
+  const auto flushed = not isStaleLocked(nowMs) or commitLocked();
+  xSemaphoreGive(mutex_);
+  return flushed;
+}
+
+// The age limit is counted in samples at this interval. FLUSH_AGE_SAMPLES is about two batches at the ~60 samples
+// per page a fast stream compresses to, so readings every few seconds always commit full batches. MAX_FLUSH_AGE_MS
+// caps it by wall time so a reset loses at most an hour of readings; slower streams commit partly filled pages, and
+// the lockouts batching would save at a few commits an hour do not matter.
+void HistoryStore::setSampleInterval(const uint32_t intervalMs)
+{
+  const auto ageMs = static_cast<uint64_t>(Config::History::FLUSH_AGE_SAMPLES) * intervalMs;
+  flushAgeMs_      = static_cast<uint32_t>(std::min<uint64_t>(ageMs, Config::History::MAX_FLUSH_AGE_MS));
+}
+
+auto HistoryStore::forEach(const uint32_t from, const uint32_t to, const Visitor& visit) -> size_t
+{
+  if (not initialized_ or (from > to) or (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS))
+  {
+    return 0;
+  }
+  auto cursor = findStartPage(from);
+  xSemaphoreGive(mutex_);
+
+  size_t   visited  = 0;
+  bool     stopped  = false;
+  bool     started  = false;
+  uint32_t lastTime = 0;
+  const auto emit   = [&](const uint32_t time, const PackedSensorRecord& record)
+  {
+    if ((time < from) or (started and (time <= lastTime)))
+    {
+      return;
+    }
+    if ((time > to) or not visit(time, record))
+    {
+      stopped = true;
+      return;
+    }
+    started  = true;
+    lastTime = time;
+    ++visited;
+  };
+  const auto emitPage = [&](const HistoryPage& source)
+  {
+    SeriesDecoder      decoder(source.payload, source.header.count);
+    uint32_t           time = 0;
+    PackedSensorRecord record;
+    while (not stopped and decoder.next(time, record))
+    {
+      emit(time, record);
+    }
+  };
+
+  HistoryPage page;
+  while (not stopped)
+  {
+    xSemaphoreTake(mutex_, portMAX_DELAY);
+    if (cursor == head_)
+    {
+      std::array<HistoryPage, BATCH_PAGES> pending;
+      const auto                           count = sealedPages_ + ((encoder_.count() > 0) ? 1 : 0);
+      std::copy_n(pending_.begin(), count, pending.begin());
+      xSemaphoreGive(mutex_);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        emitPage(pending.at(i));
+      }
+      break;
+    }
+    const auto valid = readPage(cursor, page);
+    xSemaphoreGive(mutex_);
+
+    cursor = (cursor + 1) % PAGES;
+    if (not valid or (page.header.lastTime < from))
+    {
+      continue;
+    }
+    if (page.header.firstTime > to)
+    {
+      break;
+    }
+    emitPage(page);
+  }
+  return visited;
+}
+
+auto HistoryStore::stats() const -> HistoryStats
+{
+  if ((mutex_ == nullptr) or (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return {};
+  }
+  const auto result = stats_;
+  xSemaphoreGive(mutex_);
+  return result;
+}
+
+auto HistoryStore::now() const -> uint32_t
+{
+  return toHistoryTime(Utils::getTimeSinceBoot());
+}
+
+auto HistoryStore::toHistoryTime(const uint32_t uptimeMs) const -> uint32_t
+{
+  const auto wraps = uptimeWraps_ + (hasWrapped(uptimeMs, lastUptimeMs_) ? 1 : 0);
+  return timeBase_ + (wraps * UPTIME_WRAP_SECONDS) + (uptimeMs / 1'000);
+}
+
+auto HistoryStore::regionOffset() -> uint32_t
+{
+  return FlashManager::configJournalOffset() - (SECTORS * FLASH_SECTOR_SIZE);
+}
+
+auto HistoryStore::pageOffset(const uint32_t page) -> uint32_t
+{
+  return regionOffset() + (page * FLASH_PAGE_SIZE);
+}
+
+auto HistoryStore::readPage(const uint32_t page, HistoryPage& out) -> bool
+{
+  return FlashManager::read(pageOffset(page), std::span(reinterpret_cast<uint8_t*>(&out), sizeof(out))) and
+         isValidPage(out);
+}
+
+auto HistoryStore::prepareHead() -> bool
+{
+  while (not FlashManager::isErased(pageOffset(head_), FLASH_PAGE_SIZE))
+  {
+    if ((head_ % PAGES_PER_SECTOR) == 0)
+    {
+      sectorFirstTime_.at(head_ / PAGES_PER_SECTOR) = EMPTY_SECTOR;
+      return FlashManager::erase(pageOffset(head_), FLASH_SECTOR_SIZE);
+    }
+    head_ = (head_ + 1) % PAGES;
+  }
+  return true;
+}
+
+auto HistoryStore::advanceHead(const uint32_t pages) -> bool
+{
+  head_ = (head_ + pages) % PAGES;
+  if ((head_ % PAGES_PER_SECTOR) != 0)
+  {
+    return true;
+  }
+  sectorFirstTime_.at(head_ / PAGES_PER_SECTOR) = EMPTY_SECTOR;
+  return FlashManager::erase(pageOffset(head_), FLASH_SECTOR_SIZE);
+}
+
+void HistoryStore::openPage()
+{
+  if (sealedPages_ == pending_.size())
+  {
+    encoder_.reset({});
+    return;
+  }
+  auto& page = pending_.at(sealedPages_);
+  page       = HistoryPage{};
+  encoder_.reset(page.payload);
+}
+
+void HistoryStore::sealOpenPage()
+{
+  auto& page           = pending_.at(sealedPages_);
+  page.header.magic    = HISTORY_MAGIC;
+  page.header.sequence = nextSequence_++;
+  page.header.crc      = pageCrc(page);
+  ++sealedPages_;
+  openPage();
+}
+
+auto HistoryStore::commitLocked() -> bool
+{
+  if (encoder_.count() > 0)
+  {
+    sealOpenPage();
+  }
+
+  const auto pages   = static_cast<uint32_t>(sealedPages_);
+  const auto buffer  = std::span(reinterpret_cast<const uint8_t*>(pending_.data()), pages * FLASH_PAGE_SIZE);
+  auto       stored  = true;
+  auto       written = uint32_t{0};
+  while (stored and (written < pages))
+  {
+    const auto run = std::min(pages - written, PAGES_PER_SECTOR - (head_ % PAGES_PER_SECTOR));
+    if ((head_ % PAGES_PER_SECTOR) == 0)
+    {
+      sectorFirstTime_.at(head_ / PAGES_PER_SECTOR) = pending_.at(written).header.firstTime;
+    }
+
+    const auto bytes = buffer.subspan(written * FLASH_PAGE_SIZE, run * FLASH_PAGE_SIZE);
+    stored           = FlashManager::write(pageOffset(head_), bytes) and advanceHead(run);
+    written         += run;
+  }
+
+  if (not stored) [[unlikely]]
+  {
+    printf("[HistoryStore] Failed to store %lu pages\n", static_cast<unsigned long>(pages));
+  }
+  else
+  {
+    ++stats_.commits;
+    stats_.pages += pages;
+    for (size_t i = 0; i < sealedPages_; ++i)
+    {
+      stats_.samples += pending_.at(i).header.count;
+    }
+  }
+  sealedPages_ = 0;
+  openPage();
+  return stored;
+}
+
+auto HistoryStore::isStaleLocked(const uint32_t nowMs) const -> bool
+{
+  const auto pending = (sealedPages_ > 0) or (encoder_.count() > 0);
+  return pending and ((nowMs - pendingSinceMs_) >= flushAgeMs_);
+}
+
+auto HistoryStore::findStartPage(const uint32_t from) const -> uint32_t
+{
+  const auto oldestSector = ((head_ / PAGES_PER_SECTOR) + 1) % SECTORS;
+  const auto sectorAt     = [oldestSector](const uint32_t index) { return (oldestSector + index) % SECTORS; };
+  const auto headSector   = head_ / PAGES_PER_SECTOR;
+  const auto searched     = (sectorFirstTime_.at(headSector) == EMPTY_SECTOR) ? SECTORS - 1 : SECTORS;
+
+  uint32_t low  = 0;
+  uint32_t high = searched;
+  while (low < high)
+  {
+    const auto middle    = low + ((high - low) / 2);
+    const auto firstTime = sectorFirstTime_.at(sectorAt(middle));
+    if ((firstTime == EMPTY_SECTOR) or (firstTime <= from))
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  return sectorAt((low == 0) ? 0 : low - 1) * PAGES_PER_SECTOR;
+}
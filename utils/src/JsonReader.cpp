@@ -0,0 +1,512 @@
+#include "JsonReader.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace
+{
+
+constexpr auto isDigit(const char ch) -> bool
+{
+  return (ch >= '0') and (ch <= '9');
+}
+
+constexpr auto isScalarCharacter(const char ch) -> bool
+{
+  return isDigit(ch) or ((ch >= 'a') and (ch <= 'z')) or (ch == 'E') or (ch == '-') or (ch == '+') or (ch == '.') or
+         (ch == ',') or (ch == ':');
+}
+
+constexpr auto hexValue(const char ch) -> int32_t
+{
+  if (isDigit(ch))
+  {
+    return ch - '0';
+  }
+  if ((ch >= 'a') and (ch <= 'f'))
+  {
+    return ch - 'a' + 10;
+  }
+  if ((ch >= 'A') and (ch <= 'F'))
+  {
+    return ch - 'A' + 10;
+  }
+  return -1;
+}
+
+auto appendChar(char* const out, const size_t capacity, size_t& length, const char ch) -> bool
+{
+  if (length >= capacity)
+  {
+    return false;
+  }
+  out[length++] = ch;
+  return true;
+}
+
+auto appendUtf8(char* const out, const size_t capacity, size_t& length, const uint32_t codePoint) -> bool
+{
+  std::array<char, 4> bytes{};
+  size_t              count = 0;
+  if (codePoint < 0x80U)
+  {
+    bytes[count++] = static_cast<char>(codePoint);
+  }
+  else if (codePoint < 0x800U)
+  {
+    bytes[count++] = static_cast<char>(0xC0U | (codePoint >> 6U));
+    bytes[count++] = static_cast<char>(0x80U | (codePoint & 0x3FU));
+  }
+  else if (codePoint < 0x1'00'00U)
+  {
+    bytes[count++] = static_cast<char>(0xE0U | (codePoint >> 12U));
+    bytes[count++] = static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU));
+    bytes[count++] = static_cast<char>(0x80U | (codePoint & 0x3FU));
+  }
+  else
+  {
+    bytes[count++] = static_cast<char>(0xF0U | (codePoint >> 18U));
+    bytes[count++] = static_cast<char>(0x80U | ((codePoint >> 12U) & 0x3FU));
+    bytes[count++] = static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU));
+    bytes[count++] = static_cast<char>(0x80U | (codePoint & 0x3FU));
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (not appendChar(out, capacity, length, bytes.at(i)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+JsonObjectReader::JsonObjectReader(const std::string_view json) : json_(json)
+{
+}
+
+auto JsonObjectReader::next(JsonMember& member) -> bool
+{
+  if ((state_ == State::DONE) or (error_ != JsonError::NONE))
+  {
+    return false;
+  }
+
+  if (state_ == State::START)
+  {
+    skipWhitespace();
+    if (not consume('{'))
+    {
+      return fail((pos_ >= json_.size()) ? JsonError::UNEXPECTED_END : JsonError::UNEXPECTED_CHARACTER);
+    }
+    state_ = State::MEMBER_OR_END;
+  }
+
+  skipWhitespace();
+  if (peek() == '}')
+  {
+    if (state_ != State::MEMBER_OR_END)
+    {
+      return fail(JsonError::UNEXPECTED_CHARACTER);
+    }
+    ++pos_;
+    state_ = State::DONE;
+    skipWhitespace();
+    return (pos_ == json_.size()) ? false : fail(JsonError::UNEXPECTED_CHARACTER);
+  }
+
+  size_t keyLength = 0;
+  if (not parseString(key_.data(), key_.size(), keyLength))
+  {
+    return false;
+  }
+  skipWhitespace();
+  if (not consume(':'))
+  {
+    return fail(JsonError::UNEXPECTED_CHARACTER);
+  }
+  skipWhitespace();
+
+  member     = JsonMember{};
+  member.key = std::string_view(key_.data(), keyLength);
+  if (not parseValue(member))
+  {
+    return false;
+  }
+
+  skipWhitespace();
+  if (consume(','))
+  {
+    state_ = State::MEMBER;
+    return true;
+  }
+  if (peek() == '}')
+  {
+    state_ = State::MEMBER_OR_END;
+    return true;
+  }
+  return fail((pos_ >= json_.size()) ? JsonError::UNEXPECTED_END : JsonError::UNEXPECTED_CHARACTER);
+}
+
+auto JsonObjectReader::error() const -> JsonError
+{
+  return error_;
+}
+
+auto JsonObjectReader::errorOffset() const -> size_t
+{
+  return errorOffset_;
+}
+
+auto JsonObjectReader::errorString(const JsonError error) -> const char*
+{
+  switch (error)
+  {
+    case JsonError::NONE:
+      return "none";
+    case JsonError::UNEXPECTED_END:
+      return "unexpected end of input";
+    case JsonError::UNEXPECTED_CHARACTER:
+      return "unexpected character";
+    case JsonError::INVALID_ESCAPE:
+      return "invalid escape sequence";
+    case JsonError::INVALID_NUMBER:
+      return "invalid number";
+    case JsonError::TOO_LONG:
+      return "value too long";
+    case JsonError::TOO_DEEP:
+      return "nesting too deep";
+  }
+  return "unknown";
+}
+
+auto JsonObjectReader::fail(const JsonError error) -> bool
+{
+  if (error_ == JsonError::NONE)
+  {
+    error_       = error;
+    errorOffset_ = pos_;
+  }
+  return false;
+}
+
+void JsonObjectReader::skipWhitespace()
+{
+  while (pos_ < json_.size())
+  {
+    const auto ch = json_[pos_];
+    if ((ch != ' ') and (ch != '\t') and (ch != '\n') and (ch != '\r'))
+    {
+      return;
+    }
+    ++pos_;
+  }
+}
+
+auto JsonObjectReader::peek() const -> char
+{
+  return (pos_ < json_.size()) ? json_[pos_] : '\0';
+}
+
+auto JsonObjectReader::consume(const char expected) -> bool
+{
+  if ((pos_ < json_.size()) and (json_[pos_] == expected))
+  {
+    ++pos_;
+    return true;
+  }
+  return false;
+}
+
+auto JsonObjectReader::consumeLiteral(const std::string_view literal) -> bool
+{
+  if (json_.substr(pos_, literal.size()) != literal)
+  {
+    return fail((json_.size() - pos_ < literal.size()) ? JsonError::UNEXPECTED_END : JsonError::UNEXPECTED_CHARACTER);
+  }
+  pos_ += literal.size();
+  return true;
+}
+
+auto JsonObjectReader::parseString(char* const out, const size_t capacity, size_t& length) -> bool
+{
+  if (not consume('"'))
+  {
+    return fail((pos_ >= json_.size()) ? JsonError::UNEXPECTED_END : JsonError::UNEXPECTED_CHARACTER);
+  }
+
+  length = 0;
+  while (pos_ < json_.size())
+  {
+    const auto ch = json_[pos_++];
+    if (ch == '"')
+    {
+      return true;
+    }
+    if (ch == '\\')
+    {
+      if (not parseEscape(out, capacity, length))
+      {
+        return false;
+      }
+      continue;
+    }
+    if (static_cast<uint8_t>(ch) < 0x20U)
+    {
+      --pos_;
+      return fail(JsonError::UNEXPECTED_CHARACTER);
+    }
+    if ((out != nullptr) and not appendChar(out, capacity, length, ch))
+    {
+      return fail(JsonError::TOO_LONG);
+    }
+  }
+  return fail(JsonError::UNEXPECTED_END);
+}
+
+auto JsonObjectReader::parseEscape(char* const out, const size_t capacity, size_t& length) -> bool
+{
+  if (pos_ >= json_.size())
+  {
+    return fail(JsonError::UNEXPECTED_END);
+  }
+
+  auto decoded = '\0';
+  switch (json_[pos_++])
+  {
+    case '"':
+      decoded = '"';
+      break;
+    case '\\':
+      decoded = '\\';
+      break;
+    case '/':
+      decoded = '/';
+      break;
+    case 'b':
+      decoded = '\b';
+      break;
+    case 'f':
+      decoded = '\f';
+      break;
+    case 'n':
+      decoded = '\n';
+      break;
+    case 'r':
+      decoded = '\r';
+      break;
+    case 't':
+      decoded = '\t';
+      break;
+    case 'u':
+    {
+      uint32_t codePoint = 0;
+      if (not parseHex4(codePoint))
+      {
+        return false;
+      }
+      if ((codePoint >= 0xD8'00U) and (codePoint <= 0xDB'FFU))
+      {
+        uint32_t low = 0;
+        if (not consume('\\') or not consume('u') or not parseHex4(low) or (low < 0xDC'00U) or (low > 0xDF'FFU))
+        {
+          return fail(JsonError::INVALID_ESCAPE);
+        }
+        codePoint = 0x1'00'00U + ((codePoint - 0xD8'00U) << 10U) + (low - 0xDC'00U);
+      }
+      else if ((codePoint >= 0xDC'00U) and (codePoint <= 0xDF'FFU))
+      {
+        return fail(JsonError::INVALID_ESCAPE);
+      }
+      if ((out != nullptr) and not appendUtf8(out, capacity, length, codePoint))
+      {
+        return fail(JsonError::TOO_LONG);
+      }
+      return true;
+    }
+    default:
+      --pos_;
+      return fail(JsonError::INVALID_ESCAPE);
+  }
+
+  if ((out != nullptr) and not appendChar(out, capacity, length, decoded))
+  {
+    return fail(JsonError::TOO_LONG);
+  }
+  return true;
+}
+
+auto JsonObjectReader::parseHex4(uint32_t& codePoint) -> bool
+{
+  if (json_.size() - pos_ < 4)
+  {
+    return fail(JsonError::UNEXPECTED_END);
+  }
+
+  codePoint = 0;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const auto digit = hexValue(json_[pos_]);
+    if (digit < 0)
+    {
+      return fail(JsonError::INVALID_ESCAPE);
+    }
+    codePoint = (codePoint << 4U) | static_cast<uint32_t>(digit);
+    ++pos_;
+  }
+  return true;
+}
+
+auto JsonObjectReader::parseNumber() -> bool
+{
+  const auto digits = [this]
+  {
+    const auto start = pos_;
+    while ((pos_ < json_.size()) and isDigit(json_[pos_]))
+    {
+      ++pos_;
+    }
+    return pos_ - start;
+  };
+
+  (void)consume('-');
+  if (consume('0'))
+  {
+    if (isDigit(peek()))
+    {
+      return fail(JsonError::INVALID_NUMBER);
+    }
+  }
+  else if (digits() == 0)
+  {
+    return fail(JsonError::INVALID_NUMBER);
+  }
+
+  if (consume('.') and (digits() == 0))
+  {
+    return fail(JsonError::INVALID_NUMBER);
+  }
+  if (consume('e') or consume('E'))
+  {
+    if (not consume('+'))
+    {
+      (void)consume('-');
+    }
+    if (digits() == 0)
+    {
+      return fail(JsonError::INVALID_NUMBER);
+    }
+  }
+  return true;
+}
+
+auto JsonObjectReader::parseValue(JsonMember& member) -> bool
+{
+  const auto start = pos_;
+  switch (peek())
+  {
+    case '"':
+    {
+      size_t length = 0;
+      if (not parseString(value_.data(), value_.size(), length))
+      {
+        return false;
+      }
+      member.type = JsonType::STRING;
+      member.text = std::string_view(value_.data(), length);
+      return true;
+    }
+    case 't':
+      member.type    = JsonType::BOOLEAN;
+      member.boolean = true;
+      return consumeLiteral("true");
+    case 'f':
+      member.type    = JsonType::BOOLEAN;
+      member.boolean = false;
+      return consumeLiteral("false");
+    case 'n':
+      member.type = JsonType::NULL_VALUE;
+      return consumeLiteral("null");
+    case '{':
+    case '[':
+      member.type = (peek() == '{') ? JsonType::OBJECT : JsonType::ARRAY;
+      if (not skipContainer())
+      {
+        return false;
+      }
+      member.text = json_.substr(start, pos_ - start);
+      return true;
+    case '\0':
+      if (pos_ >= json_.size())
+      {
+        return fail(JsonError::UNEXPECTED_END);
+      }
+      return fail(JsonError::UNEXPECTED_CHARACTER);
+    default:
+      if ((peek() != '-') and not isDigit(peek()))
+      {
+        return fail(JsonError::UNEXPECTED_CHARACTER);
+      }
+      if (not parseNumber())
+      {
+        return false;
+      }
+      member.type = JsonType::NUMBER;
+      member.text = json_.substr(start, pos_ - start);
+      return true;
+  }
+}
+
+auto JsonObjectReader::skipContainer() -> bool
+{
+  std::array<char, MAX_DEPTH> closers{};
+  size_t                      depth = 0;
+
+  while (pos_ < json_.size())
+  {
+    skipWhitespace();
+    const auto ch = peek();
+    if ((ch == '{') or (ch == '['))
+    {
+      if (depth >= closers.size())
+      {
+        return fail(JsonError::TOO_DEEP);
+      }
+      closers.at(depth++) = (ch == '{') ? '}' : ']';
+      ++pos_;
+    }
+    else if ((ch == '}') or (ch == ']'))
+    {
+      if ((depth == 0) or (closers.at(depth - 1) != ch))
+      {
+        return fail(JsonError::UNEXPECTED_CHARACTER);
+      }
+      ++pos_;
+      if (--depth == 0)
+      {
+        return true;
+      }
+    }
+    else if (ch == '"')
+    {
+      size_t ignored = 0;
+      if (not parseString(nullptr, 0, ignored))
+      {
+        return false;
+      }
+    }
+    else if (isScalarCharacter(ch))
+    {
+      ++pos_;
+    }
+    else if (pos_ < json_.size())
+    {
+      return fail(JsonError::UNEXPECTED_CHARACTER);
+    }
+  }
+  return fail(JsonError::UNEXPECTED_END);
+}
@@ -0,0 +1,275 @@
+#include "RollupStore.hpp"
+#include "Config.hpp"
+#include "HistoryStore.hpp"
+#include "PackedSensorRecord.hpp"
+
+#include <FreeRTOS.h>
+#include <projdefs.h>
+#include <semphr.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <span>
+
+namespace
+{
+
+inline constexpr uint32_t FIVE_MINUTES = 300;
+inline constexpr uint32_t ONE_HOUR     = 3'600;
+inline constexpr uint32_t ONE_DAY      = 86'400;
+
+constexpr auto roundedMean(const int64_t sum, const uint32_t count) -> int32_t
+{
+  const auto divisor = static_cast<int64_t>(count);
+  const auto bias    = (sum >= 0) ? divisor / 2 : -(divisor / 2);
+  return static_cast<int32_t>((sum + bias) / divisor);
+}
+
+static_assert(roundedMean(5, 2) == 3 and roundedMean(-5, 2) == -3 and roundedMean(4, 3) == 1);
+
+}  // namespace
+
+RollupTier::RollupTier(const uint32_t seconds, const std::span<RollupBucket> ring) : seconds_(seconds), ring_(ring) {}
+
+void RollupTier::add(const uint32_t time, const PackedSensorRecord& record)
+{
+  const auto start = time - (time % seconds_);
+  if ((open_.count > 0) and (start > open_.start))
+  {
+    close();
+  }
+  if (open_.count == 0)
+  {
+    open_.start = start;
+  }
+
+  ++open_.count;
+  open_.flags |= record.flags & PackedSensorRecord::WATERING;
+  for (size_t i = 0; i < FIELDS; ++i)
+  {
+    if (not record.has(PackedSensorRecord::fieldFlag(i)))
+    {
+      continue;
+    }
+    const auto value = record.field(i);
+    if (open_.valid.at(i) == 0)
+    {
+      open_.min.at(i) = value;
+      open_.max.at(i) = value;
+    }
+    open_.min.at(i)  = std::min(open_.min.at(i), value);
+    open_.max.at(i)  = std::max(open_.max.at(i), value);
+    open_.sum.at(i) += value;
+    ++open_.valid.at(i);
+  }
+}
+
+auto RollupTier::collect(const uint32_t from, const uint32_t to, const std::span<RollupBucket> out) const -> size_t
+{
+  size_t low  = 0;
+  size_t high = size_;
+  while (low < high)
+  {
+    const auto middle = low + ((high - low) / 2);
+    if ((at(middle).start + seconds_) <= from)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  size_t copied = 0;
+  for (auto i = low; (i < size_) and (copied < out.size()) and (at(i).start <= to); ++i)
+  {
+    out[copied++] = at(i);
+  }
+  if ((copied < out.size()) and (open_.count > 0) and ((open_.start + seconds_) > from) and (open_.start <= to))
+  {
+    out[copied++] = toBucket(open_);
+  }
+  return copied;
+}
+
+auto RollupTier::seconds() const -> uint32_t
+{
+  return seconds_;
+}
+
+auto RollupTier::oldest() const -> uint32_t
+{
+  if (size_ > 0)
+  {
+    return at(0).start;
+  }
+  return (open_.count > 0) ? open_.start : std::numeric_limits<uint32_t>::max();
+}
+
+auto RollupTier::toBucket(const Accumulator& open) -> RollupBucket
+{
+  RollupBucket bucket;
+  bucket.start = open.start;
+  bucket.count = open.count;
+
+  uint8_t flags = open.flags;
+  for (size_t i = 0; i < FIELDS; ++i)
+  {
+    if (open.valid.at(i) == 0)
+    {
+      continue;
+    }
+    flags |= PackedSensorRecord::fieldFlag(i);
+    bucket.min.setField(i, open.min.at(i));
+    bucket.max.setField(i, open.max.at(i));
+    bucket.mean.setField(i, roundedMean(open.sum.at(i), open.valid.at(i)));
+  }
+  bucket.min.flags  = flags;
+  bucket.max.flags  = flags;
+  bucket.mean.flags = flags;
+  return bucket;
+}
+
+auto RollupTier::at(const size_t index) const -> const RollupBucket&
+{
+  return ring_[(head_ + index) % ring_.size()];
+}
+
+void RollupTier::close()
+{
+  const auto bucket = toBucket(open_);
+  if (size_ < ring_.size())
+  {
+    ring_[(head_ + size_) % ring_.size()] = bucket;
+    ++size_;
+  }
+  else
+  {
+    ring_[head_] = bucket;
+    head_        = (head_ + 1) % ring_.size();
+  }
+  open_ = {};
+}
+
+auto RollupStore::getInstance() -> RollupStore&
+{
+  static RollupStore instance;
+  return instance;
+}
+
+RollupStore::RollupStore()
+  : mutex_(xSemaphoreCreateMutex()),
+    tiers_{RollupTier(FIVE_MINUTES, fiveMinuteRing_), RollupTier(ONE_HOUR, hourlyRing_),
+           RollupTier(ONE_DAY, dailyRing_)}
+{
+}
+
+auto RollupStore::init() -> bool
+{
+  if (mutex_ == nullptr) [[unlikely]]
+  {
+    return false;
+  }
+
+  auto&      history = HistoryStore::getInstance();
+  const auto now     = history.now();
+  const auto span    = static_cast<uint32_t>(ONE_DAY * Config::History::DAILY_BUCKETS);
+  const auto from    = (now > span) ? now - span : 0;
+
+  const auto replay = [this](const uint32_t time, const PackedSensorRecord& record)
+  {
+    add(time, record);
+    return true;
+  };
+  const auto replayed = history.forEach(from, now, replay);
+  printf("[RollupStore] Rebuilt rollups from %lu samples\n", static_cast<unsigned long>(replayed));
+  return true;
+}
+
+void RollupStore::add(const uint32_t time, const PackedSensorRecord& record)
+{
+  if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS) [[unlikely]]
+  {
+    return;
+  }
+  for (auto& tier : tiers_)
+  {
+    tier.add(time, record);
+  }
+  xSemaphoreGive(mutex_);
+}
+
+auto RollupStore::resolutionFor(const uint32_t from, const uint32_t step) const -> uint32_t
+{
+  if ((step < tiers_.front().seconds()) or (xSemaphoreTake(mutex_, portMAX_DELAY) != pdPASS))
+  {
+    return RAW;
+  }
+
+  size_t index = 0;
+  while (((index + 1) < tiers_.size()) and (tiers_.at(index + 1).seconds() <= step))
+  {
+    ++index;
+  }
+  while (((index + 1) < tiers_.size()) and (tiers_.at(index).oldest() > from))
+  {
+    ++index;
+  }
+  xSemaphoreGive(mutex_);
+  return tiers_.at(index).seconds();
+}
+
+auto RollupStore::forEach(const uint32_t resolution, const uint32_t from, const uint32_t to,
+                          const Visitor& visit) const -> size_t
+{
+  if (from > to)
+  {
+    return 0;
+  }
+
+  const auto* const tier = tierFor(resolution);
+  if (tier == nullptr)
+  {
+    const auto sample = [&visit](const uint32_t time, const PackedSensorRecord& record)
+    {
+      return visit(RollupBucket{.start = time, .count = 1, .min = record, .max = record, .mean = record});
+    };
+    return HistoryStore::getInstance().forEach(from, to, sample);
+  }
+
+  std::array<RollupBucket, CHUNK_BUCKETS> chunk;
+  size_t                                  visited = 0;
+  auto                                    cursor  = from;
+  while (xSemaphoreTake(mutex_, portMAX_DELAY) == pdPASS)
+  {
+    const auto count = tier->collect(cursor, to, chunk);
+    xSemaphoreGive(mutex_);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (not visit(chunk.at(i)))
+      {
+        return visited;
+      }
+      ++visited;
+    }
+    if (count < chunk.size())
+    {
+      break;
+    }
+    cursor = chunk.back().start + tier->seconds();
+  }
+  return visited;
+}
+
+auto RollupStore::tierFor(const uint32_t resolution) const -> const RollupTier*
+{
+  const auto matches = [resolution](const RollupTier& candidate) { return candidate.seconds() == resolution; };
+  const auto tier    = std::ranges::find_if(tiers_, matches);
+  return (tier == tiers_.end()) ? nullptr : &*tier;
+}
@@ -0,0 +1,81 @@
+#include "RuntimeMetrics.hpp"
+#include "LatencyHistogram.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+
+inline constexpr std::array<const char*, static_cast<size_t>(LatencyMetric::COUNT)> LATENCY_NAMES = {
+  "environment", "light", "soil", "water", "acquisition"};
+
+}  // namespace
+
+auto RuntimeMetrics::getInstance() -> RuntimeMetrics&
+{
+  static RuntimeMetrics instance;
+  return instance;
+}
+
+auto RuntimeMetrics::latencyName(const LatencyMetric metric) -> const char*
+{
+  return LATENCY_NAMES.at(static_cast<size_t>(metric));
+}
+
+void RuntimeMetrics::recordLatency(const LatencyMetric metric, const uint32_t ms)
+{
+  latency_.at(static_cast<size_t>(metric)).record(ms);
+}
+
+auto RuntimeMetrics::latency(const LatencyMetric metric) const -> LatencyHistogram::Snapshot
+{
+  return latency_.at(static_cast<size_t>(metric)).snapshot();
+}
+
+void RuntimeMetrics::countMqttPublish(const bool accepted)
+{
+  (accepted ? mqttPublished_ : mqttDropped_).fetch_add(1, std::memory_order_relaxed);
+}
+
+auto RuntimeMetrics::mqttPublished() const -> uint32_t
+{
+  return mqttPublished_.load(std::memory_order_relaxed);
+}
+
+auto RuntimeMetrics::mqttDropped() const -> uint32_t
+{
+  return mqttDropped_.load(std::memory_order_relaxed);
+}
+
+void RuntimeMetrics::countMqttRetry()
+{
+  mqttRetries_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto RuntimeMetrics::mqttRetries() const -> uint32_t
+{
+  return mqttRetries_.load(std::memory_order_relaxed);
+}
+
+void RuntimeMetrics::countMqttCoalesced()
+{
+  mqttCoalesced_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto RuntimeMetrics::mqttCoalesced() const -> uint32_t
+{
+  return mqttCoalesced_.load(std::memory_order_relaxed);
+}
+
+void RuntimeMetrics::setMqttQueueDepth(const uint32_t depth)
+{
+  mqttQueueDepth_.store(depth, std::memory_order_relaxed);
+}
+
+auto RuntimeMetrics::mqttQueueDepth() const -> uint32_t
+{
+  return mqttQueueDepth_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,140 @@
+#include "SensorPayloadCache.hpp"
+#include "JsonWriter.hpp"
+#include "Types.hpp"
+
+#include <FreeRTOS.h>
+#include <projdefs.h>
+#include <semphr.h>
+#include <task.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+auto SensorPayloadCache::getInstance() -> SensorPayloadCache&
+{
+  static SensorPayloadCache instance;
+  return instance;
+}
+
+SensorPayloadCache::SensorPayloadCache() : writeMutex_(xSemaphoreCreateMutex())
+{
+}
+
+void SensorPayloadCache::update(const SensorData& data, const bool watering)
+{
+  if ((writeMutex_ == nullptr) or (xSemaphoreTake(writeMutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return;
+  }
+
+  const auto upToDate = [&]
+  {
+    const auto current = buffer_.acquire();
+    return (not current->empty()) and (current->timestamp == data.timestamp) and (current->watering == watering);
+  }();
+
+  auto published = false;
+  if (not upToDate)
+  {
+    published = buffer_.publish(
+      [&](SensorPayload& payload)
+      {
+        (void)serialize(data, watering, payload);
+        payload.sequence = sequence_ + 1;
+      });
+    sequence_ += published ? 1 : 0;
+  }
+  watering_ = watering;
+
+  // Notified under the mutex so a listener cleared by clearUpdateListener() is never woken afterwards.
+  if (published and (listener_ != nullptr))
+  {
+    xTaskNotifyGive(listener_);
+  }
+
+  xSemaphoreGive(writeMutex_);
+}
+
+// Copies the bytes out so the lease is not held while the caller waits on a slow network peer.
+auto SensorPayloadCache::copy(const std::span<char> out) const -> std::string_view
+{
+  const auto payload = buffer_.acquire();
+  if (payload->length > out.size()) [[unlikely]]
+  {
+    return {};
+  }
+  std::memcpy(out.data(), payload->json.data(), payload->length);
+  return {out.data(), payload->length};
+}
+
+auto SensorPayloadCache::acquire() const -> Lease
+{
+  return buffer_.acquire();
+}
+
+void SensorPayloadCache::setUpdateListener(TaskHandle_t const task)
+{
+  if ((writeMutex_ == nullptr) or (xSemaphoreTake(writeMutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return;
+  }
+  listener_ = task;
+  xSemaphoreGive(writeMutex_);
+}
+
+void SensorPayloadCache::clearUpdateListener(TaskHandle_t const task)
+{
+  if ((writeMutex_ == nullptr) or (xSemaphoreTake(writeMutex_, portMAX_DELAY) != pdPASS)) [[unlikely]]
+  {
+    return;
+  }
+  if (listener_ == task)
+  {
+    listener_ = nullptr;
+  }
+  xSemaphoreGive(writeMutex_);
+}
+
+void SensorPayloadCache::setWatering(const bool watering)
+{
+  watering_ = watering;
+}
+
+auto SensorPayloadCache::isWatering() const -> bool
+{
+  return watering_;
+}
+
+auto SensorPayloadCache::serialize(const SensorData& data, const bool watering, SensorPayload& payload) -> bool
+{
+  const auto isLightDataValid = data.light.isValid();
+  const auto isWaterDataValid = data.water.isValid();
+
+  JsonWriter json(payload.json);
+  json.beginObject()
+    .field("temperature", data.environment.temperature, 2)
+    .field("humidity", data.environment.humidity, 2)
+    .field("pressure", data.environment.pressure, 2)
+    .field("soil_moisture", data.soil.percentage, 2)
+    .field("light_lux", isLightDataValid ? data.light.lux : 0.0F, 2)
+    .field("light_available", isLightDataValid)
+    .field("water_level", isWaterDataValid ? data.water.percentage : 0.0F, 2)
+    .field("water_level_available", isWaterDataValid)
+    .field("watering", watering)
+    .endObject();
+  if (not json.ok()) [[unlikely]]
+  {
+    printf("[SensorPayloadCache] Payload truncated\n");
+    payload.length = 0;
+    return false;
+  }
+
+  payload.length    = json.size();
+  payload.timestamp = data.timestamp;
+  payload.watering  = watering;
+  return true;
+}
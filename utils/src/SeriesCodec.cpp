@@ -0,0 +1,421 @@
+#include "SeriesCodec.hpp"
+#include "PackedSensorRecord.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace
+{
+
+struct TimeBucket
+{
+  uint32_t prefix     = 0;
+  uint32_t prefixBits = 0;
+  uint32_t valueBits  = 0;
+};
+
+inline constexpr std::array<TimeBucket, 3> TIME_BUCKETS = {{
+  {.prefix = 0b10, .prefixBits = 2, .valueBits = 7},
+  {.prefix = 0b110, .prefixBits = 3, .valueBits = 9},
+  {.prefix = 0b1110, .prefixBits = 4, .valueBits = 12},
+}};
+
+inline constexpr uint32_t RAW_TIME_PREFIX      = 0b1111;
+inline constexpr uint32_t RAW_TIME_PREFIX_BITS = 4;
+inline constexpr uint32_t VALUE_BITS           = 16;
+
+constexpr auto zigzagEncode(const int64_t value) -> uint64_t
+{
+  return (static_cast<uint64_t>(value) << 1U) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr auto zigzagDecode(const uint64_t value) -> int64_t
+{
+  return static_cast<int64_t>(value >> 1U) ^ -static_cast<int64_t>(value & 1U);
+}
+
+static_assert(zigzagDecode(zigzagEncode(-5)) == -5 and zigzagEncode(-1) == 1 and zigzagEncode(1) == 2);
+
+constexpr auto residualOf(const uint16_t value, const uint16_t previous) -> uint16_t
+{
+  return static_cast<uint16_t>(zigzagEncode(std::bit_cast<int16_t>(static_cast<uint16_t>(value - previous))));
+}
+
+constexpr auto applyResidual(const uint16_t previous, const uint16_t residual) -> uint16_t
+{
+  return static_cast<uint16_t>(previous + static_cast<uint16_t>(zigzagDecode(residual)));
+}
+
+static_assert(residualOf(2'200, 2'199) == 2 and residualOf(2'199, 2'200) == 1 and residualOf(0, 65'535) == 2);
+static_assert(applyResidual(65'535, residualOf(0, 65'535)) == 0);
+static_assert(applyResidual(100, residualOf(40'000, 100)) == 40'000);
+
+constexpr auto fieldsOf(const PackedSensorRecord& record) -> std::array<uint16_t, SeriesCodec::FIELDS>
+{
+  return {std::bit_cast<uint16_t>(record.temperature), record.humidity, record.pressure, record.soil, record.water,
+          record.lux};
+}
+
+constexpr void setFields(PackedSensorRecord& record, const std::array<uint16_t, SeriesCodec::FIELDS>& values)
+{
+  record.temperature = std::bit_cast<int16_t>(values[0]);
+  record.humidity    = values[1];
+  record.pressure    = values[2];
+  record.soil        = values[3];
+  record.water       = values[4];
+  record.lux         = values[5];
+}
+
+}  // namespace
+
+BitWriter::BitWriter(const std::span<uint8_t> buffer) : buffer_(buffer) {}
+
+auto BitWriter::write(const uint32_t value, const uint32_t bits) -> bool
+{
+  if ((bit_ + bits) > capacity())
+  {
+    return false;
+  }
+
+  auto remaining = bits;
+  while (remaining > 0)
+  {
+    const auto offset = static_cast<uint32_t>(bit_ % 8);
+    const auto free   = 8 - offset;
+    const auto take   = std::min(free, remaining);
+    const auto chunk  = (value >> (remaining - take)) & ((1U << take) - 1U);
+
+    auto& byte = buffer_[bit_ / 8];
+    if (offset == 0)
+    {
+      byte = 0;
+    }
+    byte      |= static_cast<uint8_t>(chunk << (free - take));
+    bit_      += take;
+    remaining -= take;
+  }
+  return true;
+}
+
+void BitWriter::truncate(const size_t bit)
+{
+  if (bit >= bit_)
+  {
+    return;
+  }
+  bit_ = bit;
+  if ((bit_ % 8) != 0)
+  {
+    buffer_[bit_ / 8] &= static_cast<uint8_t>(0xFFU << (8 - (bit_ % 8)));
+  }
+}
+
+auto BitWriter::bits() const -> size_t
+{
+  return bit_;
+}
+
+auto BitWriter::capacity() const -> size_t
+{
+  return buffer_.size() * 8;
+}
+
+BitReader::BitReader(const std::span<const uint8_t> buffer) : buffer_(buffer) {}
+
+auto BitReader::read(const uint32_t bits, uint32_t& value) -> bool
+{
+  if ((bit_ + bits) > (buffer_.size() * 8))
+  {
+    return false;
+  }
+
+  value          = 0;
+  auto remaining = bits;
+  while (remaining > 0)
+  {
+    const auto offset = static_cast<uint32_t>(bit_ % 8);
+    const auto free   = 8 - offset;
+    const auto take   = std::min(free, remaining);
+    const auto chunk  = (static_cast<uint32_t>(buffer_[bit_ / 8]) >> (free - take)) & ((1U << take) - 1U);
+
+    value      = (value << take) | chunk;
+    bit_      += take;
+    remaining -= take;
+  }
+  return true;
+}
+
+auto BitReader::bits() const -> size_t
+{
+  return bit_;
+}
+
+SeriesEncoder::SeriesEncoder(const std::span<uint8_t> buffer) : writer_(buffer) {}
+
+void SeriesEncoder::reset(const std::span<uint8_t> buffer)
+{
+  writer_ = BitWriter(buffer);
+  state_  = {};
+}
+
+auto SeriesEncoder::append(const uint32_t time, const PackedSensorRecord& record) -> bool
+{
+  const auto start = writer_.bits();
+  const auto saved = state_;
+  if (encode(time, record))
+  {
+    ++state_.count;
+    return true;
+  }
+  writer_.truncate(start);
+  state_ = saved;
+  return false;
+}
+
+auto SeriesEncoder::count() const -> size_t
+{
+  return state_.count;
+}
+
+auto SeriesEncoder::bytes() const -> size_t
+{
+  return (writer_.bits() + 7) / 8;
+}
+
+auto SeriesEncoder::encode(const uint32_t time, const PackedSensorRecord& record) -> bool
+{
+  const auto values = fieldsOf(record);
+  if (state_.count == 0)
+  {
+    state_.previousTime  = time;
+    state_.previousDelta = 0;
+    state_.previousFlags = record.flags;
+    if (not writer_.write(time, 32))
+    {
+      return false;
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      state_.channels.at(i).previous = values.at(i);
+      if (not writer_.write(values.at(i), VALUE_BITS))
+      {
+        return false;
+      }
+    }
+    return writer_.write(record.flags, 8);
+  }
+
+  if (not encodeTime(time))
+  {
+    return false;
+  }
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    if (not encodeValue(state_.channels.at(i), values.at(i)))
+    {
+      return false;
+    }
+  }
+  if (record.flags == state_.previousFlags)
+  {
+    return writer_.write(0b0, 1);
+  }
+  state_.previousFlags = record.flags;
+  return writer_.write(0b1, 1) and writer_.write(record.flags, 8);
+}
+
+auto SeriesEncoder::encodeTime(const uint32_t time) -> bool
+{
+  const auto delta     = static_cast<int32_t>(time - state_.previousTime);
+  const auto dod       = static_cast<int64_t>(delta) - state_.previousDelta;
+  state_.previousTime  = time;
+  state_.previousDelta = delta;
+  if (dod == 0)
+  {
+    return writer_.write(0b0, 1);
+  }
+
+  const auto zigzag = zigzagEncode(dod);
+  for (const auto& bucket : TIME_BUCKETS)
+  {
+    if (zigzag < (uint64_t{1} << bucket.valueBits))
+    {
+      return writer_.write(bucket.prefix, bucket.prefixBits) and
+             writer_.write(static_cast<uint32_t>(zigzag), bucket.valueBits);
+    }
+  }
+  return writer_.write(RAW_TIME_PREFIX, RAW_TIME_PREFIX_BITS) and writer_.write(static_cast<uint32_t>(delta), 32);
+}
+
+auto SeriesEncoder::encodeValue(SeriesCodec::Channel& channel, const uint16_t value) -> bool
+{
+  const auto residual = residualOf(value, channel.previous);
+  channel.previous    = value;
+  if (residual == 0)
+  {
+    return writer_.write(0b0, 1);
+  }
+
+  const auto leading  = static_cast<uint32_t>(std::countl_zero(residual));
+  const auto trailing = static_cast<uint32_t>(std::countr_zero(residual));
+  if ((channel.length > 0) and (leading >= channel.leading) and
+      (trailing >= (VALUE_BITS - channel.leading - channel.length)))
+  {
+    const auto shift = VALUE_BITS - channel.leading - channel.length;
+    return writer_.write(0b10, 2) and writer_.write(static_cast<uint32_t>(residual) >> shift, channel.length);
+  }
+
+  channel.leading = static_cast<uint8_t>(leading);
+  channel.length  = static_cast<uint8_t>(VALUE_BITS - leading - trailing);
+  return writer_.write(0b11, 2) and writer_.write(leading, 4) and writer_.write(channel.length - 1U, 4) and
+         writer_.write(static_cast<uint32_t>(residual) >> trailing, channel.length);
+}
+
+SeriesDecoder::SeriesDecoder(const std::span<const uint8_t> buffer, const size_t count)
+  : reader_(buffer), total_(count)
+{
+}
+
+auto SeriesDecoder::next(uint32_t& time, PackedSensorRecord& record) -> bool
+{
+  if (state_.count >= total_)
+  {
+    return false;
+  }
+
+  std::array<uint16_t, SeriesCodec::FIELDS> values{};
+  uint32_t                                  flags = 0;
+  if (state_.count == 0)
+  {
+    if (not reader_.read(32, time))
+    {
+      return false;
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      uint32_t value = 0;
+      if (not reader_.read(VALUE_BITS, value))
+      {
+        return false;
+      }
+      values.at(i)                   = static_cast<uint16_t>(value);
+      state_.channels.at(i).previous = values.at(i);
+    }
+    if (not reader_.read(8, flags))
+    {
+      return false;
+    }
+    state_.previousTime  = time;
+    state_.previousDelta = 0;
+  }
+  else
+  {
+    if (not decodeTime(time))
+    {
+      return false;
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      if (not decodeValue(state_.channels.at(i), values.at(i)))
+      {
+        return false;
+      }
+    }
+    uint32_t changed = 0;
+    flags            = state_.previousFlags;
+    if (not reader_.read(1, changed) or ((changed != 0) and not reader_.read(8, flags)))
+    {
+      return false;
+    }
+  }
+
+  record       = PackedSensorRecord{};
+  record.flags = static_cast<uint8_t>(flags);
+  setFields(record, values);
+  state_.previousFlags = record.flags;
+  ++state_.count;
+  return true;
+}
+
+auto SeriesDecoder::decodeTime(uint32_t& time) -> bool
+{
+  uint32_t ones = 0;
+  uint32_t bit  = 1;
+  while ((ones < RAW_TIME_PREFIX_BITS) and (bit != 0))
+  {
+    if (not reader_.read(1, bit))
+    {
+      return false;
+    }
+    ones += bit;
+  }
+
+  auto delta = state_.previousDelta;
+  if (ones == RAW_TIME_PREFIX_BITS)
+  {
+    uint32_t raw = 0;
+    if (not reader_.read(32, raw))
+    {
+      return false;
+    }
+    delta = static_cast<int32_t>(raw);
+  }
+  else if (ones > 0)
+  {
+    uint32_t zigzag = 0;
+    if (not reader_.read(TIME_BUCKETS.at(ones - 1).valueBits, zigzag))
+    {
+      return false;
+    }
+    delta = static_cast<int32_t>(state_.previousDelta + zigzagDecode(zigzag));
+  }
+
+  time                 = state_.previousTime + static_cast<uint32_t>(delta);
+  state_.previousTime  = time;
+  state_.previousDelta = delta;
+  return true;
+}
+
+auto SeriesDecoder::decodeValue(SeriesCodec::Channel& channel, uint16_t& value) -> bool
+{
+  uint32_t control = 0;
+  if (not reader_.read(1, control))
+  {
+    return false;
+  }
+  if (control == 0)
+  {
+    value = channel.previous;
+    return true;
+  }
+
+  if (not reader_.read(1, control))
+  {
+    return false;
+  }
+  if (control != 0)
+  {
+    uint32_t leading = 0;
+    uint32_t length  = 0;
+    if (not reader_.read(4, leading) or not reader_.read(4, length))
+    {
+      return false;
+    }
+    channel.leading = static_cast<uint8_t>(leading);
+    channel.length  = static_cast<uint8_t>(std::min(length + 1, VALUE_BITS - leading));
+  }
+
+  uint32_t meaningful = 0;
+  if (not reader_.read(channel.length, meaningful))
+  {
+    return false;
+  }
+  const auto shift = VALUE_BITS - channel.leading - channel.length;
+  value            = applyResidual(channel.previous, static_cast<uint16_t>(meaningful << shift));
+  channel.previous = value;
+  return true;
+}
@@ -0,0 +1,87 @@
+# Usage: cmake -DINPUT=<page.html> -DOUTPUT=<header.hpp> -DSYMBOL=<NAME> -P embed_page.cmake
+
+cmake_minimum_required(VERSION 3.19)
+
+foreach(var INPUT OUTPUT SYMBOL)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "embed_page.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+file(READ ${INPUT} content)
+
+while(TRUE)
+    string(FIND "${content}" "<!--" comment_start)
+    if(comment_start EQUAL -1)
+        break()
+    endif()
+    string(SUBSTRING "${content}" ${comment_start} -1 tail)
+    string(FIND "${tail}" "-->" comment_length)
+    if(comment_length EQUAL -1)
+        message(FATAL_ERROR "embed_page.cmake: unterminated comment in ${INPUT}")
+    endif()
+    string(SUBSTRING "${content}" 0 ${comment_start} head)
+    math(EXPR comment_end "${comment_length} + 3")
+    string(SUBSTRING "${tail}" ${comment_end} -1 tail)
+    set(content "${head}${tail}")
+endwhile()
+
+string(REGEX REPLACE "\r" "" content "${content}")
+string(REGEX REPLACE "\n[ \t]+" "\n" content "${content}")
+string(REGEX REPLACE "[ \t]+\n" "\n" content "${content}")
+string(REGEX REPLACE "\n\n+" "\n" content "${content}")
+string(STRIP "${content}" content)
+
+get_filename_component(output_dir ${OUTPUT} DIRECTORY)
+get_filename_component(page_name ${INPUT} NAME)
+set(work_dir ${output_dir}/.embed)
+file(MAKE_DIRECTORY ${work_dir})
+file(WRITE ${work_dir}/${page_name} "${content}")
+
+file(ARCHIVE_CREATE
+    OUTPUT ${work_dir}/${page_name}.gz
+    PATHS ${work_dir}/${page_name}
+    FORMAT raw
+    COMPRESSION GZip
+    COMPRESSION_LEVEL 9
+)
+
+string(SHA256 digest "${content}")
+string(SUBSTRING ${digest} 0 16 etag)
+
+# The gzip header stores the compression time in bytes 4-7 (MTIME); zero it so the same page always yields the same
+# array and builds stay reproducible.
+file(READ ${work_dir}/${page_name}.gz gzip_hex HEX)
+string(SUBSTRING ${gzip_hex} 0 8 gzip_head)
+string(SUBSTRING ${gzip_hex} 16 -1 gzip_rest)
+set(gzip_hex "${gzip_head}00000000${gzip_rest}")
+string(LENGTH ${gzip_hex} hex_length)
+math(EXPR byte_count "${hex_length} / 2")
+set(bytes "")
+set(offset 0)
+while(offset LESS hex_length)
+    string(SUBSTRING ${gzip_hex} ${offset} 32 row)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1, " row "${row}")
+    string(STRIP "${row}" row)
+    string(APPEND bytes "  ${row}\n")
+    math(EXPR offset "${offset} + 32")
+endwhile()
+string(LENGTH "${content}" raw_length)
+
+file(WRITE ${OUTPUT}.tmp
+"#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+inline constexpr std::array<uint8_t, ${byte_count}> ${SYMBOL}_GZIP = {
+${bytes}};
+inline constexpr std::string_view ${SYMBOL}_ETAG         = \"\\\"${etag}\\\"\";
+inline constexpr size_t           ${SYMBOL}_MINIFIED_SIZE = ${raw_length};
+")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
+
+message(STATUS "Embedded ${page_name}: ${raw_length} bytes minified, ${byte_count} bytes gzipped, ETag ${etag}")